@@ -733,6 +733,12 @@ extern my_bool radixsort_is_appliccable(uint n_items, size_t size_of_element);
 extern void my_string_ptr_sort(uchar *base,uint items,size_t size);
 extern void radixsort_for_str_ptr(uchar* base[], uint number_of_elements,
 				  size_t size_of_element,uchar *buffer[]);
+extern my_bool radixsort_msd_is_applicable(uint n_items,
+                                           size_t size_of_element);
+extern my_bool radixsort_msd_for_str_ptr(uchar* base[],
+                                         uint number_of_elements,
+                                         size_t size_of_element,
+                                         uchar *buffer[]);
 extern qsort_t my_qsort(void *base_ptr, size_t total_elems, size_t size,
                         qsort_cmp cmp);
 extern qsort_t my_qsort2(void *base_ptr, size_t total_elems, size_t size,
@@ -862,6 +868,18 @@ extern void *my_az_allocator(void *dummy, unsigned int items, unsigned int size)
 extern void my_az_free(void *dummy, void *address);
 extern int my_compress_buffer(uchar *dest, size_t *destLen,
                               const uchar *source, size_t sourceLen);
+typedef struct st_my_compress_stream MY_COMPRESS_STREAM;
+/* Room needed by my_compress_stream(), even if the data doesn't compress */
+#define MY_COMPRESS_STREAM_BOUND(len) ((len) + ((len) >> 10) + 64)
+#define MY_COMPRESS_STREAM_DEFAULT_LEVEL (-1)  /* Z_DEFAULT_COMPRESSION */
+extern MY_COMPRESS_STREAM *my_compress_stream_alloc(int level);
+extern void my_compress_stream_free(MY_COMPRESS_STREAM *stream);
+extern my_bool my_compress_stream(MY_COMPRESS_STREAM *stream,
+                                  const uchar *packet, size_t *len,
+                                  uchar *to, size_t *complen);
+extern my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream,
+                                    uchar *packet, size_t len,
+                                    size_t *complen);
 extern int packfrm(const uchar *, size_t, uchar **, size_t *);
 extern int unpackfrm(uchar **, size_t *, const uchar *);
 
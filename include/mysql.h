@@ -182,7 +182,8 @@ enum mysql_option
   /* MariaDB options */
   MYSQL_PROGRESS_CALLBACK=5999,
   MYSQL_OPT_NONBLOCK,
-  MYSQL_OPT_USE_THREAD_SPECIFIC_MEMORY
+  MYSQL_OPT_USE_THREAD_SPECIFIC_MEMORY,
+  MYSQL_OPT_PIPELINE
 };
 
 /**
@@ -595,6 +596,9 @@ unsigned int	STDCALL mysql_thread_safe(void);
 my_bool		STDCALL mysql_embedded(void);
 my_bool		STDCALL mariadb_connection(MYSQL *mysql);
 my_bool         STDCALL mysql_read_query_result(MYSQL *mysql);
+int             STDCALL mysql_pipeline_send_query(MYSQL *mysql, const char *q,
+                                                  unsigned long length);
+my_bool         STDCALL mysql_pipeline_read_result(MYSQL *mysql);
 int             STDCALL mysql_read_query_result_start(my_bool *ret,
                                                       MYSQL *mysql);
 int             STDCALL mysql_read_query_result_cont(my_bool *ret,
@@ -774,7 +778,15 @@ enum enum_stmt_attr_type
     Amount of rows to retrieve from server per one fetch if using cursors.
     Accepts unsigned long attribute in the range 1 - ulong_max
   */
-  STMT_ATTR_PREFETCH_ROWS
+  STMT_ATTR_PREFETCH_ROWS,
+  /*
+    Number of parameter sets sent by one mysql_stmt_execute(), default 1.
+    The buffers bound by mysql_stmt_bind_param() are then arrays: the
+    values of a parameter are buffer_length bytes apart (sizeof(MYSQL_TIME)
+    for the temporal types), and length and is_null, if given, are arrays
+    too. Accepts unsigned long attribute in the range 1 - ulong_max
+  */
+  STMT_ATTR_ARRAY_SIZE
 };
 
 MYSQL_STMT * STDCALL mysql_stmt_init(MYSQL *mysql);
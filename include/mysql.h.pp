@@ -31,7 +31,7 @@ typedef struct st_net {
   my_bool thread_specific_malloc;
   my_bool compress;
   my_bool unused3;
-  unsigned char *unused;
+  void *compress_stream;
   unsigned int last_errno;
   unsigned char error;
   my_bool unused4;
@@ -277,7 +277,8 @@ enum mysql_option
   MYSQL_OPT_CAN_HANDLE_EXPIRED_PASSWORDS,
   MYSQL_PROGRESS_CALLBACK=5999,
   MYSQL_OPT_NONBLOCK,
-  MYSQL_OPT_USE_THREAD_SPECIFIC_MEMORY
+  MYSQL_OPT_USE_THREAD_SPECIFIC_MEMORY,
+  MYSQL_OPT_PIPELINE
 };
 struct st_mysql_options_extention;
 struct st_mysql_options {
@@ -590,6 +591,9 @@ unsigned int mysql_thread_safe(void);
 my_bool mysql_embedded(void);
 my_bool mariadb_connection(MYSQL *mysql);
 my_bool mysql_read_query_result(MYSQL *mysql);
+int mysql_pipeline_send_query(MYSQL *mysql, const char *q,
+                                                  unsigned long length);
+my_bool mysql_pipeline_read_result(MYSQL *mysql);
 int mysql_read_query_result_start(my_bool *ret,
                                                       MYSQL *mysql);
 int mysql_read_query_result_cont(my_bool *ret,
@@ -659,7 +663,8 @@ enum enum_stmt_attr_type
 {
   STMT_ATTR_UPDATE_MAX_LENGTH,
   STMT_ATTR_CURSOR_TYPE,
-  STMT_ATTR_PREFETCH_ROWS
+  STMT_ATTR_PREFETCH_ROWS,
+  STMT_ATTR_ARRAY_SIZE
 };
 MYSQL_STMT * mysql_stmt_init(MYSQL *mysql);
 int mysql_stmt_prepare(MYSQL_STMT *stmt, const char *query,
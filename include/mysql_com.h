@@ -282,6 +282,41 @@ enum enum_server_command
                                                & ~CLIENT_COMPRESS) \
                                                & ~CLIENT_SSL_VERIFY_SERVER_CERT)
 
+/*
+  Extended capabilities.
+
+  All the 32 bits of the capability flags are in use, some of them with
+  another meaning by other servers and clients. These are sent in the
+  last 4 bytes of the reserved filler of the server handshake packet and
+  of the client handshake response, which the other servers and clients
+  leave zero. They are not used by MariaDB for anything else either.
+*/
+
+/*
+  A COM_STMT_EXECUTE may carry several parameter sets, its iteration count
+  is then greater than 1. See STMT_ATTR_ARRAY_SIZE.
+*/
+#define CLIENT_EXT_STMT_BULK (1UL << 16)
+/*
+  The client may send commands without waiting for the results of the
+  ones before, see mysql_pipeline_send_query(). The server then doesn't
+  flush a result while the next command is already waiting to be read.
+*/
+#define CLIENT_EXT_PIPELINE (1UL << 17)
+/* The compressed packets are one deflate stream, see my_compress_stream() */
+#define CLIENT_EXT_COMPRESS_STREAM (1UL << 18)
+
+#ifdef HAVE_COMPRESS
+#define CAN_CLIENT_EXT_COMPRESS CLIENT_EXT_COMPRESS_STREAM
+#else
+#define CAN_CLIENT_EXT_COMPRESS 0
+#endif
+
+/* The extended capabilities supported by the server */
+#define CLIENT_EXT_ALL_FLAGS (CLIENT_EXT_STMT_BULK | \
+                              CLIENT_EXT_PIPELINE | \
+                              CAN_CLIENT_EXT_COMPRESS)
+
 /**
   Is raised when a multi-statement transaction
   has been started, either explicitly, by means
@@ -394,9 +429,10 @@ typedef struct st_net {
   */
 #endif
   /*
-    Unused, please remove with the next incompatible ABI change.
+    State of the streaming compression (CLIENT_EXT_COMPRESS_STREAM),
+    a MY_COMPRESS_STREAM, or 0 when the packets are compressed one by one
   */
-  unsigned char *unused;
+  void *compress_stream;
   unsigned int last_errno;
   unsigned char error; 
   my_bool unused4; /* Please remove with the next incompatible ABI change. */
@@ -596,6 +632,8 @@ typedef struct st_udf_init
   /* Constants when using compression */
 #define NET_HEADER_SIZE 4		/* standard header size */
 #define COMP_HEADER_SIZE 3		/* compression header extra size */
+/* Longest packet that is sent in one piece, longer ones are split */
+#define MAX_PACKET_LENGTH (256L*256L*256L-1)
 
   /* Prototypes to password functions */
 
@@ -34,8 +34,23 @@ struct st_net_server
   before_header_callback_fn m_before_header;
   after_header_callback_fn m_after_header;
   void *m_user_data;
+  /*
+    Set while the result of a command is ended. net_flush() then keeps
+    the result in m_pending if the next command has already arrived, to
+    send it with the next write.
+  */
+  my_bool m_pipelined;
+  unsigned char *m_pending;
+  size_t m_pending_length, m_pending_size;
 };
 
 typedef struct st_net_server NET_SERVER;
 
+/* Sizing of the write buffer and packets built in it, see net_serv.cc */
+my_bool net_extend_write_buffer(struct st_net *net, size_t length);
+void net_shrink_buffer(struct st_net *net, size_t length);
+void net_write_in_place(struct st_net *net, size_t len);
+/* Send the results kept for pipelined commands, see net_serv.cc */
+my_bool net_flush_pending(struct st_net *net);
+
 #endif
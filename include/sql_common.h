@@ -44,6 +44,10 @@ struct st_mysql_options_extention {
   struct mysql_async_context *async_context;
   HASH connection_attributes;
   size_t connection_attributes_length;
+  /* CLIENT_EXT_* of the server, and the ones used by the connection */
+  unsigned long server_ext_capabilities, client_ext_flag;
+  /* Ask for CLIENT_EXT_PIPELINE, see MYSQL_OPT_PIPELINE */
+  my_bool pipeline;
 };
 
 typedef struct st_mysql_methods
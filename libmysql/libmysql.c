@@ -99,6 +99,7 @@ static my_bool org_my_init_done= 0;
 typedef struct st_mysql_stmt_extension
 {
   MEM_ROOT fields_mem_root;
+  ulong array_size;                     /* STMT_ATTR_ARRAY_SIZE */
 } MYSQL_STMT_EXT;
 
 
@@ -1530,6 +1531,7 @@ mysql_stmt_init(MYSQL *mysql)
   stmt->mysql= mysql;
   stmt->read_row_func= stmt_read_row_no_result_set;
   stmt->prefetch_rows= DEFAULT_PREFETCH_ROWS;
+  stmt->extension->array_size= 1;
   strmov(stmt->sqlstate, not_error_sqlstate);
   /* The rest of statement members was bzeroed inside malloc */
 
@@ -2017,6 +2019,7 @@ static void store_param_str(NET *net, MYSQL_BIND *param)
     store_param_null()
     net			MySQL NET connection
     param		MySQL bind param
+    null_pos		Offset of the null bits in the network packet
 
   DESCRIPTION
     A data package starts with a string of bits where we set a bit
@@ -2024,10 +2027,44 @@ static void store_param_str(NET *net, MYSQL_BIND *param)
     we don't have reserved bits for OK/error packet.
 */
 
-static void store_param_null(NET *net, MYSQL_BIND *param)
+static void store_param_null(NET *net, MYSQL_BIND *param, ulong null_pos)
 {
   uint pos= param->param_number;
-  net->buff[pos/8]|=  (uchar) (1 << (pos & 7));
+  net->buff[null_pos + pos/8]|=  (uchar) (1 << (pos & 7));
+}
+
+
+static my_bool int_is_null_true= 1;		/* Used for MYSQL_TYPE_NULL */
+static my_bool int_is_null_false= 0;
+
+
+/*
+  Point a copy of a parameter binding at the values of one row of the
+  arrays bound for STMT_ATTR_ARRAY_SIZE.
+*/
+
+static void bind_param_row(MYSQL_BIND *to, MYSQL_BIND *param, ulong row)
+{
+  size_t stride;
+
+  switch (param->buffer_type) {
+  case MYSQL_TYPE_TIME:
+  case MYSQL_TYPE_DATE:
+  case MYSQL_TYPE_DATETIME:
+  case MYSQL_TYPE_TIMESTAMP:
+    stride= sizeof(MYSQL_TIME);
+    break;
+  default:
+    stride= param->buffer_length;
+  }
+  *to= *param;
+  to->buffer= (char*) param->buffer + row * stride;
+  /* length and is_null are arrays only if the user gave them */
+  if (param->length != &param->buffer_length)
+    to->length= param->length + row;
+  if (param->is_null != &int_is_null_false &&
+      param->is_null != &int_is_null_true)
+    to->is_null= param->is_null + row;
 }
 
 
@@ -2037,7 +2074,8 @@ static void store_param_null(NET *net, MYSQL_BIND *param)
   of store_param_xxxx functions.
 */
 
-static my_bool store_param(MYSQL_STMT *stmt, MYSQL_BIND *param)
+static my_bool store_param(MYSQL_STMT *stmt, MYSQL_BIND *param,
+                           ulong null_pos)
 {
   NET *net= &stmt->mysql->net;
   DBUG_ENTER("store_param");
@@ -2047,7 +2085,7 @@ static my_bool store_param(MYSQL_STMT *stmt, MYSQL_BIND *param)
                       *param->length, *param->is_null));
 
   if (*param->is_null)
-    store_param_null(net, param);
+    store_param_null(net, param, null_pos);
   else
   {
     /*
@@ -2082,7 +2120,8 @@ static my_bool execute(MYSQL_STMT *stmt, char *packet, ulong length)
 
   int4store(buff, stmt->stmt_id);		/* Send stmt id to server */
   buff[4]= (char) stmt->flags;
-  int4store(buff+5, 1);                         /* iteration count */
+  int4store(buff+5, stmt->param_count ?        /* iteration count */
+                    stmt->extension->array_size : 1);
 
   res= MY_TEST(cli_advanced_command(mysql, COM_STMT_EXECUTE, buff, sizeof(buff),
                                     (uchar*) packet, length, 1, stmt) ||
@@ -2116,7 +2155,7 @@ int cli_stmt_execute(MYSQL_STMT *stmt)
     NET        *net= &mysql->net;
     MYSQL_BIND *param, *param_end;
     char       *param_data;
-    ulong length;
+    ulong length, row;
     uint null_count;
     my_bool    result;
 
@@ -2173,9 +2212,31 @@ int cli_stmt_execute(MYSQL_STMT *stmt)
       /* check if mysql_stmt_send_long_data() was used */
       if (param->long_data_used)
 	param->long_data_used= 0;	/* Clear for next execute call */
-      else if (store_param(stmt, param))
+      else if (store_param(stmt, param, 0))
 	DBUG_RETURN(1);
     }
+    /*
+      The other parameter sets of an array binding follow, each with
+      its own null bits but without types.
+    */
+    for (row= 1; row < stmt->extension->array_size; row++)
+    {
+      ulong null_pos= (ulong) (net->write_pos - net->buff);
+      if (my_realloc_str(net, null_count))
+      {
+        set_stmt_errmsg(stmt, net);
+        DBUG_RETURN(1);
+      }
+      bzero((char*) net->write_pos, null_count);
+      net->write_pos+= null_count;
+      for (param= stmt->params; param < param_end; param++)
+      {
+        MYSQL_BIND row_param;
+        bind_param_row(&row_param, param, row);
+        if (store_param(stmt, &row_param, null_pos))
+          DBUG_RETURN(1);
+      }
+    }
     length= (ulong) (net->write_pos - net->buff);
     /* TODO: Look into avoding the following memdup */
     if (!(param_data= my_memdup(net->buff, length, MYF(0))))
@@ -2398,6 +2459,24 @@ my_bool STDCALL mysql_stmt_attr_set(MYSQL_STMT *stmt,
     stmt->prefetch_rows= prefetch_rows;
     break;
   }
+  case STMT_ATTR_ARRAY_SIZE:
+  {
+    ulong array_size= value ? *(ulong*) value : 1UL;
+    if (array_size == 0)
+      return TRUE;
+#ifdef EMBEDDED_LIBRARY
+    if (array_size > 1)
+      goto err_not_implemented;
+#else
+    if (array_size > 1 &&
+        (!stmt->mysql || !stmt->mysql->options.extension ||
+         !(stmt->mysql->options.extension->client_ext_flag &
+           CLIENT_EXT_STMT_BULK)))
+      goto err_not_implemented;
+#endif
+    stmt->extension->array_size= array_size;
+    break;
+  }
   default:
     goto err_not_implemented;
   }
@@ -2422,6 +2501,9 @@ my_bool STDCALL mysql_stmt_attr_get(MYSQL_STMT *stmt,
   case STMT_ATTR_PREFETCH_ROWS:
     *(ulong*) value= stmt->prefetch_rows;
     break;
+  case STMT_ATTR_ARRAY_SIZE:
+    *(ulong*) value= stmt->extension->array_size;
+    break;
   default:
     return TRUE;
   }
@@ -2628,9 +2710,6 @@ my_ulonglong STDCALL mysql_stmt_insert_id(MYSQL_STMT *stmt)
 }
 
 
-static my_bool int_is_null_true= 1;		/* Used for MYSQL_TYPE_NULL */
-static my_bool int_is_null_false= 0;
-
 
 /*
   Set up input data buffers for a statement.
@@ -58,3 +58,140 @@ void radixsort_for_str_ptr(uchar **base, uint number_of_elements, size_t size_of
   next:;
   }
 }
+
+
+/*
+  Most significant digit first radixsort for pointers to fixed length
+  strings.
+
+  The pointers are distributed into 256 buckets on the first byte of the
+  strings, then each bucket is distributed on the next byte and so on.
+  A byte position where all strings of a bucket are equal is skipped
+  without moving anything, and buckets smaller than RADIX_MSD_MIN_BUCKET
+  are finished with an insertion sort, so strings are usually only looked
+  at up to the first few bytes that tell them apart. Unlike the LSD sort
+  above this works well also for many and longer strings.
+
+  Longer strings are mostly padded strings that often differ only late or
+  not at all, where the counting passes over the equal bytes cost more
+  than the memcmp() calls of a quicksort, so they are not radix sorted.
+
+  Needs an extra buffer of number_of_elements pointers. Returns 1 if the
+  work stack can't be allocated, in which case nothing is sorted.
+*/
+
+#define RADIX_MSD_MIN_BUCKET 32
+#define RADIX_MSD_MAX_LENGTH 64
+
+my_bool radixsort_msd_is_applicable(uint n_items, size_t size_of_element)
+{
+  return size_of_element <= RADIX_MSD_MAX_LENGTH && n_items >= 1000;
+}
+
+static void radix_insertion_sort(uchar **base, uint number_of_elements,
+                                 size_t offset, size_t size_of_element)
+{
+  uchar **end= base + number_of_elements, **ptr, **pos, *tmp;
+  for (ptr= base + 1; ptr < end; ptr++)
+  {
+    tmp= *ptr;
+    for (pos= ptr;
+         pos > base && memcmp(pos[-1] + offset, tmp + offset,
+                              size_of_element - offset) > 0;
+         pos--)
+      *pos= pos[-1];
+    *pos= tmp;
+  }
+}
+
+my_bool radixsort_msd_for_str_ptr(uchar **base, uint number_of_elements,
+                                  size_t size_of_element, uchar **buffer)
+{
+  struct st_radix_range
+  {
+    uchar **base;
+    uint elements;
+    size_t offset;
+  } *stack, *top;
+  uint32 count[256];
+
+  /*
+    Only buckets of at least RADIX_MSD_MIN_BUCKET elements are pushed and
+    the pushed buckets don't overlap, which limits the stack depth.
+  */
+  if (!(stack= (struct st_radix_range*)
+        my_malloc((number_of_elements / RADIX_MSD_MIN_BUCKET + 1) *
+                  sizeof(*stack), MYF(0))))
+    return 1;
+
+  top= stack;
+  top->base= base;
+  top->elements= number_of_elements;
+  top->offset= 0;
+  top++;
+
+  while (top != stack)
+  {
+    uchar **range, **end, **ptr, **to;
+    uint elements, i, start;
+    size_t offset;
+
+    top--;
+    range= top->base;
+    elements= top->elements;
+    offset= top->offset;
+    end= range + elements;
+
+    if (elements < RADIX_MSD_MIN_BUCKET)
+    {
+      radix_insertion_sort(range, elements, offset, size_of_element);
+      continue;
+    }
+
+    /* Find the first byte position where the strings differ */
+    for (; offset < size_of_element; offset++)
+    {
+      bzero((uchar*) count, sizeof(count));
+      for (ptr= range; ptr < end; ptr++)
+        count[ptr[0][offset]]++;
+      if (count[range[0][offset]] != elements)
+        break;
+    }
+    if (offset == size_of_element)
+      continue;                                 /* All strings are equal */
+
+    /* Distribute the pointers into the buckets and copy them back */
+    to= buffer + (range - base);
+    for (i= 0, start= 0; i < 256; i++)
+    {
+      uint bucket_size= count[i];
+      count[i]= start;
+      start+= bucket_size;
+    }
+    for (ptr= range; ptr < end; ptr++)
+      to[count[ptr[0][offset]]++]= *ptr;
+    memcpy(range, to, elements * sizeof(uchar*));
+
+    /* count[i] is now the end of bucket i */
+    if (++offset == size_of_element)
+      continue;
+    for (i= 0, start= 0; i < 256; start= count[i++])
+    {
+      uint bucket_size= count[i] - start;
+      if (bucket_size < 2)
+        continue;
+      if (bucket_size < RADIX_MSD_MIN_BUCKET)
+        radix_insertion_sort(range + start, bucket_size, offset,
+                             size_of_element);
+      else
+      {
+        top->base= range + start;
+        top->elements= bucket_size;
+        top->offset= offset;
+        top++;
+      }
+    }
+  }
+  my_free(stack);
+  return 0;
+}
@@ -203,6 +203,211 @@ my_bool my_uncompress(uchar *packet, size_t len, size_t *complen)
   DBUG_RETURN(0);
 }
 
+
+/*
+  Streaming compression of the packets of a connection.
+
+  With CLIENT_EXT_COMPRESS_STREAM the compressed packets that go in one
+  direction of a connection are one raw deflate stream. Each packet is
+  flushed with Z_SYNC_FLUSH, so it can be uncompressed as soon as it
+  arrives, but it can refer to the data of the packets before it, and
+  zlib is not set up again for every packet. The empty stored block
+  that ends a flush (00 00 ff ff) is not sent but is added back when
+  the packet is uncompressed.
+
+  Packets shorter than MIN_COMPRESS_LENGTH are sent as they are and
+  are not added to the stream.
+*/
+
+struct st_my_compress_stream
+{
+  z_stream deflate_strm;
+  z_stream inflate_strm;
+  uchar *buff;                          /* Used by my_uncompress_stream() */
+  size_t buff_length;
+  int level;
+  my_bool deflate_started, inflate_started;
+};
+
+static const uchar sync_flush_marker[4]= { 0, 0, 0xff, 0xff };
+
+
+/*
+  Allocate the compression state of a connection
+
+   SYNOPSIS
+     my_compress_stream_alloc()
+     level	zlib compression level of the packets that are sent
+
+   RETURN
+     The state, or 0 if out of memory
+*/
+
+MY_COMPRESS_STREAM *my_compress_stream_alloc(int level)
+{
+  MY_COMPRESS_STREAM *stream;
+  if ((stream= (MY_COMPRESS_STREAM *) my_malloc(sizeof(*stream),
+                                                MYF(MY_WME | MY_ZEROFILL))))
+    stream->level= level;
+  return stream;
+}
+
+
+void my_compress_stream_free(MY_COMPRESS_STREAM *stream)
+{
+  if (!stream)
+    return;
+  if (stream->deflate_started)
+    deflateEnd(&stream->deflate_strm);
+  if (stream->inflate_started)
+    inflateEnd(&stream->inflate_strm);
+  my_free(stream->buff);
+  my_free(stream);
+}
+
+
+/*
+  Compress a packet into the stream
+
+   SYNOPSIS
+     my_compress_stream()
+     stream	Compression state of the connection
+     packet	Data to compress
+     len	in: Length of data to compress at 'packet'
+		out: Length of the data at 'to'
+     to		Buffer of at least MY_COMPRESS_STREAM_BOUND(*len) bytes
+     complen	out: Length of the original data, 0 if it was not
+		compressed but copied to 'to' as it is
+
+   RETURN
+     1   error, the stream can't be used any more
+     0   ok
+*/
+
+my_bool my_compress_stream(MY_COMPRESS_STREAM *stream, const uchar *packet,
+                           size_t *len, uchar *to, size_t *complen)
+{
+  z_stream *strm= &stream->deflate_strm;
+  size_t out_length= MY_COMPRESS_STREAM_BOUND(*len);
+  DBUG_ENTER("my_compress_stream");
+
+  if (*len < MIN_COMPRESS_LENGTH)
+  {
+    DBUG_PRINT("note",("Packet too short: Not compressed"));
+    goto not_compressed;
+  }
+  if (!stream->deflate_started)
+  {
+    strm->zalloc= (alloc_func) my_az_allocator;
+    strm->zfree= (free_func) my_az_free;
+    strm->opaque= (voidpf) 0;
+    if (deflateInit2(strm, stream->level, Z_DEFLATED, -MAX_WBITS, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+      goto not_compressed;                      /* Try again later */
+    stream->deflate_started= 1;
+  }
+
+  strm->next_in= (Bytef*) packet;
+  strm->avail_in= (uInt) *len;
+  strm->next_out= (Bytef*) to;
+  strm->avail_out= (uInt) out_length;
+  if (deflate(strm, Z_SYNC_FLUSH) != Z_OK || strm->avail_in ||
+      !strm->avail_out)
+  {
+    DBUG_PRINT("error",("Can't compress packet"));
+    DBUG_RETURN(1);
+  }
+  *complen= *len;
+  *len= out_length - strm->avail_out - sizeof(sync_flush_marker);
+  DBUG_ASSERT(!memcmp(to + *len, sync_flush_marker,
+                      sizeof(sync_flush_marker)));
+  DBUG_RETURN(0);
+
+not_compressed:
+  memcpy(to, packet, *len);
+  *complen= 0;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Uncompress a packet from the stream
+
+   SYNOPSIS
+     my_uncompress_stream()
+     stream	Compression state of the connection
+     packet	Compressed data. This is is replaced with the orignal data.
+     len	Length of compressed data
+     complen	Length of the original data, 0 if it was not compressed.
+		The packet buffer must be big enough for it.
+
+   RETURN
+     1   error
+     0   ok
+*/
+
+my_bool my_uncompress_stream(MY_COMPRESS_STREAM *stream, uchar *packet,
+                             size_t len, size_t *complen)
+{
+  z_stream *strm= &stream->inflate_strm;
+  int error;
+  DBUG_ENTER("my_uncompress_stream");
+
+  if (!*complen)
+  {
+    *complen= len;
+    DBUG_RETURN(0);
+  }
+  if (!stream->inflate_started)
+  {
+    strm->zalloc= (alloc_func) my_az_allocator;
+    strm->zfree= (free_func) my_az_free;
+    strm->opaque= (voidpf) 0;
+    strm->next_in= Z_NULL;
+    strm->avail_in= 0;
+    if (inflateInit2(strm, -MAX_WBITS) != Z_OK)
+      DBUG_RETURN(1);
+    stream->inflate_started= 1;
+  }
+  /* One byte more, to see that there is no more data than promised */
+  if (stream->buff_length <= *complen)
+  {
+    my_free(stream->buff);
+    stream->buff_length= *complen + 1;
+    if (!(stream->buff= (uchar *) my_malloc(stream->buff_length, MYF(MY_WME))))
+    {
+      stream->buff_length= 0;
+      DBUG_RETURN(1);
+    }
+  }
+
+  strm->next_in= (Bytef*) packet;
+  strm->avail_in= (uInt) len;
+  strm->next_out= (Bytef*) stream->buff;
+  strm->avail_out= (uInt) (*complen + 1);
+  error= inflate(strm, Z_SYNC_FLUSH);
+  if ((error == Z_OK || error == Z_BUF_ERROR) && !strm->avail_in)
+  {
+    strm->next_in= (Bytef*) sync_flush_marker;
+    strm->avail_in= sizeof(sync_flush_marker);
+    error= inflate(strm, Z_SYNC_FLUSH);
+  }
+  if (error != Z_OK || strm->avail_in || strm->avail_out != 1)
+  {						/* Probably wrong packet */
+    DBUG_PRINT("error",("Can't uncompress packet, error: %d",error));
+    DBUG_RETURN(1);
+  }
+  memcpy(packet, stream->buff, *complen);
+  /* Don't keep the memory of big packets */
+  if (stream->buff_length > 65536)
+  {
+    my_free(stream->buff);
+    stream->buff= 0;
+    stream->buff_length= 0;
+  }
+  DBUG_RETURN(0);
+}
+
 /*
   Internal representation of the frm blob is:
 
@@ -0,0 +1,12 @@
+package My::Suite::Thread_pool_info;
+
+@ISA = qw(My::Suite);
+
+return "No thread_pool_info plugin" unless $ENV{THREAD_POOL_INFO_SO};
+
+return "Not run for embedded server" if $::opt_embedded_server;
+
+sub is_default { 1 }
+
+bless { };
+
@@ -0,0 +1,284 @@
+/* Copyright (C) 2014 Monty Program Ab
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  INFORMATION_SCHEMA tables for the Unix thread pool.
+
+  THREAD_POOL_GROUPS  - current state of each thread group
+  THREAD_POOL_QUEUES  - queue wait time histograms, per group and priority
+  THREAD_POOL_STATS   - event counters of each thread group
+
+  The tables are empty unless thread_handling=pool-of-threads.
+*/
+
+#ifndef MYSQL_SERVER
+#define MYSQL_SERVER
+#endif
+
+#include <sql_class.h>          // THD
+#include <sql_parse.h>          // check_global_access
+#include <sql_acl.h>            // PROCESS_ACL
+#include <table.h>              // ST_SCHEMA_TABLE
+#include <threadpool.h>
+#include <mysql/plugin.h>
+
+bool schema_table_store_record(THD *thd, TABLE *table);
+
+
+/* THREAD_POOL_GROUPS */
+static ST_FIELD_INFO groups_fields_info[]=
+{
+  {"GROUP_ID", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"CONNECTIONS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"THREADS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"ACTIVE_THREADS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"STANDBY_THREADS", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"QUEUE_LENGTH", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"HIGH_PRIO_QUEUE_LENGTH", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"HAS_LISTENER", 1, MYSQL_TYPE_TINY, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"IS_STALLED", 1, MYSQL_TYPE_TINY, 0, MY_I_S_UNSIGNED, 0, 0},
+  {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, 0}
+};
+
+static int groups_fill_table(THD *thd, TABLE_LIST *tables, COND *cond)
+{
+  TABLE *table= tables->table;
+
+  if (check_global_access(thd, PROCESS_ACL, true))
+    return 0;
+
+  for (uint i= 0; i < tp_get_group_count(); i++)
+  {
+    TP_GROUP_STATS stats;
+    if (tp_get_group_stats(i, &stats))
+      break;
+
+    table->field[0]->store(i, true);
+    table->field[1]->store(stats.connections, true);
+    table->field[2]->store(stats.threads, true);
+    table->field[3]->store(stats.active_threads, true);
+    table->field[4]->store(stats.standby_threads, true);
+    table->field[5]->store(stats.queue_length, true);
+    table->field[6]->store(stats.high_prio_queue_length, true);
+    table->field[7]->store(stats.has_listener, true);
+    table->field[8]->store(stats.is_stalled, true);
+
+    if (schema_table_store_record(thd, table))
+      return 1;
+  }
+  return 0;
+}
+
+
+/* THREAD_POOL_QUEUES */
+static ST_FIELD_INFO queues_fields_info[]=
+{
+  {"GROUP_ID", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"PRIORITY", 6, MYSQL_TYPE_STRING, 0, 0, 0, 0},
+  {"WAIT_TIME_LIMIT", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED | MY_I_S_MAYBE_NULL, 0, 0},
+  {"COUNT", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, 0}
+};
+
+static int queues_fill_table(THD *thd, TABLE_LIST *tables, COND *cond)
+{
+  static const LEX_STRING prio_name[2]=
+  {
+    { C_STRING_WITH_LEN("NORMAL") },
+    { C_STRING_WITH_LEN("HIGH") }
+  };
+  TABLE *table= tables->table;
+  CHARSET_INFO *scs= system_charset_info;
+
+  if (check_global_access(thd, PROCESS_ACL, true))
+    return 0;
+
+  for (uint i= 0; i < tp_get_group_count(); i++)
+  {
+    TP_GROUP_STATS stats;
+    if (tp_get_group_stats(i, &stats))
+      break;
+
+    for (int prio= 0; prio < 2; prio++)
+    {
+      ulonglong limit= 10;
+      for (uint bucket= 0; bucket < TP_QUEUE_WAIT_BUCKETS; bucket++)
+      {
+        table->field[0]->store(i, true);
+        table->field[1]->store(prio_name[prio].str, prio_name[prio].length,
+                               scs);
+        /* The last bucket has no upper limit. */
+        if (bucket < TP_QUEUE_WAIT_BUCKETS - 1)
+        {
+          table->field[2]->set_notnull();
+          table->field[2]->store(limit, true);
+        }
+        else
+          table->field[2]->set_null();
+        table->field[3]->store(stats.queue_wait[prio][bucket], true);
+        limit*= 10;
+
+        if (schema_table_store_record(thd, table))
+          return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+
+/* THREAD_POOL_STATS */
+static ST_FIELD_INFO stats_fields_info[]=
+{
+  {"GROUP_ID", 6, MYSQL_TYPE_LONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"THREAD_CREATIONS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"THREAD_CREATIONS_DUE_TO_STALL", MY_INT64_NUM_DECIMAL_DIGITS,
+   MYSQL_TYPE_LONGLONG, 0, MY_I_S_UNSIGNED, 0, 0},
+  {"WAKES", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"WAKES_DUE_TO_STALL", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"STALLS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"LISTENER_WAKEUPS", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"POLLS_BY_WORKER", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"DEQUEUES_BY_LISTENER", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG,
+   0, MY_I_S_UNSIGNED, 0, 0},
+  {"DEQUEUES_BY_WORKER", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"EVENTS_STOLEN", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {"HIGH_PRIO_DEQUEUES", MY_INT64_NUM_DECIMAL_DIGITS, MYSQL_TYPE_LONGLONG, 0,
+   MY_I_S_UNSIGNED, 0, 0},
+  {0, 0, MYSQL_TYPE_STRING, 0, 0, 0, 0}
+};
+
+static int stats_fill_table(THD *thd, TABLE_LIST *tables, COND *cond)
+{
+  TABLE *table= tables->table;
+
+  if (check_global_access(thd, PROCESS_ACL, true))
+    return 0;
+
+  for (uint i= 0; i < tp_get_group_count(); i++)
+  {
+    TP_GROUP_STATS stats;
+    if (tp_get_group_stats(i, &stats))
+      break;
+
+    table->field[0]->store(i, true);
+    table->field[1]->store(stats.thread_creations, true);
+    table->field[2]->store(stats.thread_creations_due_to_stall, true);
+    table->field[3]->store(stats.wakes, true);
+    table->field[4]->store(stats.wakes_due_to_stall, true);
+    table->field[5]->store(stats.stalls, true);
+    table->field[6]->store(stats.listener_wakeups, true);
+    table->field[7]->store(stats.polls_by_worker, true);
+    table->field[8]->store(stats.dequeues_by_listener, true);
+    table->field[9]->store(stats.dequeues_by_worker, true);
+    table->field[10]->store(stats.events_stolen, true);
+    table->field[11]->store(stats.high_prio_dequeues, true);
+
+    if (schema_table_store_record(thd, table))
+      return 1;
+  }
+  return 0;
+}
+
+
+static int groups_init(void *p)
+{
+  ST_SCHEMA_TABLE *schema= (ST_SCHEMA_TABLE *)p;
+  schema->fields_info= groups_fields_info;
+  schema->fill_table= groups_fill_table;
+  return 0;
+}
+
+static int queues_init(void *p)
+{
+  ST_SCHEMA_TABLE *schema= (ST_SCHEMA_TABLE *)p;
+  schema->fields_info= queues_fields_info;
+  schema->fill_table= queues_fill_table;
+  return 0;
+}
+
+static int stats_init(void *p)
+{
+  ST_SCHEMA_TABLE *schema= (ST_SCHEMA_TABLE *)p;
+  schema->fields_info= stats_fields_info;
+  schema->fill_table= stats_fill_table;
+  return 0;
+}
+
+
+static struct st_mysql_information_schema thread_pool_info_plugin=
+{ MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
+
+/*
+  Plugin library descriptor
+*/
+
+maria_declare_plugin(thread_pool_info)
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &thread_pool_info_plugin,
+  "THREAD_POOL_GROUPS",
+  "Monty Program Ab",
+  "Thread pool groups",
+  PLUGIN_LICENSE_GPL,
+  groups_init,
+  0,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_EXPERIMENTAL
+},
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &thread_pool_info_plugin,
+  "THREAD_POOL_QUEUES",
+  "Monty Program Ab",
+  "Thread pool queue wait times",
+  PLUGIN_LICENSE_GPL,
+  queues_init,
+  0,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_EXPERIMENTAL
+},
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &thread_pool_info_plugin,
+  "THREAD_POOL_STATS",
+  "Monty Program Ab",
+  "Thread pool event counters",
+  PLUGIN_LICENSE_GPL,
+  stats_init,
+  0,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_EXPERIMENTAL
+}
+maria_declare_plugin_end;
@@ -2617,6 +2617,7 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
   NET *net= &mysql->net;
   char *buff, *end;
   size_t buff_size;
+  ulong ext_flag;
   size_t connect_attrs_len=
     (mysql->server_capabilities & CLIENT_CONNECT_ATTRS &&
      mysql->options.extension) ?
@@ -2636,6 +2637,17 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
 
   if (mysql->client_flag & CLIENT_MULTI_STATEMENTS)
     mysql->client_flag|= CLIENT_MULTI_RESULTS;
+  /* This library can send the parameter arrays of STMT_ATTR_ARRAY_SIZE */
+  ext_flag= CLIENT_EXT_STMT_BULK;
+  /*
+    The server checks for the next command after every result of a
+    pipelining connection, so only ask for it when the application will
+    pipeline its queries.
+  */
+  if (mysql->options.extension->pipeline)
+    ext_flag|= CLIENT_EXT_PIPELINE;
+  if (mysql->client_flag & CLIENT_COMPRESS)
+    ext_flag|= CLIENT_EXT_COMPRESS_STREAM;
 
 #if defined(HAVE_OPENSSL) && !defined(EMBEDDED_LIBRARY)
   if (mysql->options.ssl_key || mysql->options.ssl_cert ||
@@ -2653,12 +2665,16 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
 
   /* Remove options that server doesn't support */
   mysql->client_flag= mysql->client_flag &
-                       (~(CLIENT_COMPRESS | CLIENT_SSL | CLIENT_PROTOCOL_41) 
+                       (~(CLIENT_COMPRESS | CLIENT_SSL | CLIENT_PROTOCOL_41)
                        | mysql->server_capabilities);
+  ext_flag&= mysql->options.extension->server_ext_capabilities;
 
 #ifndef HAVE_COMPRESS
   mysql->client_flag&= ~CLIENT_COMPRESS;
+  ext_flag&= ~CLIENT_EXT_COMPRESS_STREAM;
 #endif
+  if (!(mysql->client_flag & CLIENT_COMPRESS))
+    ext_flag&= ~CLIENT_EXT_COMPRESS_STREAM;
 
   if (mysql->client_flag & CLIENT_PROTOCOL_41)
   {
@@ -2667,6 +2683,8 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
     int4store(buff+4, net->max_packet_size);
     buff[8]= (char) mysql->charset->number;
     bzero(buff+9, 32-9);
+    /* The extended capabilities, in the last 4 bytes of the filler */
+    int4store(buff+28, ext_flag);
     end= buff+32;
   }
   else
@@ -2674,7 +2692,9 @@ static int send_client_reply_packet(MCPVIO_EXT *mpvio,
     int2store(buff, mysql->client_flag);
     int3store(buff+2, net->max_packet_size);
     end= buff+5;
+    ext_flag= 0;
   }
+  mysql->options.extension->client_ext_flag= ext_flag;
 #ifdef HAVE_OPENSSL
   if (mysql->client_flag & CLIENT_SSL)
   {
@@ -3598,6 +3618,14 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
   scramble_plugin= old_password_plugin_name;
   end+= scramble_data_len;
 
+  ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+  if (!mysql->options.extension)
+  {
+    set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+    goto error;
+  }
+  mysql->options.extension->server_ext_capabilities= 0;
+
   if (pkt_end >= end + 1)
     mysql->server_capabilities=uint2korr(end);
   if (pkt_end >= end + 18)
@@ -3607,6 +3635,7 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
     mysql->server_status=uint2korr(end+3);
     mysql->server_capabilities|= uint2korr(end+5) << 16;
     pkt_scramble_len= end[7];
+    mysql->options.extension->server_ext_capabilities= uint4korr(end+14);
     if (pkt_scramble_len < 0)
     {
       set_mysql_error(mysql, CR_MALFORMED_PACKET,
@@ -3700,7 +3729,19 @@ CLI_MYSQL_REAL_CONNECT(MYSQL *mysql,const char *host, const char *user,
   */
 
   if (mysql->client_flag & CLIENT_COMPRESS)      /* We will use compression */
+  {
     net->compress=1;
+#ifdef HAVE_COMPRESS
+    if ((mysql->options.extension->client_ext_flag &
+         CLIENT_EXT_COMPRESS_STREAM) &&
+        !(net->compress_stream=
+          my_compress_stream_alloc(MY_COMPRESS_STREAM_DEFAULT_LEVEL)))
+    {
+      set_mysql_error(mysql, CR_OUT_OF_MEMORY, unknown_sqlstate);
+      goto error;
+    }
+#endif
+  }
 
   if (db && !mysql->db && mysql_select_db(mysql, db))
   {
@@ -4182,6 +4223,105 @@ mysql_send_query(MYSQL* mysql, const char* query, ulong length)
   DBUG_RETURN(simple_command(mysql, COM_QUERY, (uchar*) query, length, 1));
 }
 
+
+/*
+  Send a query without waiting for the results of the queries sent
+  before it (pipelined queries).
+
+  The server executes the queries one at a time, in the order they were
+  sent, and each query gets its own result: an error in one of them
+  doesn't stop the ones after it. The results are read in the same
+  order with mysql_pipeline_read_result(), followed by
+  mysql_store_result() or mysql_use_result() and mysql_next_result() as
+  for a query sent with mysql_send_query(). No other command may be
+  sent until all results are read.
+
+  The client should read the results before it has sent more than fits
+  in the socket buffers, as the server doesn't read more commands while
+  it is blocked sending results.
+
+  If the connection was made with the MYSQL_OPT_PIPELINE option, the
+  server sends the results of the queries that are already waiting to
+  be executed together.
+*/
+
+int STDCALL
+mysql_pipeline_send_query(MYSQL *mysql, const char *query, ulong length)
+{
+  NET *net= &mysql->net;
+  DBUG_ENTER("mysql_pipeline_send_query");
+  DBUG_PRINT("query",("Query = '%-.4096s'",query));
+
+#ifdef EMBEDDED_LIBRARY
+  set_mysql_error(mysql, CR_NOT_IMPLEMENTED, unknown_sqlstate);
+  DBUG_RETURN(1);
+#else
+  if (!net->vio)
+  {
+    set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  if (mysql->status != MYSQL_STATUS_READY)
+  {
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  /*
+    The result must start with packet number 1, see
+    mysql_pipeline_read_result(), so the query must fit in one packet
+  */
+  if (length + 1 >= MAX_PACKET_LENGTH)
+  {
+    set_mysql_error(mysql, CR_NET_PACKET_TOO_LARGE, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  net_clear_error(net);
+  /* Unlike net_clear(), this keeps the results that are not read yet */
+  net->pkt_nr= net->compress_pkt_nr= 0;
+  if (net_write_command(net, (uchar) COM_QUERY, (uchar*) 0, 0,
+                        (uchar*) query, length))
+  {
+    DBUG_PRINT("error",("Can't send command to server. Error: %d",
+			socket_errno));
+    if (net->last_errno == ER_NET_PACKET_TOO_LARGE)
+      set_mysql_error(mysql, CR_NET_PACKET_TOO_LARGE, unknown_sqlstate);
+    else
+    {
+      end_server(mysql);
+      set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+    }
+    DBUG_RETURN(1);
+  }
+  DBUG_RETURN(0);
+#endif
+}
+
+
+/*
+  Read the result of the oldest query sent with
+  mysql_pipeline_send_query() that is not read yet
+*/
+
+my_bool STDCALL mysql_pipeline_read_result(MYSQL *mysql)
+{
+  NET *net= &mysql->net;
+  DBUG_ENTER("mysql_pipeline_read_result");
+
+  if (mysql->status != MYSQL_STATUS_READY ||
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS)
+  {
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    DBUG_RETURN(1);
+  }
+  net_clear_error(net);
+  mysql->info= 0;
+  mysql->affected_rows= ~(my_ulonglong) 0;
+  /* The packets of the result follow the one of the query */
+  net->pkt_nr= net->compress_pkt_nr= 1;
+  DBUG_RETURN((*mysql->methods->read_query_result)(mysql));
+}
+
+
 int STDCALL
 mysql_real_query(MYSQL *mysql, const char *query, ulong length)
 {
@@ -4447,6 +4587,11 @@ mysql_options(MYSQL *mysql,enum mysql_option option, const void *arg)
   case MYSQL_OPT_USE_THREAD_SPECIFIC_MEMORY:
     mysql->options.use_thread_specific_memory= *(my_bool *) arg;
     break;
+  case MYSQL_OPT_PIPELINE:
+    ENSURE_EXTENSIONS_PRESENT(&mysql->options);
+    if (mysql->options.extension)
+      mysql->options.extension->pipeline= *(my_bool *) arg;
+    break;
   case MYSQL_OPT_SSL_VERIFY_SERVER_CERT:
     if (*(my_bool*) arg)
       mysql->options.client_flag|= CLIENT_SSL_VERIFY_SERVER_CERT;
@@ -156,6 +156,7 @@ deinit_event_thread(THD *thd)
   thd->proc_info= "Clearing";
   DBUG_PRINT("exit", ("Event thread finishing"));
 
+  thd->add_status_to_global();
   delete_running_thd(thd);
 }
 
@@ -68,6 +68,8 @@ static uint sortlength(THD *thd, SORT_FIELD *sortorder, uint s_length,
 static SORT_ADDON_FIELD *get_addon_fields(ulong max_length_for_sort_data,
                                           Field **ptabfield,
                                           uint sortlength, uint *plength);
+static void unpack_packed_addon_fields(struct st_sort_addon_field *addon_field,
+                                       uchar *buff, uchar *buff_end);
 static void unpack_addon_fields(struct st_sort_addon_field *addon_field,
                                 uchar *buff, uchar *buff_end);
 static bool check_if_pq_applicable(Sort_param *param, Filesort_info *info,
@@ -154,6 +156,7 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
   ha_rows num_rows= HA_POS_ERROR;
   IO_CACHE tempfile, buffpek_pointers, *outfile; 
   Sort_param param;
+  Sort_threads sort_threads;
   bool multi_byte_charset;
   Bounded_queue<uchar, uchar> pq;
 
@@ -194,16 +197,13 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
                           table,
                           thd->variables.max_length_for_sort_data,
                           max_rows, sort_positions);
+  param.max_threads= (uint) thd->variables.max_sort_threads;
+  param.threads= &sort_threads;
+  param.sort_form= table;
+  param.end=(param.local_sortorder=sortorder)+s_length;
 
   table_sort.addon_buf= 0;
-  table_sort.addon_length= param.addon_length;
   table_sort.addon_field= param.addon_field;
-  table_sort.unpack= unpack_addon_fields;
-  if (param.addon_field &&
-      !(table_sort.addon_buf=
-        (uchar *) my_malloc(param.addon_length, MYF(MY_WME |
-                                                    MY_THREAD_SPECIFIC))))
-    goto err;
 
   if (select && select->quick)
     thd->inc_status_sort_range();
@@ -246,6 +246,10 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
   {
     DBUG_PRINT("info", ("filesort PQ is not applicable"));
 
+    /* Records of variable length don't work with the priority queue */
+    param.try_to_pack_sortkeys();
+    param.try_to_pack_addons();
+
     size_t min_sort_memory= MY_MAX(MIN_SORT_MEMORY, param.sort_length*MERGEBUFF2);
     set_if_bigger(min_sort_memory, sizeof(BUFFPEK*)*MERGEBUFF2);
     while (memory_available >= min_sort_memory)
@@ -281,12 +285,29 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
     }
   }
 
+  table_sort.addon_length= param.addon_length;
+  table_sort.using_packed_addons= param.using_packed_addons;
+  table_sort.unpack= (param.using_packed_addons ? unpack_packed_addon_fields :
+                      unpack_addon_fields);
+  if (param.addon_field &&
+      !(table_sort.addon_buf=
+        (uchar *) my_malloc(param.addon_length, MYF(MY_WME |
+                                                    MY_THREAD_SPECIFIC))))
+    goto err;
+  /*
+    make_sortkey() may use the space after the key parts of a string key
+    as a temporary buffer, so the record buffer must hold a key more.
+  */
+  if (param.using_packed_records() &&
+      !(param.packed_record=
+        (uchar *) my_malloc(param.rec_length + param.sort_length,
+                            MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    goto err;
+
   if (open_cached_file(&buffpek_pointers,mysql_tmpdir,TEMP_PREFIX,
 		       DISK_BUFFER_SIZE, MYF(MY_WME)))
     goto err;
 
-  param.sort_form= table;
-  param.end=(param.local_sortorder=sortorder)+s_length;
   num_rows= find_all_keys(&param, select,
                           &table_sort,
                           &buffpek_pointers,
@@ -361,7 +382,10 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
   error= 0;
 
   err:
+  sort_threads.end();
   my_free(param.tmp_buffer);
+  my_free(param.pad_images);
+  my_free(param.packed_record);
   if (!subselect || !subselect->is_uncacheable())
   {
     table_sort.free_sort_buffer();
@@ -452,6 +476,7 @@ void filesort_free_buffers(TABLE *table, bool full)
   my_free(table->sort.addon_field);
   table->sort.addon_buf= NULL;
   table->sort.addon_field= NULL;
+  table->sort.using_packed_addons= false;
   DBUG_VOID_RETURN;
 }
 
@@ -666,6 +691,7 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
 {
   int error,flag,quick_select;
   uint idx,indexpos,ref_length;
+  ha_rows rows_in_file= 0;
   uchar *ref_pos,*next_pos,ref_buff[MAX_REFLENGTH];
   my_off_t record;
   TABLE *sort_form;
@@ -812,12 +838,32 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
         pq->push(ref_pos);
         idx= pq->num_elements();
       }
+      else if (param->using_packed_records())
+      {
+        /*
+          Make the record aside as its length is not known in advance,
+          and add it to the buffer if it still fits in.
+        */
+        make_sortkey(param, param->packed_record, ref_pos);
+        uint length= param->get_record_length(param->packed_record);
+        if (!fs_info->add_packed_record(idx, param->packed_record, length))
+        {
+          if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
+             DBUG_RETURN(HA_POS_ERROR);
+          rows_in_file+= idx;
+	  idx= 0;
+	  indexpos++;
+          (void) fs_info->add_packed_record(idx, param->packed_record, length);
+        }
+        idx++;
+      }
       else
       {
         if (idx == param->max_keys_per_buffer)
         {
           if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
              DBUG_RETURN(HA_POS_ERROR);
+          rows_in_file+= idx;
 	  idx= 0;
 	  indexpos++;
         }
@@ -855,12 +901,13 @@ static ha_rows find_all_keys(Sort_param *param, SQL_SELECT *select,
     file->print_error(error,MYF(ME_ERROR | ME_WAITTANG)); // purecov: inspected
     DBUG_RETURN(HA_POS_ERROR);			/* purecov: inspected */
   }
-  if (indexpos && idx &&
-      write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
-    DBUG_RETURN(HA_POS_ERROR);			/* purecov: inspected */
-  const ha_rows retval=
-    my_b_inited(tempfile) ?
-    (ha_rows) (my_b_tell(tempfile)/param->rec_length) : idx;
+  if (indexpos && idx)
+  {
+    if (write_keys(param, fs_info, idx, buffpek_pointers, tempfile))
+      DBUG_RETURN(HA_POS_ERROR);		/* purecov: inspected */
+    rows_in_file+= idx;
+  }
+  const ha_rows retval= my_b_inited(tempfile) ? rows_in_file : idx;
   DBUG_PRINT("info", ("find_all_keys return %u", (uint) retval));
   DBUG_RETURN(retval);
 } /* find_all_keys */
@@ -900,7 +947,8 @@ write_keys(Sort_param *param,  Filesort_info *fs_info, uint count,
   rec_length= param->rec_length;
   uchar **sort_keys= fs_info->get_sort_keys();
 
-  fs_info->sort_buffer(param, count);
+  if (fs_info->sort_buffer(param, count))
+    status_var_increment(current_thd->status_var.filesort_radix_count_);
 
   if (!my_b_inited(tempfile) &&
       open_cached_file(tempfile, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
@@ -914,8 +962,12 @@ write_keys(Sort_param *param,  Filesort_info *fs_info, uint count,
     count=(uint) param->max_rows;               /* purecov: inspected */
   buffpek.count=(ha_rows) count;
   for (end=sort_keys+count ; sort_keys != end ; sort_keys++)
+  {
+    if (param->using_packed_records())
+      rec_length= param->get_record_length(*sort_keys);
     if (my_b_write(tempfile, (uchar*) *sort_keys, (uint) rec_length))
       goto err;
+  }
   if (my_b_write(buffpek_pointers, (uchar*) &buffpek, sizeof(buffpek)))
     goto err;
   DBUG_RETURN(0);
@@ -948,6 +1000,33 @@ static inline void store_length(uchar *to, uint length, uint pack_length)
 }
 
 
+/**
+  Pack a key part made by make_sortkey() 2 bytes after its start.
+
+  The null byte is moved to the start and followed by the length of the
+  key bytes, which are cut where they become equal to the pad image.
+*/
+
+static uchar *pack_sort_key_part(uchar *to, SORT_FIELD *sort_field,
+                                 bool maybe_null)
+{
+  uchar *key= to + 2 + maybe_null;
+  uint length= sort_field->length;
+
+  if (maybe_null)
+  {
+    to[0]= to[2];
+    /* A NULL value has the null byte 0, or 1 if the key part is reversed */
+    if (to[0] == (uchar) sort_field->reverse)
+      length= 0;
+  }
+  while (length && key[length - 1] == sort_field->pad_image[length - 1])
+    length--;
+  int2store(to + maybe_null, length);
+  return key + length;
+}
+
+
 /** Make a sort-key from record. */
 
 static void make_sortkey(register Sort_param *param,
@@ -956,12 +1035,19 @@ static void make_sortkey(register Sort_param *param,
   reg3 Field *field;
   reg1 SORT_FIELD *sort_field;
   reg5 uint length;
+  uchar *key_start= to;
+
+  if (param->using_packed_sortkeys)
+    to+= 4;                                     // Place for the key length
 
   for (sort_field=param->local_sortorder ;
        sort_field != param->end ;
        sort_field++)
   {
     bool maybe_null=0;
+    uchar *part_start= to;
+    if (sort_field->pad_image)
+      to+= 2;                                   // Place for the part length
     if ((field=sort_field->field))
     {						// Field
       field->make_sort_key(to, sort_field->length);
@@ -1131,20 +1217,54 @@ static void make_sortkey(register Sort_param *param,
       if (maybe_null && (to[-1]= !to[-1]))
       {
         to+= sort_field->length; // don't waste the time reversing all 0's
-        continue;
       }
-      length=sort_field->length;
-      while (length--)
+      else
       {
-	*to = (uchar) (~ *to);
-	to++;
+        length=sort_field->length;
+        while (length--)
+        {
+          *to = (uchar) (~ *to);
+          to++;
+        }
       }
     }
     else
       to+= sort_field->length;
+
+    if (sort_field->pad_image)
+      to= pack_sort_key_part(part_start, sort_field, maybe_null);
   }
 
-  if (param->addon_field)
+  if (!param->addon_field)
+  {
+    /* Save filepos last */
+    memcpy((uchar*) to, ref_pos, (size_t) param->ref_length);
+    to+= param->ref_length;
+  }
+  if (param->using_packed_sortkeys)
+    int4store(key_start, (uint32) (to - key_start));
+
+  if (param->addon_field && param->using_packed_addons)
+  {
+    /*
+      Save the packed field values after the length of the addon part and
+      the null bit indicators. NULL values take no space.
+    */
+    SORT_ADDON_FIELD *addonf= param->addon_field;
+    uchar *start= to;
+    uchar *nulls= to + 4;
+    memset(nulls, 0, addonf->offset);
+    to= nulls + addonf->offset;
+    for ( ; (field= addonf->field) ; addonf++)
+    {
+      if (addonf->null_bit && field->is_null())
+        nulls[addonf->null_offset]|= addonf->null_bit;
+      else
+        to= field->pack(to, field->ptr);
+    }
+    int4store(start, (uint32) (to - start));
+  }
+  else if (param->addon_field)
   {
     /* 
       Save field values appended to sorted fields.
@@ -1181,11 +1301,6 @@ static void make_sortkey(register Sort_param *param,
       to+= addonf->length;
     }
   }
-  else
-  {
-    /* Save filepos last */
-    memcpy((uchar*) to, ref_pos, (size_t) param->ref_length);
-  }
   return;
 }
 
@@ -1245,15 +1360,36 @@ static bool save_index(Sort_param *param, uint count, Filesort_info *table_sort)
   uchar *to;
   DBUG_ENTER("save_index");
 
-  table_sort->sort_buffer(param, count);
+  if (table_sort->sort_buffer(param, count))
+    status_var_increment(current_thd->status_var.filesort_radix_count_);
+  uchar **sort_keys= table_sort->get_sort_keys();
+  uchar **end= sort_keys+count;
+  if (param->using_packed_records())
+  {
+    size_t length= 0;
+    for (uchar **key= sort_keys; key != end; key++)
+    {
+      (void) param->get_result(*key, &res_length);
+      length+= res_length;
+    }
+    if (!(to= table_sort->record_pointers=
+          (uchar*) my_malloc(length, MYF(MY_WME | MY_THREAD_SPECIFIC))))
+      DBUG_RETURN(1);               /* purecov: inspected */
+    for ( ; sort_keys != end ; sort_keys++)
+    {
+      uchar *res= param->get_result(*sort_keys, &res_length);
+      memcpy(to, res, res_length);
+      to+= res_length;
+    }
+    DBUG_RETURN(0);
+  }
   res_length= param->res_length;
   offset= param->rec_length-res_length;
   if (!(to= table_sort->record_pointers= 
         (uchar*) my_malloc(res_length*count,
                            MYF(MY_WME | MY_THREAD_SPECIFIC))))
     DBUG_RETURN(1);                 /* purecov: inspected */
-  uchar **sort_keys= table_sort->get_sort_keys();
-  for (uchar **end= sort_keys+count ; sort_keys != end ; sort_keys++)
+  for ( ; sort_keys != end ; sort_keys++)
   {
     memcpy(to, *sort_keys+offset, res_length);
     to+= res_length;
@@ -1483,6 +1619,88 @@ uint read_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
 } /* read_to_buffer */
 
 
+/**
+  Read records of variable length to buffer.
+
+  Reads as many whole records as fit into the max_keys * rec_length bytes
+  of the buffer.
+
+  @retval
+    Number of bytes of the records read
+  @retval
+    (uint)-1 if something goes wrong
+*/
+
+static uint read_packed_to_buffer(IO_CACHE *fromfile, BUFFPEK *buffpek,
+                                  Sort_param *param)
+{
+  uint count= 0;
+  size_t length;
+  uchar *pos= buffpek->base, *end;
+
+  if (!buffpek->count)
+    return 0;
+  /* The buffer may be longer than the rest of the file */
+  if ((length= mysql_file_pread(fromfile->file, (uchar*) buffpek->base,
+                                buffpek->max_keys * param->rec_length,
+                                buffpek->file_pos, MYF(MY_WME))) ==
+      (size_t) -1)
+    return((uint) -1);                          /* purecov: inspected */
+  end= pos + length;
+  for ( ; count < buffpek->count; count++)
+  {
+    size_t left= (size_t) (end - pos);
+    uint key_length= param->sort_length, rec_length;
+    if (param->using_packed_sortkeys)
+    {
+      if (left < 4)
+        break;
+      key_length= uint4korr(pos);
+    }
+    if (param->using_packed_addons)
+    {
+      if (left < key_length + 4)
+        break;
+      rec_length= key_length + uint4korr(pos + key_length);
+    }
+    else
+      rec_length= key_length + param->addon_length;
+    if (left < rec_length)
+      break;
+    pos+= rec_length;
+  }
+  length= (size_t) (pos - buffpek->base);
+  buffpek->key= buffpek->base;
+  buffpek->file_pos+= length;
+  buffpek->count-= count;
+  buffpek->mem_count= count;
+  return (uint) length;
+}
+
+
+static inline uint read_keys_to_buffer(Sort_param *param, IO_CACHE *fromfile,
+                                       BUFFPEK *buffpek)
+{
+  if (param->using_packed_records())
+    return read_packed_to_buffer(fromfile, buffpek, param);
+  return read_to_buffer(fromfile, buffpek, param->rec_length);
+}
+
+
+/** Write a record of variable length, or its result part if flag is set */
+
+static bool write_packed_record(Sort_param *param, IO_CACHE *to_file,
+                                uchar *rec, int flag)
+{
+  uint length;
+  if (flag)
+    rec= param->get_result(rec, &length);
+  else
+    length= param->get_record_length(rec);
+  return my_b_write(to_file, rec, length);
+}
+
+
 /**
   Put all room used by freed buffer to use in adjacent buffer.
 
@@ -1585,6 +1803,11 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
     cmp= param->compare;
     first_cmp_arg= (void *) &param->cmp_context;
   }
+  else if (param->using_packed_sortkeys)
+  {
+    cmp= (qsort2_cmp) compare_packed_sort_keys;
+    first_cmp_arg= (void*) param;
+  }
   else
   {
     cmp= get_ptr_compare(sort_length);
@@ -1597,6 +1820,18 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
   {
     buffpek->base= strpos;
     buffpek->max_keys= maxcount;
+    if (param->using_packed_records())
+    {
+      error= (int) read_packed_to_buffer(from_file, buffpek, param);
+      if (error == -1)
+        goto err;                               /* purecov: inspected */
+      /* Keep all the space, unless all records were read */
+      if (!buffpek->count)
+        buffpek->max_keys= (error + rec_length - 1) / rec_length;
+      strpos+= buffpek->max_keys * rec_length;
+      queue_insert(&queue, (uchar*) buffpek);
+      continue;
+    }
     strpos+=
       (uint) (error= (int) read_to_buffer(from_file, buffpek, rec_length));
 
@@ -1674,7 +1909,14 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
         then for any element:
         dupl_count >= N <=> the element is occurred in each of these N sets.
       */          
-      if (!check_dupl_count || dupl_count >= min_dupl_count)
+      if (param->using_packed_records())
+      {
+        if (write_packed_record(param, to_file, src, flag))
+        {
+          error=1; goto err;                        /* purecov: inspected */
+        }
+      }
+      else if (!check_dupl_count || dupl_count >= min_dupl_count)
       {
         if (my_b_write(to_file, src+wr_offset, wr_len))
         {
@@ -1695,11 +1937,10 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
       }
 
     skip_duplicate:
-      buffpek->key+= rec_length;
+      buffpek->key+= param->get_record_length(buffpek->key);
       if (! --buffpek->mem_count)
       {
-        if (!(error= (int) read_to_buffer(from_file, buffpek,
-                                          rec_length)))
+        if (!(error= (int) read_keys_to_buffer(param, from_file, buffpek)))
         {
           (void) queue_remove_top(&queue);
           reuse_freed_buff(&queue, buffpek, rec_length);
@@ -1760,7 +2001,20 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
       buffpek->count= 0;                        /* Don't read more */
     }
     max_rows-= buffpek->mem_count;
-    if (flag == 0)
+    if (param->using_packed_records())
+    {
+      uchar *rec= buffpek->key;
+      for (uint i= 0; i < buffpek->mem_count; i++)
+      {
+        uint length= param->get_record_length(rec);
+        if (write_packed_record(param, to_file, rec, flag))
+        {
+          error=1; goto err;                        /* purecov: inspected */
+        }
+        rec+= length;
+      }
+    }
+    else if (flag == 0)
     {
       if (my_b_write(to_file, (uchar*) buffpek->key,
                      (rec_length*buffpek->mem_count)))
@@ -1789,7 +2043,7 @@ int merge_buffers(Sort_param *param, IO_CACHE *from_file,
       }
     }
   }
-  while ((error=(int) read_to_buffer(from_file, buffpek, rec_length))
+  while ((error=(int) read_keys_to_buffer(param, from_file, buffpek))
          != -1 && error != 0);
 
 end:
@@ -1859,6 +2113,7 @@ sortlength(THD *thd, SORT_FIELD *sortorder, uint s_length,
   {
     sortorder->need_strxnfrm= 0;
     sortorder->suffix_length= 0;
+    sortorder->pad_image= 0;
     if (sortorder->field)
     {
       cs= sortorder->field->sort_charset();
@@ -2062,6 +2317,206 @@ unpack_addon_fields(struct st_sort_addon_field *addon_field, uchar *buff,
   }
 }
 
+/**
+  Unpack packed values appended to sorted fields, see unpack_addon_fields().
+*/
+
+static void
+unpack_packed_addon_fields(struct st_sort_addon_field *addon_field,
+                           uchar *buff, uchar *buff_end)
+{
+  Field *field;
+  SORT_ADDON_FIELD *addonf= addon_field;
+  uchar *nulls= buff + 4;
+
+  buff= nulls + addonf->offset;
+  for ( ; (field= addonf->field) ; addonf++)
+  {
+    if (addonf->null_bit && (addonf->null_bit & nulls[addonf->null_offset]))
+    {
+      field->set_null();
+      continue;
+    }
+    field->set_notnull();
+    buff= (uchar*) field->unpack(field->ptr, buff, buff_end, 0);
+  }
+}
+
+
+/**
+  Check if a key part is worth packing.
+
+  Only string key parts are packed, as only they are padded. Binary
+  strings end with their length (see sortlength()) and can't be cut.
+*/
+
+static bool is_packable_sort_field(SORT_FIELD *sort_field)
+{
+  if (sort_field->length < MIN_PACKED_SORT_KEY_PART_LENGTH ||
+      sort_field->length > UINT_MAX16)
+    return false;
+  if (sort_field->field)
+    return (sort_field->field->result_type() == STRING_RESULT &&
+            sort_field->field->sort_charset() != &my_charset_bin);
+  return (sort_field->result_type == STRING_RESULT &&
+          !sort_field->suffix_length);
+}
+
+
+/**
+  Use packed sort keys if the key has string parts worth packing.
+
+  The pad image of a packed key part is the key made for an empty string.
+  A key can be cut where it becomes equal to the pad image, as this part
+  of the key can always be compared against the pad image instead.
+*/
+
+void Sort_param::try_to_pack_sortkeys()
+{
+  SORT_FIELD *sort_field;
+  uint packed_parts= 0;
+  size_t pad_length= 0;
+
+  for (sort_field= local_sortorder; sort_field != end; sort_field++)
+  {
+    if (is_packable_sort_field(sort_field))
+    {
+      packed_parts++;
+      pad_length+= sort_field->length;
+    }
+  }
+  if (!packed_parts ||
+      !(pad_images= (uchar*) my_malloc(pad_length,
+                                       MYF(MY_THREAD_SPECIFIC))))
+    return;
+
+  uchar *pad= pad_images;
+  for (sort_field= local_sortorder; sort_field != end; sort_field++)
+  {
+    if (!is_packable_sort_field(sort_field))
+      continue;
+    if (sort_field->field)
+    {
+      CHARSET_INFO *cs= sort_field->field->sort_charset();
+      cs->coll->strnxfrm(cs, pad, sort_field->length,
+                         sort_field->field->char_length(),
+                         (const uchar*) "", 0,
+                         MY_STRXFRM_PAD_WITH_SPACE |
+                         MY_STRXFRM_PAD_TO_MAXLEN);
+    }
+    else
+    {
+      CHARSET_INFO *cs= sort_field->item->collation.collation;
+      if (sort_field->need_strxnfrm)
+        cs->coll->strnxfrm(cs, pad, sort_field->length,
+                           sort_field->item->max_char_length() *
+                           cs->strxfrm_multiply,
+                           (const uchar*) "", 0,
+                           MY_STRXFRM_PAD_WITH_SPACE |
+                           MY_STRXFRM_PAD_TO_MAXLEN);
+      else
+        cs->cset->fill(cs, (char*) pad, sort_field->length,
+                       (cs->state & MY_CS_BINSORT) ? (char) 0 : ' ');
+    }
+    if (sort_field->reverse)
+    {
+      for (uint i= 0; i < sort_field->length; i++)
+        pad[i]= (uchar) ~pad[i];
+    }
+    sort_field->pad_image= pad;
+    pad+= sort_field->length;
+  }
+  using_packed_sortkeys= true;
+  /* The key length and the lengths of the packed parts */
+  rec_length+= 4 + 2 * packed_parts;
+}
+
+
+/**
+  Use packed addon fields if some of them are strings.
+*/
+
+void Sort_param::try_to_pack_addons()
+{
+  SORT_ADDON_FIELD *addonf;
+
+  if (!addon_field)
+    return;
+  for (addonf= addon_field; addonf->field; addonf++)
+  {
+    switch (addonf->field->real_type()) {
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+      using_packed_addons= true;
+      /* The length of the addon part */
+      addon_length+= 4;
+      res_length= addon_length;
+      rec_length+= 4;
+      return;
+    default:
+      break;
+    }
+  }
+}
+
+
+/**
+  Compare packed sort keys, see Sort_param.
+
+  A packed key part that is shorter than the other one is compared as if
+  it went on with its pad image.
+*/
+
+int compare_packed_sort_keys(const Sort_param *param,
+                             uchar **a_ptr, uchar **b_ptr)
+{
+  uchar *a= *a_ptr + 4, *b= *b_ptr + 4;
+  int res;
+
+  for (SORT_FIELD *sort_field= param->local_sortorder;
+       sort_field != param->end;
+       sort_field++)
+  {
+    bool maybe_null= (sort_field->field ? sort_field->field->maybe_null() :
+                      sort_field->item->maybe_null);
+    if (maybe_null)
+    {
+      if (*a != *b)
+        return (int) *a - (int) *b;
+      a++;
+      b++;
+    }
+    if (!sort_field->pad_image)
+    {
+      if ((res= memcmp(a, b, sort_field->length)))
+        return res;
+      a+= sort_field->length;
+      b+= sort_field->length;
+      continue;
+    }
+
+    uint a_length= uint2korr(a), b_length= uint2korr(b);
+    a+= 2;
+    b+= 2;
+    if ((res= memcmp(a, b, MY_MIN(a_length, b_length))))
+      return res;
+    if (a_length < b_length)
+      res= memcmp(sort_field->pad_image + a_length, b + a_length,
+                  b_length - a_length);
+    else if (a_length > b_length)
+      res= memcmp(a + b_length, sort_field->pad_image + b_length,
+                  a_length - b_length);
+    if (res)
+      return res;
+    a+= a_length;
+    b+= b_length;
+  }
+  /* The record reference is the last part of the key */
+  return param->addon_field ? 0 : memcmp(a, b, param->ref_length);
+}
+
+
 /*
 ** functions to change a double or float to a sortable string
 ** The following should work for IEEE
@@ -18,6 +18,7 @@
 #include "sql_sort.h"
 #include "table.h"
 #include "my_sys.h"
+#include "mysqld.h"                             // key_thread_sort
 
 
 namespace {
@@ -120,24 +121,326 @@ void Filesort_buffer::free_sort_buffer()
   m_idx_array= Idx_array();
   m_record_length= 0;
   m_start_of_data= NULL;
+  m_end_of_packed_data= NULL;
 }
 
 
-void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+/**
+  A part of the sort of one sort buffer done by one thread.
+
+  A job either sorts a range of the key pointers, or merges two adjacent
+  sorted ranges of the pointers into the same positions of another array.
+*/
+struct Sort_job
 {
-  if (count <= 1)
+  uchar **keys;            // the range to sort, or the ranges to merge
+  uchar **buffer;          // auxiliary array, or the merge destination
+  size_t count;            // number of keys in the (first) range
+  size_t count2;           // number of keys in the second range to merge
+  size_t sort_length;
+  const Sort_param *packed_keys; // set if the keys are packed
+  bool merge;
+  bool radix;              // set if the range was radix sorted
+
+  void sort()
+  {
+    if (packed_keys)
+    {
+      radix= false;
+      my_qsort2(keys, count, sizeof(uchar*),
+                (qsort2_cmp) compare_packed_sort_keys, (void*) packed_keys);
+      return;
+    }
+    radix= radixsort_msd_is_applicable((uint) count, sort_length) &&
+           !radixsort_msd_for_str_ptr(keys, (uint) count, sort_length, buffer);
+    if (!radix)
+      my_qsort2(keys, count, sizeof(uchar*), get_ptr_compare(sort_length),
+                &sort_length);
+  }
+
+  bool less(uchar **a, uchar **b)
+  {
+    if (packed_keys)
+      return compare_packed_sort_keys(packed_keys, a, b) < 0;
+    return memcmp(*a, *b, sort_length) < 0;
+  }
+
+  void merge_ranges()
+  {
+    uchar **from1= keys, **end1= keys + count;
+    uchar **from2= end1, **end2= end1 + count2;
+    uchar **to= buffer;
+    while (from1 < end1 && from2 < end2)
+    {
+      if (less(from2, from1))
+        *to++= *from2++;
+      else
+        *to++= *from1++;
+    }
+    while (from1 < end1)
+      *to++= *from1++;
+    while (from2 < end2)
+      *to++= *from2++;
+  }
+
+  void run()
+  {
+    if (merge)
+      merge_ranges();
+    else
+      sort();
+  }
+};
+
+
+/* Number of Sort_threads threads in the server, see max_total_sort_threads */
+static int32 sort_threads_running= 0;
+
+
+pthread_handler_t sort_thread_handler(void *arg)
+{
+  Sort_threads *threads= (Sort_threads *) arg;
+  Sort_job *job;
+  my_thread_init();
+  while ((job= threads->next_job()))
+  {
+    job->run();
+    threads->job_done();
+  }
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Waits for a job, for handler().
+
+  @return the job to run, or NULL if the threads are stopped
+*/
+Sort_job *Sort_threads::next_job()
+{
+  Sort_job *job= NULL;
+  mysql_mutex_lock(&m_lock);
+  while (!m_stop && m_next_job == m_job_count)
+    mysql_cond_wait(&m_cond_job, &m_lock);
+  if (!m_stop)
+    job= m_jobs + m_next_job++;
+  mysql_mutex_unlock(&m_lock);
+  return job;
+}
+
+
+void Sort_threads::job_done()
+{
+  mysql_mutex_lock(&m_lock);
+  if (!--m_jobs_left)
+    mysql_cond_signal(&m_cond_done);
+  mysql_mutex_unlock(&m_lock);
+}
+
+
+uint Sort_threads::start(uint n_threads)
+{
+  int32 wanted= (int32) MY_MIN(n_threads, MAX_SORT_THREADS) - 1 -
+                (int32) m_count;
+  if (wanted <= 0)
+    return m_count + 1;
+
+  /* Take what is left of the server-wide limit */
+  int32 running= my_atomic_add32(&sort_threads_running, wanted) + wanted;
+  int32 over= running - (int32) max_total_sort_threads;
+  if (over > 0)
+  {
+    set_if_smaller(over, wanted);
+    my_atomic_add32(&sort_threads_running, -over);
+    wanted-= over;
+  }
+  if (wanted <= 0)
+    return m_count + 1;
+
+  if (!m_inited)
+  {
+    mysql_mutex_init(key_LOCK_sort_threads, &m_lock, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_COND_sort_job, &m_cond_job, NULL);
+    mysql_cond_init(key_COND_sort_job_done, &m_cond_done, NULL);
+    m_jobs= NULL;
+    m_job_count= m_next_job= m_jobs_left= 0;
+    m_stop= false;
+    m_inited= true;
+  }
+  for (; wanted; wanted--)
+  {
+    if (mysql_thread_create(key_thread_sort, &m_threads[m_count], NULL,
+                            sort_thread_handler, this))
+      break;
+    m_count++;
+  }
+  if (wanted)
+    my_atomic_add32(&sort_threads_running, -wanted);
+  return m_count + 1;
+}
+
+
+/**
+  The caller takes jobs as well, so the jobs are done even if some
+  of the threads are slow to wake up.
+*/
+void Sort_threads::run(Sort_job *jobs, uint count)
+{
+  mysql_mutex_lock(&m_lock);
+  DBUG_ASSERT(!m_jobs_left);
+  m_jobs= jobs;
+  m_job_count= count;
+  m_next_job= 0;
+  m_jobs_left= count;
+  mysql_cond_broadcast(&m_cond_job);
+  while (m_next_job < m_job_count)
+  {
+    Sort_job *job= m_jobs + m_next_job++;
+    mysql_mutex_unlock(&m_lock);
+    job->run();
+    mysql_mutex_lock(&m_lock);
+    m_jobs_left--;
+  }
+  while (m_jobs_left)
+    mysql_cond_wait(&m_cond_done, &m_lock);
+  m_job_count= m_next_job= 0;
+  mysql_mutex_unlock(&m_lock);
+}
+
+
+void Sort_threads::end()
+{
+  if (!m_inited)
     return;
+  mysql_mutex_lock(&m_lock);
+  m_stop= true;
+  mysql_cond_broadcast(&m_cond_job);
+  mysql_mutex_unlock(&m_lock);
+  for (uint i= 0; i < m_count; i++)
+    pthread_join(m_threads[i], NULL);
+  my_atomic_add32(&sort_threads_running, -(int32) m_count);
+  m_count= 0;
+  mysql_cond_destroy(&m_cond_done);
+  mysql_cond_destroy(&m_cond_job);
+  mysql_mutex_destroy(&m_lock);
+  m_inited= false;
+}
+
+
+/**
+  Sort the keys with several threads.
+
+  The keys are split into n_threads ranges that are sorted in parallel.
+  Then pairs of adjacent sorted ranges are merged in parallel into the
+  auxiliary array and back until one sorted range remains.
+
+  @param keys          the key pointers to sort
+  @param buffer        auxiliary array of count pointers
+  @param count         number of keys
+  @param sort_length   length of the keys
+  @param threads       the threads to use
+  @param n_threads     number of the threads, at least 2
+  @param packed_keys   the sort parameters if the keys are packed, or NULL
+
+  @retval true   some of the ranges were radix sorted
+  @retval false  quicksort was used for all ranges
+*/
+static bool parallel_sort(uchar **keys, uchar **buffer, size_t count,
+                          size_t sort_length, Sort_threads *threads,
+                          uint n_threads, const Sort_param *packed_keys)
+{
+  Sort_job jobs[MAX_SORT_THREADS];
+  size_t starts[MAX_SORT_THREADS + 1];
+  uint n_ranges= n_threads;
+
+  for (uint i= 0; i <= n_ranges; i++)
+    starts[i]= count * i / n_ranges;
+
+  for (uint i= 0; i < n_ranges; i++)
+  {
+    jobs[i].keys= keys + starts[i];
+    jobs[i].buffer= buffer + starts[i];
+    jobs[i].count= starts[i+1] - starts[i];
+    jobs[i].count2= 0;
+    jobs[i].sort_length= sort_length;
+    jobs[i].packed_keys= packed_keys;
+    jobs[i].merge= false;
+  }
+  threads->run(jobs, n_ranges);
+
+  bool radix= false;
+  for (uint i= 0; i < n_ranges; i++)
+    radix|= jobs[i].radix;
+
+  uchar **from= keys, **to= buffer;
+  while (n_ranges > 1)
+  {
+    uint n_jobs= 0;
+    for (uint i= 0; i < n_ranges; i+= 2, n_jobs++)
+    {
+      Sort_job *job= jobs + n_jobs;
+      job->keys= from + starts[i];
+      job->buffer= to + starts[i];
+      job->count= starts[i+1] - starts[i];
+      /* The last range without a pair is just copied */
+      job->count2= i + 1 < n_ranges ? starts[i+2] - starts[i+1] : 0;
+      job->sort_length= sort_length;
+      job->packed_keys= packed_keys;
+      job->merge= true;
+      starts[n_jobs]= starts[i];
+    }
+    starts[n_jobs]= count;
+    threads->run(jobs, n_jobs);
+    n_ranges= n_jobs;
+    swap_variables(uchar **, from, to);
+  }
+  if (from != keys)
+    memcpy(keys, from, count * sizeof(uchar*));
+  return radix;
+}
+
+
+bool Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
+{
+  bool radix= false;
+  if (count <= 1)
+    return false;
   uchar **keys= get_sort_keys();
   uchar **buffer= NULL;
-  if (radixsort_is_appliccable(count, param->sort_length) &&
+  uint n_threads= MY_MIN(param->max_threads, count / MIN_KEYS_PER_SORT_THREAD);
+  const Sort_param *packed_keys= param->using_packed_sortkeys ? param : NULL;
+
+  if (n_threads > 1 && param->threads)
+    n_threads= param->threads->start(n_threads);
+  if (n_threads > 1 && param->threads &&
       (buffer= (uchar**) my_malloc(count*sizeof(char*),
                                    MYF(MY_THREAD_SPECIFIC))))
   {
-    radixsort_for_str_ptr(keys, count, param->sort_length, buffer);
+    radix= parallel_sort(keys, buffer, count, param->sort_length,
+                         param->threads, n_threads, packed_keys);
     my_free(buffer);
-    return;
+    return radix;
+  }
+
+  if (packed_keys)
+  {
+    my_qsort2(keys, count, sizeof(uchar*),
+              (qsort2_cmp) compare_packed_sort_keys, (void*) packed_keys);
+    return false;
+  }
+
+  if (radixsort_msd_is_applicable(count, param->sort_length) &&
+      (buffer= (uchar**) my_malloc(count*sizeof(char*),
+                                   MYF(MY_THREAD_SPECIFIC))))
+  {
+    radix= !radixsort_msd_for_str_ptr(keys, count, param->sort_length, buffer);
+    my_free(buffer);
+    if (radix)
+      return true;
   }
   
   size_t size= param->sort_length;
   my_qsort2(keys, count, sizeof(uchar*), get_ptr_compare(size), &size);
+  return false;
 }
@@ -61,11 +61,17 @@ class Filesort_buffer
 {
 public:
   Filesort_buffer() :
-    m_idx_array(), m_record_length(0), m_start_of_data(NULL)
+    m_idx_array(), m_record_length(0), m_start_of_data(NULL),
+    m_end_of_packed_data(NULL)
   {}
 
-  /** Sort me... */
-  void sort_buffer(const Sort_param *param, uint count);
+  /**
+    Sort me...
+
+    @retval true   the keys were radix sorted
+    @retval false  the keys were sorted with quicksort
+  */
+  bool sort_buffer(const Sort_param *param, uint count);
 
   /// Initializes a record pointer.
   uchar *get_record_buffer(uint idx)
@@ -74,6 +80,30 @@ public:
     return m_idx_array[idx];
   }
 
+  /**
+    Copies a record of variable length to the buffer as record number idx.
+
+    The records are stored from the end of the buffer towards the pointers
+    at its start, so the buffer holds as many records as fit in, which may
+    be more than num_records.
+
+    @retval false  there is no room for the record
+  */
+  bool add_packed_record(uint idx, const uchar *record, uint length)
+  {
+    uchar **keys= m_idx_array.array();
+    if (idx == 0)
+      m_end_of_packed_data= reinterpret_cast<uchar*>(keys) +
+                            sort_buffer_size();
+    uchar *to= m_end_of_packed_data - length;
+    if (to < reinterpret_cast<uchar*>(keys + idx + 1))
+      return false;
+    memcpy(to, record, length);
+    keys[idx]= to;
+    m_end_of_packed_data= to;
+    return true;
+  }
+
   /// Initializes all the record pointers.
   void init_record_pointers()
   {
@@ -115,6 +145,7 @@ public:
     m_idx_array= rhs.m_idx_array;
     m_record_length= rhs.m_record_length;
     m_start_of_data= rhs.m_start_of_data;
+    m_end_of_packed_data= rhs.m_end_of_packed_data;
     return *this;
   }
 
@@ -124,6 +155,7 @@ private:
   Idx_array  m_idx_array;
   uint       m_record_length;
   uchar     *m_start_of_data;
+  uchar     *m_end_of_packed_data;
 };
 
 #endif  // FILESORT_UTILS_INCLUDED
@@ -0,0 +1,149 @@
+/* Copyright (C) 2014 Monty Program Ab
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql_priv.h"
+#include "table.h"
+#include "key.h"                                // key_hashnr, key_buf_cmp
+#include "group_by_hash.h"
+
+#define GROUP_BY_HASH_MIN_BUCKETS 256
+
+
+Group_by_hash::Group_by_hash(TABLE *table_arg, uint key_length_arg,
+                             size_t max_size_arg)
+  :table(table_arg), key_info(table_arg->key_info),
+   key_parts(table_arg->key_info->user_defined_key_parts),
+   key_length(key_length_arg), rec_length(table_arg->s->reclength),
+   size(0), max_size(max_size_arg), buckets(NULL), n_buckets(0),
+   records(0), first(NULL), last(&first), read_pos(NULL)
+{
+  /* The buckets are doubled when full, so count two pointers per entry */
+  entry_size= ALIGN_SIZE(sizeof(Entry)) + ALIGN_SIZE(key_length) +
+              ALIGN_SIZE(rec_length) + 2 * sizeof(Entry*);
+  init_alloc_root(&mem_root, 64 * 1024, 0, MYF(MY_THREAD_SPECIFIC));
+}
+
+
+/**
+  Find the record of a group.
+
+  @param key         the group key, in the format of the key of the table
+  @param hash_value  [out] the hash value of the key, for add()
+
+  @return the record of the group, or NULL if the group is not found
+*/
+
+uchar *Group_by_hash::find(const uchar *key, ulong *hash_value)
+{
+  ulong nr= key_hashnr(key_info, key_parts, key);
+  *hash_value= nr;
+  if (!n_buckets)
+    return NULL;
+  for (Entry *entry= buckets[nr & (n_buckets - 1)]; entry;
+       entry= entry->next_in_bucket)
+  {
+    if (entry->hash_value == nr &&
+        !key_buf_cmp(key_info, key_parts, key, entry_key(entry)))
+      return entry_record(entry);
+  }
+  return NULL;
+}
+
+
+/**
+  Add a new group with its record.
+
+  The caller must check with has_room() that the group fits in.
+
+  @retval false  ok
+  @retval true   out of memory
+*/
+
+bool Group_by_hash::add(const uchar *key, ulong hash_value,
+                        const uchar *record)
+{
+  Entry *entry, **bucket;
+  DBUG_ASSERT(has_room());
+
+  if (records >= n_buckets && grow())
+    return true;
+  if (!(entry= (Entry*) alloc_root(&mem_root, ALIGN_SIZE(sizeof(Entry)) +
+                                   ALIGN_SIZE(key_length) + rec_length)))
+    return true;
+  entry->hash_value= hash_value;
+  memcpy(entry_key(entry), key, key_length);
+  memcpy(entry_record(entry), record, rec_length);
+
+  bucket= buckets + (hash_value & (n_buckets - 1));
+  entry->next_in_bucket= *bucket;
+  *bucket= entry;
+  entry->next= NULL;
+  *last= entry;
+  last= &entry->next;
+  records++;
+  size+= entry_size;
+  return false;
+}
+
+
+/** Double the number of buckets and rehash the entries */
+
+bool Group_by_hash::grow()
+{
+  ulong new_n_buckets= n_buckets ? n_buckets * 2 : GROUP_BY_HASH_MIN_BUCKETS;
+  Entry **new_buckets;
+
+  if (!(new_buckets= (Entry**) my_malloc(new_n_buckets * sizeof(Entry*),
+                                         MYF(MY_WME | MY_ZEROFILL |
+                                             MY_THREAD_SPECIFIC))))
+    return true;
+  for (Entry *entry= first; entry; entry= entry->next)
+  {
+    Entry **bucket= new_buckets + (entry->hash_value & (new_n_buckets - 1));
+    entry->next_in_bucket= *bucket;
+    *bucket= entry;
+  }
+  my_free(buckets);
+  buckets= new_buckets;
+  n_buckets= new_n_buckets;
+  return false;
+}
+
+
+/** Remove all groups, keeping the memory for the next execution */
+
+void Group_by_hash::reset()
+{
+  if (buckets)
+    bzero(buckets, n_buckets * sizeof(Entry*));
+  free_root(&mem_root, MYF(MY_MARK_BLOCKS_FREE));
+  records= 0;
+  size= 0;
+  first= read_pos= NULL;
+  last= &first;
+}
+
+
+void Group_by_hash::free()
+{
+  my_free(buckets);
+  buckets= NULL;
+  n_buckets= 0;
+  free_root(&mem_root, MYF(0));
+  records= 0;
+  size= 0;
+  first= read_pos= NULL;
+  last= &first;
+}
@@ -0,0 +1,100 @@
+/* Copyright (C) 2014 Monty Program Ab
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef GROUP_BY_HASH_INCLUDED
+#define GROUP_BY_HASH_INCLUDED
+
+#include "sql_list.h"                           // Sql_alloc
+#include "my_sys.h"
+
+struct TABLE;
+struct st_key;
+
+/**
+  In-memory hash table of the groups of a GROUP BY temporary table.
+
+  end_update() keeps the records of the groups here instead of looking
+  up and updating each of them in the temporary table for every row.
+  The records have the format of the temporary table, so the sum
+  functions are updated in table->record[0] as usual, and the hash is
+  keyed on the group key made in TMP_TABLE_PARAM::group_buff, which is
+  compared with the collation of the key parts.
+
+  The hash holds at most max_size bytes. When it is full, the temporary
+  table is moved to disk while it is still empty, and the groups that
+  don't fit in are added there, so no rows are copied from memory to
+  disk on the way. The groups in the hash are written to the temporary
+  table when all rows are read, so the two never have a group in common.
+*/
+
+class Group_by_hash :public Sql_alloc
+{
+  struct Entry
+  {
+    Entry *next_in_bucket;
+    Entry *next;                 // Next entry in the order of adding
+    ulong hash_value;
+  };
+
+public:
+  Group_by_hash(TABLE *table_arg, uint key_length_arg, size_t max_size_arg);
+  ~Group_by_hash() { free(); }
+
+  /** The temporary table whose groups are kept */
+  TABLE *table;
+
+  uchar *find(const uchar *key, ulong *hash_value);
+  bool add(const uchar *key, ulong hash_value, const uchar *record);
+
+  /** Check if the record of a new group fits in */
+  bool has_room() const { return size + entry_size <= max_size; }
+  bool is_empty() const { return first == NULL; }
+
+  /** Read the records in the order in which the groups were added */
+  void start_reading() { read_pos= first; }
+  uchar *read_next()
+  {
+    Entry *entry= read_pos;
+    if (!entry)
+      return NULL;
+    read_pos= entry->next;
+    return entry_record(entry);
+  }
+
+  void reset();
+  void free();
+
+private:
+  uchar *entry_key(Entry *entry) const
+  { return (uchar*) entry + ALIGN_SIZE(sizeof(Entry)); }
+  uchar *entry_record(Entry *entry) const
+  { return entry_key(entry) + ALIGN_SIZE(key_length); }
+  bool grow();
+
+  struct st_key *key_info;
+  uint key_parts;
+  uint key_length;
+  uint rec_length;
+  size_t entry_size;          // Memory used by an entry and its bucket
+  size_t size;                // Memory used by all entries
+  size_t max_size;
+  MEM_ROOT mem_root;
+  Entry **buckets;
+  ulong n_buckets;
+  ulong records;
+  Entry *first, **last, *read_pos;
+};
+
+#endif /* GROUP_BY_HASH_INCLUDED */
@@ -3236,6 +3236,7 @@ Item_param::Item_param(uint pos_in_query_arg) :
   pos_in_query(pos_in_query_arg),
   set_param_func(default_set_param_func),
   limit_clause_param(FALSE),
+  is_literal(FALSE),
   m_out_param_info(NULL)
 {
   name= (char*) "?";
@@ -3605,6 +3606,11 @@ double Item_param::val_real()
   {
     int dummy_err;
     char *end_not_used;
+    if (is_literal)
+      return double_from_string_with_check(str_value.charset(),
+                                           str_value.ptr(),
+                                           str_value.ptr() +
+                                           str_value.length());
     return my_strntod(str_value.charset(), (char*) str_value.ptr(),
                       str_value.length(), &end_not_used, &dummy_err);
   }
@@ -3640,6 +3646,11 @@ longlong Item_param::val_int()
   case LONG_DATA_VALUE:
     {
       int dummy_err;
+      if (is_literal)
+        return longlong_from_string_with_check(str_value.charset(),
+                                               str_value.ptr(),
+                                               str_value.ptr() +
+                                               str_value.length());
       return my_strntoll(str_value.charset(), str_value.ptr(),
                          str_value.length(), 10, (char**) 0, &dummy_err);
     }
@@ -3667,6 +3678,8 @@ my_decimal *Item_param::val_decimal(my_decimal *dec)
     return dec;
   case STRING_VALUE:
   case LONG_DATA_VALUE:
+    if (is_literal)
+      return val_decimal_from_string(dec);
     string2my_decimal(E_DEC_FATAL_ERROR, &str_value, dec);
     return dec;
   case TIME_VALUE:
@@ -3945,6 +3958,7 @@ Item_param::set_param_type_and_swap_value(Item_param *src)
   decimals= src->decimals;
   state= src->state;
   value= src->value;
+  is_literal= src->is_literal;
 
   decimal_value.swap(src->decimal_value);
   str_value.swap(src->str_value);
@@ -2364,6 +2364,11 @@ public:
   bool eq(const Item *item, bool binary_cmp) const;
   /** Item is a argument to a limit clause. */
   bool limit_clause_param;
+  /**
+    The value is a literal of a query of the normalized statement cache:
+    a string is converted to a number with warnings, like a string literal.
+  */
+  bool is_literal;
   void set_param_type_and_swap_value(Item_param *from);
 
 private:
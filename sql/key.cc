@@ -771,7 +771,7 @@ ulong key_hashnr(KEY *key_info, uint used_key_parts, const uchar *key)
       {
         uint char_length= my_charpos(cs, pos + pack_length,
                                      pos + pack_length + length,
-                                     length / cs->mbmaxlen);
+                                     key_part->length / cs->mbmaxlen);
         set_if_smaller(length, char_length);
       }
       cs->coll->hash_sort(cs, pos+pack_length, length, &nr, &nr2);
@@ -799,7 +799,9 @@ ulong key_hashnr(KEY *key_info, uint used_key_parts, const uchar *key)
   @param key1            pointer to the buffer with the first key 
   @param key2            pointer to the buffer with the second key 
 
-  @detail See details of key_hashnr().
+  @detail See details of key_hashnr(). Strings that differ only in
+  trailing spaces are equal if the key part has HA_END_SPACE_ARE_EQUAL
+  set, as have the group keys of temporary tables.
 
   @retval TRUE  keys in the buffers are NOT equal
   @retval FALSE keys in the buffers are equal
@@ -889,14 +891,22 @@ bool key_buf_cmp(KEY *key_info, uint used_key_parts,
       {
         uint char_length1= my_charpos(cs, pos1 + pack_length,
                                       pos1 + pack_length + length1,
-                                      length1 / cs->mbmaxlen);
+                                      key_part->length / cs->mbmaxlen);
         uint char_length2= my_charpos(cs, pos2 + pack_length,
                                       pos2 + pack_length + length2,
-                                      length2 / cs->mbmaxlen);
+                                      key_part->length / cs->mbmaxlen);
         set_if_smaller(length1, char_length1);
         set_if_smaller(length2, char_length2);
       }
-      if (length1 != length2 ||
+      if (key_part->key_part_flag & HA_END_SPACE_ARE_EQUAL)
+      {
+        if (cs->coll->strnncollsp(cs,
+                                  pos1 + pack_length, length1,
+                                  pos2 + pack_length, length2,
+                                  0))
+          return TRUE;
+      }
+      else if (length1 != length2 ||
           cs->coll->strnncollsp(cs,
                                 pos1 + pack_length, byte_len1,
                                 pos2 + pack_length, byte_len2,
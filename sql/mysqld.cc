@@ -348,6 +348,7 @@ static my_bool opt_short_log_format= 0;
 static uint kill_cached_threads, wake_thread;
 ulong max_used_connections;
 static volatile ulong cached_thread_count= 0;
+static volatile ulong cached_connection_count= 0;
 static char *mysqld_user, *mysqld_chroot;
 static char *default_character_set_name;
 static char *character_set_filesystem_name;
@@ -358,6 +359,7 @@ static char *default_collation_name;
 char *default_storage_engine;
 static char compiled_default_collation_name[]= MYSQL_DEFAULT_COLLATION_NAME;
 static I_List<THD> thread_cache;
+static I_List<THD> connection_cache;
 static bool binlog_format_used= false;
 LEX_STRING opt_init_connect, opt_init_slave;
 static mysql_cond_t COND_thread_cache, COND_flush_thread_cache;
@@ -485,6 +487,8 @@ ulong slave_run_triggers_for_rbr= 0;
 ulong slave_ddl_exec_mode_options= SLAVE_EXEC_MODE_IDEMPOTENT;
 ulonglong slave_type_conversions_options;
 ulong thread_cache_size=0;
+ulong connection_cache_size=0;
+uint acceptor_threads= 1;
 ulonglong binlog_cache_size=0;
 ulonglong max_binlog_cache_size=0;
 ulong slave_max_allowed_packet= 0;
@@ -507,6 +511,7 @@ ulong specialflag=0;
 ulong binlog_cache_use= 0, binlog_cache_disk_use= 0;
 ulong binlog_stmt_cache_use= 0, binlog_stmt_cache_disk_use= 0;
 ulong max_connections, max_connect_errors;
+ulong net_compression_level;
 ulong extra_max_connections;
 ulong slave_retried_transactions;
 ulonglong denied_connections;
@@ -539,6 +544,11 @@ ulong max_prepared_stmt_count;
   statements.
 */
 ulong prepared_stmt_count=0;
+/**
+  Limit of the number of threads that help to sort the sort buffers,
+  see max_sort_threads, in all connections together.
+*/
+ulong max_total_sort_threads;
 ulong thread_id=1L,current_pid;
 ulong slow_launch_threads = 0;
 uint sync_binlog_period= 0, sync_relaylog_period= 0,
@@ -843,6 +853,10 @@ PSI_mutex_key key_PAGE_lock, key_LOCK_sync, key_LOCK_active, key_LOCK_pool,
 PSI_mutex_key key_LOCK_des_key_file;
 #endif /* HAVE_OPENSSL */
 
+#ifdef HAVE_LIBWRAP
+static PSI_mutex_key key_LOCK_libwrap;
+#endif /* HAVE_LIBWRAP */
+
 PSI_mutex_key key_BINLOG_LOCK_index, key_BINLOG_LOCK_xid_list,
   key_BINLOG_LOCK_binlog_background_thread,
   key_delayed_insert_mutex, key_hash_filo_lock, key_LOCK_active_mi,
@@ -866,6 +880,7 @@ PSI_mutex_key key_BINLOG_LOCK_index, key_BINLOG_LOCK_xid_list,
 PSI_mutex_key key_RELAYLOG_LOCK_index;
 PSI_mutex_key key_LOCK_slave_state, key_LOCK_binlog_state,
   key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry;
+PSI_mutex_key key_LOCK_sort_threads;
 
 PSI_mutex_key key_LOCK_stats,
   key_LOCK_global_user_client_stats, key_LOCK_global_table_stats,
@@ -890,6 +905,10 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_des_key_file, "LOCK_des_key_file", PSI_FLAG_GLOBAL},
 #endif /* HAVE_OPENSSL */
 
+#ifdef HAVE_LIBWRAP
+  { &key_LOCK_libwrap, "LOCK_libwrap", PSI_FLAG_GLOBAL},
+#endif /* HAVE_LIBWRAP */
+
   { &key_BINLOG_LOCK_index, "MYSQL_BIN_LOG::LOCK_index", 0},
   { &key_BINLOG_LOCK_xid_list, "MYSQL_BIN_LOG::LOCK_xid_list", 0},
   { &key_BINLOG_LOCK_binlog_background_thread, "MYSQL_BIN_LOG::LOCK_binlog_background_thread", 0},
@@ -944,7 +963,8 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_binlog_state, "LOCK_binlog_state", 0},
   { &key_LOCK_rpl_thread, "LOCK_rpl_thread", 0},
   { &key_LOCK_rpl_thread_pool, "LOCK_rpl_thread_pool", 0},
-  { &key_LOCK_parallel_entry, "LOCK_parallel_entry", 0}
+  { &key_LOCK_parallel_entry, "LOCK_parallel_entry", 0},
+  { &key_LOCK_sort_threads, "Sort_threads::LOCK_sort_threads", 0}
 };
 
 PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
@@ -992,6 +1012,7 @@ PSI_cond_key key_COND_rpl_thread_queue, key_COND_rpl_thread,
   key_COND_parallel_entry, key_COND_group_commit_orderer,
   key_COND_prepare_ordered;
 PSI_cond_key key_COND_wait_gtid, key_COND_gtid_ignore_duplicates;
+PSI_cond_key key_COND_sort_job, key_COND_sort_job_done;
 
 static PSI_cond_info all_server_conds[]=
 {
@@ -1040,13 +1061,15 @@ static PSI_cond_info all_server_conds[]=
   { &key_COND_group_commit_orderer, "COND_group_commit_orderer", 0},
   { &key_COND_prepare_ordered, "COND_prepare_ordered", 0},
   { &key_COND_wait_gtid, "COND_wait_gtid", 0},
-  { &key_COND_gtid_ignore_duplicates, "COND_gtid_ignore_duplicates", 0}
+  { &key_COND_gtid_ignore_duplicates, "COND_gtid_ignore_duplicates", 0},
+  { &key_COND_sort_job, "Sort_threads::COND_sort_job", 0},
+  { &key_COND_sort_job_done, "Sort_threads::COND_sort_job_done", 0}
 };
 
-PSI_thread_key key_thread_bootstrap, key_thread_delayed_insert,
-  key_thread_handle_manager, key_thread_main,
+PSI_thread_key key_thread_acceptor, key_thread_bootstrap,
+  key_thread_delayed_insert, key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
-  key_thread_slave_init, key_rpl_parallel_thread;
+  key_thread_slave_init, key_rpl_parallel_thread, key_thread_sort;
 
 static PSI_thread_info all_server_threads[]=
 {
@@ -1066,6 +1089,7 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_handle_shutdown, "shutdown", PSI_FLAG_GLOBAL},
 #endif /* __WIN__ */
 
+  { &key_thread_acceptor, "acceptor", PSI_FLAG_GLOBAL},
   { &key_thread_bootstrap, "bootstrap", PSI_FLAG_GLOBAL},
   { &key_thread_delayed_insert, "delayed_insert", 0},
   { &key_thread_handle_manager, "manager", PSI_FLAG_GLOBAL},
@@ -1073,7 +1097,8 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_one_connection, "one_connection", 0},
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_slave_init, "slave_init", PSI_FLAG_GLOBAL},
-  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0}
+  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0},
+  { &key_thread_sort, "sort", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -1167,6 +1192,10 @@ void init_net_server_extension(THD *thd)
   thd->m_net_server_extension.m_user_data= thd;
   thd->m_net_server_extension.m_before_header= net_before_header_psi;
   thd->m_net_server_extension.m_after_header= net_after_header_psi;
+  thd->m_net_server_extension.m_pipelined= FALSE;
+  thd->m_net_server_extension.m_pending= NULL;
+  thd->m_net_server_extension.m_pending_length= 0;
+  thd->m_net_server_extension.m_pending_size= 0;
   /* Activate this private extension for the mysqld server. */
   thd->net.extension= & thd->m_net_server_extension;
 }
@@ -1308,6 +1337,10 @@ void Buffered_logs::print()
 static Buffered_logs buffered_logs;
 
 static MYSQL_SOCKET unix_sock, base_ip_sock, extra_ip_sock;
+/* Sockets of the acceptor threads other than the main thread */
+static MYSQL_SOCKET *acceptor_socks;
+static uint acceptor_sock_count;
+static uint acceptor_threads_in_use;
 struct my_rnd_struct sql_rand; ///< used by sql_class.cc:THD::THD()
 
 #ifndef EMBEDDED_LIBRARY
@@ -1403,9 +1436,12 @@ static const char *current_dbug_option="disabled";
 const char *libwrapName= NULL;
 int allow_severity = LOG_INFO;
 int deny_severity = LOG_WARNING;
+/* tcp_wrappers is not reentrant, but there may be several acceptors */
+static mysql_mutex_t LOCK_libwrap;
 #endif
 #ifdef HAVE_QUERY_CACHE
 ulong query_cache_min_res_unit= QUERY_CACHE_MIN_RESULT_DATA_SIZE;
+uint query_cache_partitions;
 Query_cache query_cache;
 #endif
 #ifdef HAVE_SMEM
@@ -1487,6 +1523,7 @@ static bool pid_file_created= false;
 static void usage(void);
 static void start_signal_handler(void);
 static void close_server_sock();
+static void stop_acceptor_threads();
 static void clean_up_mutexes(void);
 static void wait_for_signal_thread_to_end(void);
 static void create_pid_file();
@@ -1546,6 +1583,7 @@ static void close_connections(void)
   mysql_mutex_unlock(&LOCK_thread_count);
 #endif /* __WIN__ */
 
+  stop_acceptor_threads();
 
   /* Abort listening to new connections */
   DBUG_PRINT("quit",("Closing sockets"));
@@ -1706,6 +1744,8 @@ static void close_connections(void)
   }
   mysql_mutex_unlock(&LOCK_thread_count);
 
+  flush_connection_cache();
+
   DBUG_PRINT("quit",("close_connections thread"));
   DBUG_VOID_RETURN;
 }
@@ -2030,6 +2070,7 @@ void clean_up(bool print_message)
   multi_keycache_free();
   sp_cache_end();
   free_status_vars();
+  free_global_status_slabs();
   end_thr_alarm(1);			/* Free allocated memory */
   my_free_open_file_info();
   if (defaults_argv)
@@ -2131,6 +2172,9 @@ static void clean_up_mutexes()
   mysql_mutex_destroy(&LOCK_global_user_client_stats);
   mysql_mutex_destroy(&LOCK_global_table_stats);
   mysql_mutex_destroy(&LOCK_global_index_stats);
+#ifdef HAVE_LIBWRAP
+  mysql_mutex_destroy(&LOCK_libwrap);
+#endif
 #ifdef HAVE_OPENSSL
   mysql_mutex_destroy(&LOCK_des_key_file);
 #ifndef HAVE_YASSL
@@ -2342,7 +2386,7 @@ static void set_root(const char *path)
    Activate usage of a tcp port
 */
 
-static MYSQL_SOCKET activate_tcp_port(uint port)
+static MYSQL_SOCKET activate_tcp_port(uint port, bool reuse_port= false)
 {
   struct addrinfo *ai, *a;
   struct addrinfo hints;
@@ -2413,6 +2457,23 @@ static MYSQL_SOCKET activate_tcp_port(uint port)
                                  sizeof(arg));
 #endif /* __WIN__ */
 
+#ifdef SO_REUSEPORT
+  /*
+    All sockets of the acceptor threads are bound to the same port, and
+    the kernel spreads the new connections between them.
+  */
+  if (reuse_port)
+  {
+    arg= 1;
+    if (mysql_socket_setsockopt(ip_sock, SOL_SOCKET, SO_REUSEPORT,
+                                (char*)&arg, sizeof(arg)))
+    {
+      sql_perror("Can't start server: setsockopt(SO_REUSEPORT) on TCP/IP port");
+      unireg_abort(1);
+    }
+  }
+#endif
+
 #ifdef IPV6_V6ONLY
    /*
      For interoperability with older clients, IPv6 socket should
@@ -2494,8 +2555,29 @@ static void network_init(void)
 #endif
   if (!opt_disable_networking && !opt_bootstrap)
   {
+#ifndef SO_REUSEPORT
+    if (acceptor_threads > 1)
+    {
+      sql_print_warning("--acceptor-threads is not supported on this "
+                        "platform, using 1");
+      acceptor_threads= 1;
+    }
+#endif
     if (mysqld_port)
-      base_ip_sock= activate_tcp_port(mysqld_port);
+    {
+      base_ip_sock= activate_tcp_port(mysqld_port, acceptor_threads > 1);
+      if (acceptor_threads > 1)
+      {
+        acceptor_socks= (MYSQL_SOCKET*)
+          my_malloc(sizeof(MYSQL_SOCKET) * (acceptor_threads - 1),
+                    MYF(MY_WME | MY_FAE));
+        for (acceptor_sock_count= 0;
+             acceptor_sock_count < acceptor_threads - 1;
+             acceptor_sock_count++)
+          acceptor_socks[acceptor_sock_count]=
+            activate_tcp_port(mysqld_port, true);
+      }
+    }
     if (mysqld_extra_port)
       extra_ip_sock= activate_tcp_port(mysqld_extra_port);
   }
@@ -2696,6 +2778,72 @@ void delete_running_thd(THD *thd)
 }
 
 
+/*
+  Store THD in cache for reuse by a new connection
+
+  SYNOPSIS
+    cache_connection_thd()
+    thd		 Thread handler, already unlinked from the list of threads
+
+  NOTES
+    LOCK_thread_cache is used to protect the cache variables
+
+  RETURN
+    0  THD was not put in cache, caller should delete it
+    1  THD is cached
+*/
+
+static bool cache_connection_thd(THD *thd)
+{
+  DBUG_ENTER("cache_connection_thd");
+
+  if (cached_connection_count >= connection_cache_size ||
+      thd->system_thread != NON_SYSTEM_THREAD || thd->slave_thread)
+    DBUG_RETURN(0);
+
+  thd->free_connection();
+
+  mysql_mutex_lock(&LOCK_thread_cache);
+  if (cached_connection_count < connection_cache_size && !abort_loop)
+  {
+    connection_cache.push_back(thd);
+    cached_connection_count++;
+    mysql_mutex_unlock(&LOCK_thread_cache);
+    DBUG_RETURN(1);
+  }
+  mysql_mutex_unlock(&LOCK_thread_cache);
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Get a THD for a new connection, from the connection cache if possible
+
+  RETURN
+    0    Out of memory
+    #    THD ready for a new connection
+*/
+
+static THD *get_connection_thd()
+{
+  THD *thd= 0;
+  DBUG_ENTER("get_connection_thd");
+
+  if (cached_connection_count)
+  {
+    mysql_mutex_lock(&LOCK_thread_cache);
+    if ((thd= connection_cache.get()))
+      cached_connection_count--;
+    mysql_mutex_unlock(&LOCK_thread_cache);
+  }
+  if (thd)
+    thd->reset_for_reuse();
+  else
+    thd= new THD;
+  DBUG_RETURN(thd);
+}
+
+
 /*
   Unlink thd from global list of available connections and free thd
 
@@ -2727,7 +2875,8 @@ void unlink_thd(THD *thd)
   DBUG_EXECUTE_IF("sleep_after_lock_thread_count_before_delete_thd", sleep(5););
   mysql_mutex_unlock(&LOCK_thread_count);
 
-  delete thd;
+  if (!cache_connection_thd(thd))
+    delete thd;
   thread_safe_decrement32(&thread_count, &thread_count_lock);
 
   DBUG_VOID_RETURN;
@@ -2884,6 +3033,23 @@ void flush_thread_cache()
 }
 
 
+void flush_connection_cache()
+{
+  THD *thd;
+  DBUG_ENTER("flush_connection_cache");
+  mysql_mutex_lock(&LOCK_thread_cache);
+  while ((thd= connection_cache.get()))
+  {
+    cached_connection_count--;
+    mysql_mutex_unlock(&LOCK_thread_cache);
+    delete thd;
+    mysql_mutex_lock(&LOCK_thread_cache);
+  }
+  mysql_mutex_unlock(&LOCK_thread_cache);
+  DBUG_VOID_RETURN;
+}
+
+
 /******************************************************************************
   Setup a signal thread with handles all signals.
   Because Linux doesn't support schemas use a mutex to check that
@@ -3868,6 +4034,9 @@ static int init_common_variables()
   set_current_thd(0);
   set_malloc_size_cb(my_malloc_size_cb_func);
 
+  if (init_global_status_slabs())
+    return 1;
+
   init_libstrings();
   tzset();			// Set tzname
 
@@ -4373,6 +4542,9 @@ static int init_thread_environment()
   mysql_mutex_init(key_LOCK_commit_ordered, &LOCK_commit_ordered,
                    MY_MUTEX_INIT_SLOW);
 
+#ifdef HAVE_LIBWRAP
+  mysql_mutex_init(key_LOCK_libwrap, &LOCK_libwrap, MY_MUTEX_INIT_FAST);
+#endif
 #ifdef HAVE_OPENSSL
   mysql_mutex_init(key_LOCK_des_key_file,
                    &LOCK_des_key_file, MY_MUTEX_INIT_FAST);
@@ -6004,19 +6176,234 @@ inline void kill_broken_server()
 
 #ifndef EMBEDDED_LIBRARY
 
+/*
+  Create the THD for a connection accepted on a listening socket and
+  start a thread (or the scheduler) to handle it
+
+  SYNOPSIS
+    handle_accepted_socket()
+    sock          Listening socket the connection was accepted on
+    new_sock      Socket of the new connection
+*/
+
+static void handle_accepted_socket(MYSQL_SOCKET sock, MYSQL_SOCKET new_sock)
+{
+  THD *thd;
+  st_vio *vio_tmp;
+  bool is_unix_sock;
+  DBUG_ENTER("handle_accepted_socket");
+
+#ifdef HAVE_LIBWRAP
+  {
+    if (mysql_socket_getfd(sock) != mysql_socket_getfd(unix_sock))
+    {
+      struct request_info req;
+      mysql_mutex_lock(&LOCK_libwrap);
+      signal(SIGCHLD, SIG_DFL);
+      request_init(&req, RQ_DAEMON, libwrapName, RQ_FILE,
+                   mysql_socket_getfd(new_sock), NULL);
+      my_fromhost(&req);
+      if (!my_hosts_access(&req))
+      {
+        /*
+          This may be stupid but refuse() includes an exit(0)
+          which we surely don't want...
+          clean_exit() - same stupid thing ...
+        */
+        syslog(deny_severity, "refused connect from %s",
+               my_eval_client(&req));
+
+        /*
+          C++ sucks (the gibberish in front just translates the supplied
+          sink function pointer in the req structure from a void (*sink)();
+          to a void(*sink)(int) if you omit the cast, the C++ compiler
+          will cry...
+        */
+        if (req.sink)
+          ((void (*)(int))req.sink)(req.fd);
+        mysql_mutex_unlock(&LOCK_libwrap);
+
+        (void) mysql_socket_shutdown(new_sock, SHUT_RDWR);
+        (void) mysql_socket_close(new_sock);
+        /*
+          The connection was refused by TCP wrappers.
+          There are no details (by client IP) available to update the host_cache.
+        */
+        statistic_increment(connection_tcpwrap_errors, &LOCK_status);
+        DBUG_VOID_RETURN;
+      }
+      mysql_mutex_unlock(&LOCK_libwrap);
+    }
+  }
+#endif /* HAVE_LIBWRAP */
+
+  /*
+  ** Don't allow too many connections
+  */
+
+  DBUG_PRINT("info", ("Creating THD for new connection"));
+  if (!(thd= get_connection_thd()))
+  {
+    (void) mysql_socket_shutdown(new_sock, SHUT_RDWR);
+    (void) mysql_socket_close(new_sock);
+    statistic_increment(connection_errors_internal, &LOCK_status);
+    DBUG_VOID_RETURN;
+  }
+  /* Set to get io buffers to be part of THD */
+  set_current_thd(thd);
+
+  is_unix_sock= (mysql_socket_getfd(sock) ==
+                 mysql_socket_getfd(unix_sock));
+
+  if (!(vio_tmp=
+        mysql_socket_vio_new(new_sock,
+                             is_unix_sock ? VIO_TYPE_SOCKET : VIO_TYPE_TCPIP,
+                             is_unix_sock ? VIO_LOCALHOST: 0)) ||
+      my_net_init(&thd->net, vio_tmp, MYF(MY_THREAD_SPECIFIC)))
+  {
+    /*
+      Only delete the temporary vio if we didn't already attach it to the
+      NET object. The destructor in THD will delete any initialized net
+      structure.
+    */
+    if (vio_tmp && thd->net.vio != vio_tmp)
+      vio_delete(vio_tmp);
+    else
+    {
+      (void) mysql_socket_shutdown(new_sock, SHUT_RDWR);
+      (void) mysql_socket_close(new_sock);
+    }
+    delete thd;
+    set_current_thd(0);
+    statistic_increment(connection_errors_internal, &LOCK_status);
+    DBUG_VOID_RETURN;
+  }
+
+  init_net_server_extension(thd);
+  if (is_unix_sock)
+    thd->security_ctx->host=(char*) my_localhost;
+
+  if (mysql_socket_getfd(sock) == mysql_socket_getfd(extra_ip_sock))
+  {
+    thd->extra_port= 1;
+    thd->scheduler= extra_thread_scheduler;
+  }
+  create_new_thread(thd);
+  set_current_thd(0);
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Accept connections on one of the sockets of --acceptor-threads
+
+  NOTES
+    The main thread polls the other listening sockets in
+    handle_connections_sockets(). This thread only has its own socket,
+    so it simply blocks in accept() until stop_acceptor_threads() shuts
+    the socket down.
+*/
+
+pthread_handler_t handle_connections_acceptor(void *arg)
+{
+  MYSQL_SOCKET sock= *(MYSQL_SOCKET*) arg;
+  MYSQL_SOCKET new_sock;
+  struct sockaddr_storage cAddr;
+  uint error_count= 0;
+
+  my_thread_init();
+  DBUG_ENTER("handle_connections_acceptor");
+  mysql_socket_set_thread_owner(sock);
+
+  while (!abort_loop)
+  {
+    size_socket length= sizeof(struct sockaddr_storage);
+    new_sock= mysql_socket_accept(key_socket_client_connection, sock,
+                                  (struct sockaddr *)(&cAddr), &length);
+    if (abort_loop)
+    {
+      if (mysql_socket_getfd(new_sock) != INVALID_SOCKET)
+        (void) mysql_socket_close(new_sock);
+      break;
+    }
+    if (mysql_socket_getfd(new_sock) == INVALID_SOCKET)
+    {
+      if (socket_errno == SOCKET_EINTR || socket_errno == SOCKET_EAGAIN)
+        continue;
+      statistic_increment(connection_errors_accept, &LOCK_status);
+      if ((error_count++ & 255) == 0)		// This can happen often
+        sql_perror("Error in accept");
+      if (socket_errno == SOCKET_ENFILE || socket_errno == SOCKET_EMFILE)
+        sleep(1);				// Give other threads some time
+      continue;
+    }
+    handle_accepted_socket(sock, new_sock);
+  }
+
+  mysql_mutex_lock(&LOCK_thread_count);
+  acceptor_threads_in_use--;
+  mysql_cond_broadcast(&COND_thread_count);
+  mysql_mutex_unlock(&LOCK_thread_count);
+  DBUG_LEAVE;
+  my_thread_end();
+  pthread_exit(0);
+  return 0;
+}
+
+
+static void start_acceptor_threads()
+{
+  pthread_t hThread;
+  DBUG_ENTER("start_acceptor_threads");
+  mysql_mutex_lock(&LOCK_thread_count);
+  for (uint i= 0; i < acceptor_sock_count; i++)
+  {
+    if (mysql_thread_create(key_thread_acceptor, &hThread, &connection_attrib,
+                            handle_connections_acceptor, &acceptor_socks[i]))
+    {
+      sql_print_warning("Can't create acceptor thread (errno= %d), "
+                        "not accepting connections on socket %u of %u",
+                        errno, i + 2, acceptor_threads);
+      continue;
+    }
+    acceptor_threads_in_use++;
+  }
+  mysql_mutex_unlock(&LOCK_thread_count);
+  DBUG_VOID_RETURN;
+}
+
+
+static void stop_acceptor_threads()
+{
+  DBUG_ENTER("stop_acceptor_threads");
+  /* Makes accept() fail in the acceptor threads */
+  for (uint i= 0; i < acceptor_sock_count; i++)
+    (void) mysql_socket_shutdown(acceptor_socks[i], SHUT_RDWR);
+
+  mysql_mutex_lock(&LOCK_thread_count);
+  while (acceptor_threads_in_use)
+    mysql_cond_wait(&COND_thread_count, &LOCK_thread_count);
+  mysql_mutex_unlock(&LOCK_thread_count);
+
+  for (uint i= 0; i < acceptor_sock_count; i++)
+    (void) mysql_socket_close(acceptor_socks[i]);
+  acceptor_sock_count= 0;
+  my_free(acceptor_socks);
+  acceptor_socks= 0;
+  DBUG_VOID_RETURN;
+}
+
+
 void handle_connections_sockets()
 {
   MYSQL_SOCKET sock= mysql_socket_invalid();
   MYSQL_SOCKET new_sock= mysql_socket_invalid();
   uint error_count=0;
-  THD *thd;
   struct sockaddr_storage cAddr;
   int ip_flags __attribute__((unused))=0;
   int socket_flags __attribute__((unused))= 0;
   int extra_ip_flags __attribute__((unused))=0;
   int flags=0,retval;
-  st_vio *vio_tmp;
-  bool is_unix_sock;
 #ifdef HAVE_POLL
   int socket_count= 0;
   struct pollfd fds[3]; // for ip_sock, unix_sock and extra_ip_sock
@@ -6050,6 +6437,8 @@ void handle_connections_sockets()
   socket_flags=fcntl(mysql_socket_getfd(unix_sock), F_GETFL, 0);
 #endif
 
+  start_acceptor_threads();
+
   DBUG_PRINT("general",("Waiting for connections."));
   MAYBE_BROKEN_SYSCALL;
   while (!abort_loop)
@@ -6165,101 +6554,7 @@ void handle_connections_sockets()
       continue;
     }
 
-#ifdef HAVE_LIBWRAP
-    {
-      if (mysql_socket_getfd(sock) == mysql_socket_getfd(base_ip_sock) ||
-          mysql_socket_getfd(sock) == mysql_socket_getfd(extra_ip_sock))
-      {
-	struct request_info req;
-	signal(SIGCHLD, SIG_DFL);
-	request_init(&req, RQ_DAEMON, libwrapName, RQ_FILE,
-                     mysql_socket_getfd(new_sock), NULL);
-	my_fromhost(&req);
-	if (!my_hosts_access(&req))
-	{
-	  /*
-	    This may be stupid but refuse() includes an exit(0)
-	    which we surely don't want...
-	    clean_exit() - same stupid thing ...
-	  */
-	  syslog(deny_severity, "refused connect from %s",
-		 my_eval_client(&req));
-
-	  /*
-	    C++ sucks (the gibberish in front just translates the supplied
-	    sink function pointer in the req structure from a void (*sink)();
-	    to a void(*sink)(int) if you omit the cast, the C++ compiler
-	    will cry...
-	  */
-	  if (req.sink)
-	    ((void (*)(int))req.sink)(req.fd);
-
-	  (void) mysql_socket_shutdown(new_sock, SHUT_RDWR);
-	  (void) mysql_socket_close(new_sock);
-          /*
-            The connection was refused by TCP wrappers.
-            There are no details (by client IP) available to update the host_cache.
-          */
-          statistic_increment(connection_tcpwrap_errors, &LOCK_status);
-	  continue;
-	}
-      }
-    }
-#endif /* HAVE_LIBWRAP */
-
-    /*
-    ** Don't allow too many connections
-    */
-
-    DBUG_PRINT("info", ("Creating THD for new connection"));
-    if (!(thd= new THD))
-    {
-      (void) mysql_socket_shutdown(new_sock, SHUT_RDWR);
-      (void) mysql_socket_close(new_sock);
-      statistic_increment(connection_errors_internal, &LOCK_status);
-      continue;
-    }
-    /* Set to get io buffers to be part of THD */
-    set_current_thd(thd);
-
-    is_unix_sock= (mysql_socket_getfd(sock) ==
-                   mysql_socket_getfd(unix_sock));
-
-    if (!(vio_tmp=
-          mysql_socket_vio_new(new_sock,
-                               is_unix_sock ? VIO_TYPE_SOCKET : VIO_TYPE_TCPIP,
-                               is_unix_sock ? VIO_LOCALHOST: 0)) ||
-	my_net_init(&thd->net, vio_tmp, MYF(MY_THREAD_SPECIFIC)))
-    {
-      /*
-        Only delete the temporary vio if we didn't already attach it to the
-        NET object. The destructor in THD will delete any initialized net
-        structure.
-      */
-      if (vio_tmp && thd->net.vio != vio_tmp)
-        vio_delete(vio_tmp);
-      else
-      {
-	(void) mysql_socket_shutdown(new_sock, SHUT_RDWR);
-	(void) mysql_socket_close(new_sock);
-      }
-      delete thd;
-      set_current_thd(0);
-      statistic_increment(connection_errors_internal, &LOCK_status);
-      continue;
-    }
-
-    init_net_server_extension(thd);
-    if (is_unix_sock)
-      thd->security_ctx->host=(char*) my_localhost;
-
-    if (mysql_socket_getfd(sock) == mysql_socket_getfd(extra_ip_sock))
-    {
-      thd->extra_port= 1;
-      thd->scheduler= extra_thread_scheduler;
-    }
-    create_new_thread(thd);
-    set_current_thd(0);
+    handle_accepted_socket(sock, new_sock);
   }
   DBUG_VOID_RETURN;
 }
@@ -7120,7 +7415,6 @@ struct my_option my_long_options[]=
   MYSQL_TO_BE_IMPLEMENTED_OPTION("eq-range-index-dive-limit"),
   MYSQL_COMPATIBILITY_OPTION("server-id-bits"),
   MYSQL_TO_BE_IMPLEMENTED_OPTION("slave-rows-search-algorithms"), // HAVE_REPLICATION
-  MYSQL_COMPATIBILITY_OPTION("table-open-cache-instances"),
   MYSQL_TO_BE_IMPLEMENTED_OPTION("slave-allow-batching"),         // HAVE_REPLICATION
   MYSQL_COMPATIBILITY_OPTION("slave-checkpoint-period"),      // HAVE_REPLICATION
   MYSQL_COMPATIBILITY_OPTION("slave-checkpoint-group"),       // HAVE_REPLICATION
@@ -7709,6 +8003,51 @@ static int show_default_keycache(THD *thd, SHOW_VAR *var, char *buff)
   return 0;
 }
 
+#ifdef HAVE_QUERY_CACHE
+/* The counters of all partitions of the query cache added up */
+
+static int show_query_cache(THD *thd, SHOW_VAR *var, char *buff)
+{
+  struct st_data {
+    Query_cache_statistics stats;
+    SHOW_VAR var[9];
+  } *data;
+  SHOW_VAR *v;
+
+  data=(st_data *)buff;
+  v= data->var;
+
+  var->type= SHOW_ARRAY;
+  var->value= (char*)v;
+
+  bzero(&data->stats, sizeof(data->stats));
+  query_cache.get_statistics(&data->stats);
+
+#define set_one_qcache_var(X,Y)         \
+  v->name= X;                           \
+  v->type= SHOW_LONG_NOFLUSH;           \
+  v->value= (char*)&data->stats.Y;      \
+  v++;
+
+  set_one_qcache_var("free_blocks",      free_memory_blocks);
+  set_one_qcache_var("free_memory",      free_memory);
+  set_one_qcache_var("hits",             hits);
+  set_one_qcache_var("inserts",          inserts);
+  set_one_qcache_var("lowmem_prunes",    lowmem_prunes);
+  set_one_qcache_var("not_cached",       refused);
+  set_one_qcache_var("queries_in_cache", queries_in_cache);
+  set_one_qcache_var("total_blocks",     total_blocks);
+
+  v->name= 0;
+
+  DBUG_ASSERT((char*)(v+1) <= buff + SHOW_VAR_FUNC_BUFF_SIZE);
+
+#undef set_one_qcache_var
+
+  return 0;
+}
+#endif /*HAVE_QUERY_CACHE*/
+
 #ifndef DBUG_OFF
 static int debug_status_func(THD *thd, SHOW_VAR *var, char *buff)
 {
@@ -7774,6 +8113,7 @@ SHOW_VAR status_vars[]= {
   {"Com",                      (char*) com_status_vars, SHOW_ARRAY},
   {"Compression",              (char*) &show_net_compression, SHOW_SIMPLE_FUNC},
   {"Connections",              (char*) &thread_id,              SHOW_LONG_NOFLUSH},
+  {"Connections_cached",       (char*) &cached_connection_count, SHOW_LONG_NOFLUSH},
   {"Connection_errors_accept", (char*) &connection_errors_accept, SHOW_LONG},
   {"Connection_errors_internal", (char*) &connection_errors_internal, SHOW_LONG},
   {"Connection_errors_max_connections", (char*) &connection_errors_max_connection, SHOW_LONG},
@@ -7831,6 +8171,7 @@ SHOW_VAR status_vars[]= {
   {"Last_query_cost",          (char*) offsetof(STATUS_VAR, last_query_cost), SHOW_DOUBLE_STATUS},
   {"Max_used_connections",     (char*) &max_used_connections,  SHOW_LONG},
   {"Memory_used",              (char*) offsetof(STATUS_VAR, memory_used), SHOW_LONGLONG_STATUS},
+  {"Normalized_stmt_cache_hits", (char*) offsetof(STATUS_VAR, normalized_stmt_cache_hits), SHOW_LONG_STATUS},
   {"Not_flushed_delayed_rows", (char*) &delayed_rows_in_use,    SHOW_LONG_NOFLUSH},
   {"Open_files",               (char*) &my_file_opened,         SHOW_LONG_NOFLUSH},
   {"Open_streams",             (char*) &my_stream_opened,       SHOW_LONG_NOFLUSH},
@@ -7842,18 +8183,12 @@ SHOW_VAR status_vars[]= {
   {"Opened_tables",            (char*) offsetof(STATUS_VAR, opened_tables), SHOW_LONG_STATUS},
   {"Opened_views",             (char*) offsetof(STATUS_VAR, opened_views), SHOW_LONG_STATUS},
   {"Prepared_stmt_count",      (char*) &show_prepared_stmt_count, SHOW_SIMPLE_FUNC},
+  {"Prepared_stmt_plan_cache_hits", (char*) offsetof(STATUS_VAR, ps_plan_cache_hits), SHOW_LONG_STATUS},
   {"Rows_sent",                (char*) offsetof(STATUS_VAR, rows_sent), SHOW_LONGLONG_STATUS},
   {"Rows_read",                (char*) offsetof(STATUS_VAR, rows_read), SHOW_LONGLONG_STATUS},
   {"Rows_tmp_read",            (char*) offsetof(STATUS_VAR, rows_tmp_read), SHOW_LONGLONG_STATUS},
 #ifdef HAVE_QUERY_CACHE
-  {"Qcache_free_blocks",       (char*) &query_cache.free_memory_blocks, SHOW_LONG_NOFLUSH},
-  {"Qcache_free_memory",       (char*) &query_cache.free_memory, SHOW_LONG_NOFLUSH},
-  {"Qcache_hits",              (char*) &query_cache.hits,       SHOW_LONG},
-  {"Qcache_inserts",           (char*) &query_cache.inserts,    SHOW_LONG},
-  {"Qcache_lowmem_prunes",     (char*) &query_cache.lowmem_prunes, SHOW_LONG},
-  {"Qcache_not_cached",        (char*) &query_cache.refused,    SHOW_LONG},
-  {"Qcache_queries_in_cache",  (char*) &query_cache.queries_in_cache, SHOW_LONG_NOFLUSH},
-  {"Qcache_total_blocks",      (char*) &query_cache.total_blocks, SHOW_LONG_NOFLUSH},
+  {"Qcache",                   (char*) &show_query_cache,       SHOW_FUNC},
 #endif /*HAVE_QUERY_CACHE*/
   {"Queries",                  (char*) &show_queries,            SHOW_SIMPLE_FUNC},
   {"Questions",                (char*) offsetof(STATUS_VAR, questions), SHOW_LONG_STATUS},
@@ -7875,6 +8210,7 @@ SHOW_VAR status_vars[]= {
   {"Slow_launch_threads",      (char*) &slow_launch_threads,    SHOW_LONG},
   {"Slow_queries",             (char*) offsetof(STATUS_VAR, long_query_count), SHOW_LONG_STATUS},
   {"Sort_merge_passes",	       (char*) offsetof(STATUS_VAR, filesort_merge_passes_), SHOW_LONG_STATUS},
+  {"Sort_radix",	       (char*) offsetof(STATUS_VAR, filesort_radix_count_), SHOW_LONG_STATUS},
   {"Sort_range",	       (char*) offsetof(STATUS_VAR, filesort_range_count_), SHOW_LONG_STATUS},
   {"Sort_rows",		       (char*) offsetof(STATUS_VAR, filesort_rows_), SHOW_LONG_STATUS},
   {"Sort_scan",		       (char*) offsetof(STATUS_VAR, filesort_scan_count_), SHOW_LONG_STATUS},
@@ -9274,7 +9610,7 @@ void refresh_status(THD *thd)
   mysql_mutex_lock(&LOCK_status);
 
   /* Add thread's status variabes to global status */
-  add_to_status(&global_status_var, &thd->status_var);
+  thd->add_status_to_global();
 
   /* Reset thread's status variables */
   thd->set_status_var_init();
@@ -9286,6 +9622,9 @@ void refresh_status(THD *thd)
 
   /* Reset the counters of all key caches (default and named). */
   process_key_caches(reset_key_cache_counters, 0);
+#ifdef HAVE_QUERY_CACHE
+  query_cache.reset_statistics();
+#endif
   flush_status_time= time((time_t*) 0);
   mysql_mutex_unlock(&LOCK_status);
 
@@ -118,7 +118,13 @@ extern void query_cache_insert(const char *packet, ulong length,
 #endif
 
 #define TEST_BLOCKING		8
-#define MAX_PACKET_LENGTH (256L*256L*256L-1)
+/*
+  Most data put in one packet with CLIENT_EXT_COMPRESS_STREAM, chosen so
+  that even incompressible data stays below MAX_PACKET_LENGTH once deflated
+*/
+#define MAX_COMPRESS_STREAM_CHUNK \
+  (MAX_PACKET_LENGTH - (MY_COMPRESS_STREAM_BOUND(MAX_PACKET_LENGTH) - \
+                        MAX_PACKET_LENGTH))
 
 static my_bool net_write_buff(NET *, const uchar *, ulong);
 
@@ -143,7 +149,7 @@ my_bool my_net_init(NET *net, Vio* vio, uint my_flags)
   net->where_b = net->remain_in_buf=0;
   net->net_skip_rest_factor= 0;
   net->last_errno=0;
-  net->unused= 0;
+  net->compress_stream= 0;
   net->thread_specific_malloc= MY_TEST(my_flags & MY_THREAD_SPECIFIC);
 #ifdef MYSQL_SERVER
   net->extension= NULL;
@@ -171,6 +177,20 @@ void net_end(NET *net)
   DBUG_ENTER("net_end");
   my_free(net->buff);
   net->buff=0;
+#ifdef HAVE_COMPRESS
+  my_compress_stream_free((MY_COMPRESS_STREAM*) net->compress_stream);
+  net->compress_stream= 0;
+#endif
+#ifdef MYSQL_SERVER
+  if (net->extension)
+  {
+    struct st_net_server *server_extension=
+      static_cast<st_net_server*> (net->extension);
+    my_free(server_extension->m_pending);
+    server_extension->m_pending= 0;
+    server_extension->m_pending_length= server_extension->m_pending_size= 0;
+  }
+#endif
   DBUG_VOID_RETURN;
 }
 
@@ -219,6 +239,66 @@ my_bool net_realloc(NET *net, size_t length)
 }
 
 
+#ifdef MYSQL_SERVER
+
+/**
+  Grow the packet buffer, keeping the data that is waiting to be sent.
+
+  Used by the server to send large result sets with fewer writes.
+  Not done with the compressed protocol, as there the buffer may hold
+  data that is read ahead.
+
+  @retval 0  ok
+  @retval 1  the buffer could not be grown, it is left as it was
+*/
+
+my_bool net_extend_write_buffer(NET *net, size_t length)
+{
+  uchar *buff;
+  size_t pkt_length= (length+IO_SIZE-1) & ~(IO_SIZE-1);
+  DBUG_ENTER("net_extend_write_buffer");
+  DBUG_PRINT("enter",("length: %lu", (ulong) length));
+
+  if (net->compress || pkt_length <= net->max_packet)
+    DBUG_RETURN(1);
+  if (!(buff= (uchar*) my_realloc((char*) net->buff, pkt_length +
+                                  NET_HEADER_SIZE + COMP_HEADER_SIZE + 1,
+                                  MYF(net->thread_specific_malloc ?
+                                      MY_THREAD_SPECIFIC : 0))))
+    DBUG_RETURN(1);
+  net->write_pos= buff + (net->write_pos - net->buff);
+  net->read_pos= buff + (net->read_pos - net->buff);
+  net->buff= buff;
+  net->buff_end= buff + (net->max_packet= (ulong) pkt_length);
+  DBUG_RETURN(0);
+}
+
+
+/**
+  Shrink the packet buffer after a command, to reclaim the memory of
+  big packets and result sets.
+*/
+
+void net_shrink_buffer(NET *net, size_t length)
+{
+  uchar *buff;
+  size_t pkt_length= (length+IO_SIZE-1) & ~(IO_SIZE-1);
+
+  if (net->compress || net->write_pos != net->buff ||
+      pkt_length >= net->max_packet)
+    return;
+  if (!(buff= (uchar*) my_realloc((char*) net->buff, pkt_length +
+                                  NET_HEADER_SIZE + COMP_HEADER_SIZE + 1,
+                                  MYF(net->thread_specific_malloc ?
+                                      MY_THREAD_SPECIFIC : 0))))
+    return;
+  net->buff= net->write_pos= net->read_pos= buff;
+  net->buff_end= buff + (net->max_packet= (ulong) pkt_length);
+}
+
+#endif /* MYSQL_SERVER */
+
+
 /**
   Check if there is any data to be read from the socket.
 
@@ -354,12 +434,131 @@ void net_clear(NET *net, my_bool clear_buffer __attribute__((unused)))
 
 /** Flush write_buffer if not empty. */
 
+#ifdef MYSQL_SERVER
+/**
+  Check if the sending of the buffer can wait for the next result.
+
+  This is the case for pipelined commands (CLIENT_EXT_PIPELINE) when the
+  client has already sent the next command: the results are then sent
+  together, when no more commands are waiting. Not done with the
+  compressed protocol, where the packet numbers of the compressed
+  packets start again with every command.
+*/
+
+static my_bool net_next_command_waiting(NET *net)
+{
+  Vio *vio= net->vio;
+
+  if (vio->has_data(vio))
+    return 1;
+  /* Readable and not at end of file */
+  return (vio_io_wait(vio, VIO_IO_EVENT_READ, 0) > 0 &&
+          vio_is_connected(vio));
+}
+
+
+static my_bool net_flush_can_wait(NET *net)
+{
+  struct st_net_server *server_extension=
+    static_cast<st_net_server*> (net->extension);
+
+  if (!server_extension || !server_extension->m_pipelined ||
+      net->compress || !net->vio)
+    return 0;
+  return net_next_command_waiting(net);
+}
+
+
+static my_bool net_reserve_pending(NET *net, size_t length)
+{
+  struct st_net_server *server_extension=
+    static_cast<st_net_server*> (net->extension);
+  uchar *buff;
+
+  if (length <= server_extension->m_pending_size)
+    return 0;
+  if (!(buff= (uchar*) my_realloc(server_extension->m_pending, length,
+                                  MYF(MY_ALLOW_ZERO_PTR |
+                                      (net->thread_specific_malloc ?
+                                       MY_THREAD_SPECIFIC : 0)))))
+    return 1;
+  server_extension->m_pending= buff;
+  server_extension->m_pending_size= length;
+  return 0;
+}
+
+
+/**
+  Keep the data of the write buffer, to send it with the next write.
+
+  The data is moved out of the buffer, as the buffer is also used to
+  read the next command. Up to one buffer of data is kept.
+
+  @retval 0  ok
+  @retval 1  the data must be sent now
+*/
+
+static my_bool net_defer_write(NET *net)
+{
+  struct st_net_server *server_extension=
+    static_cast<st_net_server*> (net->extension);
+  size_t length= (size_t) (net->write_pos - net->buff);
+  size_t pending_length= server_extension->m_pending_length + length;
+
+  if (pending_length > net->max_packet ||
+      net_reserve_pending(net, pending_length))
+    return 1;
+#ifdef USE_QUERY_CACHE
+  query_cache_insert((char*) net->buff, length, net->pkt_nr);
+#endif
+  memcpy(server_extension->m_pending + server_extension->m_pending_length,
+         net->buff, length);
+  server_extension->m_pending_length= pending_length;
+  net->write_pos= net->buff;
+  return 0;
+}
+
+
+/**
+  Send the results kept by net_defer_write() before waiting for the
+  next command.
+
+  They are only kept further if the next command has already arrived,
+  as it may be one that sends nothing, like COM_STMT_CLOSE, and the
+  client would then wait for them forever.
+
+  @retval 0  ok
+  @retval 1  error
+*/
+
+my_bool net_flush_pending(NET *net)
+{
+  struct st_net_server *server_extension=
+    static_cast<st_net_server*> (net->extension);
+  DBUG_ENTER("net_flush_pending");
+
+  if (!server_extension || !server_extension->m_pending_length ||
+      !net->vio || net_next_command_waiting(net))
+    DBUG_RETURN(0);
+  /* net_real_write() sends the kept data first */
+  DBUG_RETURN(MY_TEST(net_real_write(net, net->buff, 0)));
+}
+#endif
+
+
 my_bool net_flush(NET *net)
 {
   my_bool error= 0;
   DBUG_ENTER("net_flush");
   if (net->buff != net->write_pos)
   {
+#ifdef MYSQL_SERVER
+    if (net_flush_can_wait(net) && !net_defer_write(net))
+    {
+      DBUG_PRINT("info", ("Next command is waiting, not flushed"));
+      DBUG_RETURN(0);
+    }
+#endif
     error= MY_TEST(net_real_write(net, net->buff,
                                   (size_t) (net->write_pos - net->buff)));
     net->write_pos= net->buff;
@@ -430,6 +629,34 @@ my_bool my_net_write(NET *net, const uchar *packet, size_t len)
 }
 
 
+#ifdef MYSQL_SERVER
+
+/**
+  Add a packet that the caller has built in place in the write buffer.
+
+  The packet starts NET_HEADER_SIZE bytes after net->write_pos, where
+  its header is stored, so it is not copied as with my_net_write().
+  The packet must be shorter than MAX_PACKET_LENGTH and fit in the
+  buffer.
+*/
+
+void net_write_in_place(NET *net, size_t len)
+{
+  MYSQL_NET_WRITE_START(len);
+  DBUG_ASSERT(len < MAX_PACKET_LENGTH);
+  DBUG_ASSERT(net->write_pos + NET_HEADER_SIZE + len <= net->buff_end);
+  int3store(net->write_pos, len);
+  net->write_pos[3]= (uchar) net->pkt_nr++;
+#ifndef DEBUG_DATA_PACKETS
+  DBUG_DUMP("packet_header", net->write_pos, NET_HEADER_SIZE);
+#endif
+  net->write_pos+= NET_HEADER_SIZE + len;
+  MYSQL_NET_WRITE_DONE(0);
+}
+
+#endif /* MYSQL_SERVER */
+
+
 /**
   Send a command to the server.
 
@@ -609,6 +836,28 @@ net_real_write(NET *net,const uchar *packet, size_t len)
   if (net->error == 2)
     DBUG_RETURN(-1);				/* socket can't be used */
 
+#ifdef MYSQL_SERVER
+  struct st_net_server *server_extension=
+    static_cast<st_net_server*> (net->extension);
+  if (server_extension && server_extension->m_pending_length)
+  {
+    /* Send the results that were kept by net_defer_write() first */
+    size_t pending_length= server_extension->m_pending_length;
+    DBUG_ASSERT(!net->compress);
+    if (net_reserve_pending(net, pending_length + len))
+    {
+      net->error= 2;
+      net->last_errno= ER_OUT_OF_RESOURCES;
+      MYSQL_SERVER_my_error(ER_OUT_OF_RESOURCES, MYF(0));
+      DBUG_RETURN(1);
+    }
+    memcpy(server_extension->m_pending + pending_length, packet, len);
+    packet= server_extension->m_pending;
+    len+= pending_length;
+    server_extension->m_pending_length= 0;
+  }
+#endif
+
   net->reading_or_writing=2;
 #ifdef HAVE_COMPRESS
   if (net->compress)
@@ -616,8 +865,15 @@ net_real_write(NET *net,const uchar *packet, size_t len)
     size_t complen;
     uchar *b;
     uint header_length=NET_HEADER_SIZE+COMP_HEADER_SIZE;
-    if (!(b= (uchar*) my_malloc(len + NET_HEADER_SIZE +
-                                COMP_HEADER_SIZE + 1,
+    MY_COMPRESS_STREAM *stream= (MY_COMPRESS_STREAM*) net->compress_stream;
+    /*
+      A streamed packet is sent as one compressed packet per
+      MAX_COMPRESS_STREAM_CHUNK bytes, each with its own header
+    */
+    size_t chunks= stream ? len / MAX_COMPRESS_STREAM_CHUNK + 1 : 1;
+    if (!(b= (uchar*) my_malloc((stream ? MY_COMPRESS_STREAM_BOUND(len) +
+                                 (chunks - 1) * 64 : len) +
+                                chunks * header_length + 1,
                                 MYF(MY_WME |
                                     (net->thread_specific_malloc ?
                                      MY_THREAD_SPECIFIC : 0)))))
@@ -628,14 +884,48 @@ net_real_write(NET *net,const uchar *packet, size_t len)
       net->reading_or_writing= 0;
       DBUG_RETURN(1);
     }
-    memcpy(b+header_length,packet,len);
-
-    if (my_compress(b+header_length, &len, &complen))
-      complen=0;
-    int3store(&b[NET_HEADER_SIZE],complen);
-    int3store(b,len);
-    b[3]=(uchar) (net->compress_pkt_nr++);
-    len+= header_length;
+    if (stream)
+    {
+      /*
+        Deflate output may be larger than its input, so the data is split
+        in chunks whose compressed length is known to fit in 3 bytes.
+      */
+      uchar *to= b;
+      while (len || to == b)
+      {
+        size_t chunk_length= MY_MIN(len, MAX_COMPRESS_STREAM_CHUNK);
+        size_t out_length= chunk_length;
+        if (my_compress_stream(stream, packet, &out_length,
+                               to + header_length, &complen))
+        {
+          my_free(b);
+          net->error= 2;
+          net->last_errno= ER_OUT_OF_RESOURCES;
+          MYSQL_SERVER_my_error(ER_OUT_OF_RESOURCES, MYF(0));
+          net->reading_or_writing= 0;
+          DBUG_RETURN(1);
+        }
+        DBUG_ASSERT(out_length <= MAX_PACKET_LENGTH);
+        int3store(&to[NET_HEADER_SIZE], complen);
+        int3store(to, out_length);
+        to[3]= (uchar) (net->compress_pkt_nr++);
+        to+= out_length + header_length;
+        packet+= chunk_length;
+        len-= chunk_length;
+      }
+      len= (size_t) (to - b);
+    }
+    else
+    {
+      memcpy(b+header_length,packet,len);
+
+      if (my_compress(b+header_length, &len, &complen))
+        complen=0;
+      int3store(&b[NET_HEADER_SIZE],complen);
+      int3store(b,len);
+      b[3]=(uchar) (net->compress_pkt_nr++);
+      len+= header_length;
+    }
     packet= b;
   }
 #endif /* HAVE_COMPRESS */
@@ -714,6 +1004,16 @@ net_real_write(NET *net,const uchar *packet, size_t len)
 #ifdef HAVE_COMPRESS
   if (net->compress)
     my_free((void*) packet);
+#endif
+#ifdef MYSQL_SERVER
+  /* Don't keep the memory of a big write */
+  if (server_extension &&
+      server_extension->m_pending_size > 2 * net->max_packet)
+  {
+    my_free(server_extension->m_pending);
+    server_extension->m_pending= 0;
+    server_extension->m_pending_size= 0;
+  }
 #endif
   if (thr_alarm_in_use(&alarmed))
   {
@@ -1176,7 +1476,11 @@ my_net_read(NET *net)
         MYSQL_NET_READ_DONE(1, 0);
 	return packet_error;
       }
-      if (my_uncompress(net->buff + net->where_b, packet_len,
+      if (net->compress_stream ?
+          my_uncompress_stream((MY_COMPRESS_STREAM*) net->compress_stream,
+                               net->buff + net->where_b, packet_len,
+                               &complen) :
+          my_uncompress(net->buff + net->where_b, packet_len,
 			&complen))
       {
 	net->error= 2;			/* caller will close socket */
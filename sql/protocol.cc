@@ -874,6 +874,74 @@ bool Protocol::write()
   DBUG_RETURN(my_net_write(&thd->net, (uchar*) packet->ptr(),
                            packet->length()));
 }
+
+
+/**
+  Start a row of a result set.
+
+  If there is room for it, the row is built in place in the network
+  buffer after the room for the packet header, so that end_row() only
+  has to add the header instead of copying the row there.  A row that
+  doesn't fit is moved to the heap by String::realloc() and sent with
+  my_net_write() as usual.
+*/
+
+void Protocol::start_row()
+{
+  NET *net= &thd->net;
+  uchar *pos= net->write_pos + NET_HEADER_SIZE;
+  size_t room= (size_t) (net->buff_end - pos);
+
+  /* The binary protocol needs room for the NULL bitmap in the row */
+  if (net->vio && !net->compress && type() != PROTOCOL_LOCAL &&
+      pos < net->buff_end && room > field_count + NET_HEADER_SIZE)
+  {
+    net_row.set((char*) pos,
+                (uint32) MY_MIN(room, (size_t) MAX_PACKET_LENGTH - 1),
+                &my_charset_bin);
+    packet= &net_row;
+  }
+  prepare_for_resend();
+}
+
+
+/**
+  Send the row started by start_row().
+
+  When the row didn't fit in the network buffer, the buffer is grown to
+  @@net_result_buffer_length first, so that the rest of a large result
+  set is sent in fewer and bigger writes.  The buffer is shrunk back by
+  net_shrink_buffer() when the command ends.
+*/
+
+bool Protocol::end_row()
+{
+  NET *net= &thd->net;
+  DBUG_ENTER("Protocol::end_row");
+
+  if (packet != &net_row)
+    DBUG_RETURN(thd->vio_ok() ? write() : FALSE);
+  packet= &thd->packet;
+  if (net_row.ptr() == (char*) net->write_pos + NET_HEADER_SIZE)
+  {
+    net_write_in_place(net, net_row.length());
+    DBUG_RETURN(FALSE);
+  }
+  /* Nothing else may write to the network buffer while a row is built */
+  DBUG_ASSERT(net_row.ptr() < (char*) net->buff ||
+              net_row.ptr() > (char*) net->buff_end);
+  if (net->max_packet < thd->variables.net_result_buffer_length)
+    net_extend_write_buffer(net, thd->variables.net_result_buffer_length);
+  bool error= my_net_write(net, (uchar*) net_row.ptr(), net_row.length());
+  net_row.free();
+  DBUG_RETURN(error);
+}
+
+
+void Protocol::remove_last_row()
+{
+  packet= &thd->packet;
+}
 #endif /* EMBEDDED_LIBRARY */
 
 
@@ -43,6 +43,8 @@ protected:
 #endif
   uint field_count;
 #ifndef EMBEDDED_LIBRARY
+  /* The row being built in place in the network buffer, see start_row() */
+  String net_row;
   bool net_store_data(const uchar *from, size_t length);
 #else
   virtual bool net_store_data(const uchar *from, size_t length);
@@ -77,6 +79,13 @@ public:
   enum { SEND_NUM_ROWS= 1, SEND_DEFAULTS= 2, SEND_EOF= 4 };
   virtual bool send_result_set_metadata(List<Item> *list, uint flags);
   bool send_result_set_row(List<Item> *row_items);
+#ifndef EMBEDDED_LIBRARY
+  void start_row();
+  bool end_row();
+#else
+  void start_row() { prepare_for_resend(); }
+  bool end_row() { return write(); }
+#endif
 
   bool store(I_List<i_string> *str_list);
   bool store(const char *from, CHARSET_INFO *cs);
@@ -124,7 +133,7 @@ public:
   int begin_dataset();
   virtual void remove_last_row() {}
 #else
-  void remove_last_row() {}
+  void remove_last_row();
 #endif
   enum enum_protocol_type
   {
@@ -265,8 +265,17 @@ bool init_read_record(READ_RECORD *info,THD *thd, TABLE *table,
     if (table->file->ha_rnd_init_with_error(0))
       DBUG_RETURN(1);
     info->cache_pos=table->sort.record_pointers;
-    info->cache_end=info->cache_pos+ 
-                    table->sort.found_records*info->ref_length;
+    if (table->sort.addon_field && table->sort.using_packed_addons)
+    {
+      /* Records are of variable length, walk them to find the end */
+      uchar *pos= info->cache_pos;
+      for (ha_rows i= 0; i < table->sort.found_records; i++)
+        pos+= uint4korr(pos);
+      info->cache_end= pos;
+    }
+    else
+      info->cache_end=info->cache_pos+ 
+                      table->sort.found_records*info->ref_length;
     info->read_record= (table->sort.addon_field ?
                         rr_unpack_from_buffer : rr_from_pointers);
   }
@@ -520,11 +529,22 @@ static int rr_from_tempfile(READ_RECORD *info)
 
 static int rr_unpack_from_tempfile(READ_RECORD *info)
 {
-  if (my_b_read(info->io_cache, info->rec_buf, info->ref_length))
-    return -1;
+  uint length= info->ref_length;
   TABLE *table= info->table;
+  if (table->sort.using_packed_addons)
+  {
+    /* The record starts with its length, which includes the length bytes */
+    if (my_b_read(info->io_cache, info->rec_buf, 4))
+      return -1;
+    length= uint4korr(info->rec_buf);
+    if (length < 4 || length > info->ref_length ||
+        my_b_read(info->io_cache, info->rec_buf + 4, length - 4))
+      return -1;
+  }
+  else if (my_b_read(info->io_cache, info->rec_buf, length))
+    return -1;
   (*table->sort.unpack)(table->sort.addon_field, info->rec_buf,
-                        info->rec_buf + info->ref_length);
+                        info->rec_buf + length);
 
   return 0;
 }
@@ -577,7 +597,8 @@ static int rr_unpack_from_buffer(READ_RECORD *info)
   TABLE *table= info->table;
   (*table->sort.unpack)(table->sort.addon_field, info->cache_pos,
                         info->cache_end);
-  info->cache_pos+= info->ref_length;
+  info->cache_pos+= (table->sort.using_packed_addons ?
+                     uint4korr(info->cache_pos) : info->ref_length);
 
   return 0;
 }
@@ -3247,7 +3247,10 @@ int apply_event_and_update_pos(Log_event* ev, THD* thd,
       DBUG_SET_INITIAL("-d,inject_slave_sql_before_apply_event");
     };);
   if (reason == Log_event::EVENT_SKIP_NOT)
+  {
     exec_res= ev->apply_event(rgi);
+    thd->add_status_to_global();
+  }
 
 #ifndef DBUG_OFF
   /*
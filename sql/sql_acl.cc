@@ -10915,6 +10915,7 @@ static bool send_server_handshake_packet(MPVIO_EXT *mpvio,
     thd->client_capabilities|= CLIENT_TRANSACTIONS;
 
   thd->client_capabilities|= CAN_CLIENT_COMPRESS;
+  thd->client_ext_capabilities= CLIENT_EXT_ALL_FLAGS;
 
   if (ssl_acceptor_fd)
   {
@@ -10977,7 +10978,9 @@ static bool send_server_handshake_packet(MPVIO_EXT *mpvio,
   int2store(end+5, thd->client_capabilities >> 16);
   end[7]= data_len;
   DBUG_EXECUTE_IF("poison_srv_handshake_scramble_len", end[7]= -100;);
-  bzero(end + 8, 10);
+  bzero(end + 8, 6);
+  /* The last 4 bytes of the reserved ones: the extended capabilities */
+  int4store(end + 14, thd->client_ext_capabilities);
   end+= 18;
   /* write scramble tail */
   end= (char*) memcpy(end, data + SCRAMBLE_LENGTH_323,
@@ -11435,12 +11438,15 @@ static ulong parse_client_handshake_packet(MPVIO_EXT *mpvio,
     if (thd_init_client_charset(thd, (uint) net->read_pos[8]))
       return packet_error;
     thd->update_charset();
+    /* The extended capabilities, in the last 4 bytes of the filler */
+    thd->client_ext_capabilities&= uint4korr(net->read_pos+28);
     end= (char*) net->read_pos+32;
   }
   else
   {
     if (pkt_len < 5)
       return packet_error;
+    thd->client_ext_capabilities= 0;
     thd->max_client_packet_length= uint3korr(net->read_pos+2);
     end= (char*) net->read_pos+5;
   }
@@ -302,6 +302,23 @@ functions:
          the used memory blocks in physical memory order and move all avail-
          able memory to the 'bottom' of the memory.
 
+8. Partitions and table versions
+With query_cache_partitions > 1 the global query_cache object owns that
+many Query_cache objects, each with its own lock, memory, queries and
+tables, and passes the calls of the interface on to them. A query is
+stored and looked up in the partition chosen by the hash of its key, so
+lookups and inserts of different queries don't wait for each other.
+
+A table can be cached in several partitions. Invalidation first
+increments the version counter of the table (one of
+QUERY_CACHE_TABLE_VERSIONS counters chosen by the hash of the table
+key), and every query records the versions of its tables when it is
+stored, so from that moment on the queries of the table are stale in
+all partitions and are not sent by send_result_to_client. Then the
+queries are removed from the partitions that have the table, to free
+their memory; the partitions without the table are skipped without
+locking them (see slot_tables).
+
 
 TODO list:
 
@@ -350,6 +367,50 @@ TODO list:
 
 const uchar *query_state_map;
 
+/* The table versions, see "8. Partitions and table versions" */
+static volatile int32 table_versions[QUERY_CACHE_TABLE_VERSIONS];
+my_atomic_rwlock_t LOCK_table_versions;  /**< Protects table_versions */
+
+
+/**
+  Find the version counter of a table.
+
+  The key is hashed as in the tables hash, so every key that finds the
+  table there has the same counter. Tables that share a counter only
+  make the queries of each other stale a bit early.
+*/
+
+static uint table_version_slot(const uchar *key, uint32 key_length)
+{
+  ulong nr1= 1, nr2= 4;
+  CHARSET_INFO *cs= &my_charset_bin;
+#ifdef FN_NO_CASE_SENSE
+  if (!lower_case_table_names)
+    cs= files_charset_info;
+#endif
+  cs->coll->hash_sort(cs, key, key_length, &nr1, &nr2);
+  return (uint) (nr1 % QUERY_CACHE_TABLE_VERSIONS);
+}
+
+static inline int32 table_version(uint slot)
+{
+  int32 version;
+  my_atomic_rwlock_rdlock(&LOCK_table_versions);
+  version= my_atomic_load32(&table_versions[slot]);
+  my_atomic_rwlock_rdunlock(&LOCK_table_versions);
+  return version;
+}
+
+/* Make the cached queries of the table stale in all partitions */
+
+static inline void invalidate_table_version(uint slot)
+{
+  my_atomic_rwlock_wrlock(&LOCK_table_versions);
+  my_atomic_add32(&table_versions[slot], 1);
+  my_atomic_rwlock_wrunlock(&LOCK_table_versions);
+}
+
+
 #ifdef EMBEDDED_LIBRARY
 #include "emb_qcache.h"
 #endif
@@ -1073,6 +1134,13 @@ Query_cache::insert(Query_cache_tls *query_cache_tls,
   if (is_disabled() || query_cache_tls->first_query_block == NULL)
     DBUG_VOID_RETURN;
 
+  if (query_cache_tls->partition != this)
+  {
+    query_cache_tls->partition->insert(query_cache_tls, packet, length,
+                                       pkt_nr);
+    DBUG_VOID_RETURN;
+  }
+
   DBUG_ASSERT(current_thd);
 
   QC_DEBUG_SYNC("wait_in_query_cache_insert");
@@ -1113,8 +1181,8 @@ Query_cache::insert(Query_cache_tls *query_cache_tls,
     header->result(result);
     DBUG_PRINT("qcache", ("free query 0x%lx", (ulong) query_block));
     // The following call will remove the lock on query_block
-    query_cache.free_query(query_block);
-    query_cache.refused++;
+    free_query(query_block);
+    refused++;
     // append_result_data no success => we need unlock
     unlock();
     DBUG_VOID_RETURN;
@@ -1139,6 +1207,12 @@ Query_cache::abort(Query_cache_tls *query_cache_tls)
   if (is_disabled() || query_cache_tls->first_query_block == NULL)
     DBUG_VOID_RETURN;
 
+  if (query_cache_tls->partition != this)
+  {
+    query_cache_tls->partition->abort(query_cache_tls);
+    DBUG_VOID_RETURN;
+  }
+
   if (try_lock(current_thd, Query_cache::WAIT))
     DBUG_VOID_RETURN;
 
@@ -1185,6 +1259,12 @@ void Query_cache::end_of_result(THD *thd)
     DBUG_VOID_RETURN;
   }
 
+  if (query_cache_tls->partition != this)
+  {
+    query_cache_tls->partition->end_of_result(thd);
+    DBUG_VOID_RETURN;
+  }
+
 #ifdef EMBEDDED_LIBRARY
   insert(query_cache_tls, (char*)thd,
                      emb_count_querycache_size(thd), 0);
@@ -1225,9 +1305,9 @@ void Query_cache::end_of_result(THD *thd)
     }
     last_result_block= header->result()->prev;
     allign_size= ALIGN_SIZE(last_result_block->used);
-    len= MY_MAX(query_cache.min_allocation_unit, allign_size);
-    if (last_result_block->length >= query_cache.min_allocation_unit + len)
-      query_cache.split_block(last_result_block,len);
+    len= MY_MAX(min_allocation_unit, allign_size);
+    if (last_result_block->length >= min_allocation_unit + len)
+      split_block(last_result_block,len);
 
     header->found_rows(limit_found_rows);
     header->result()->type= Query_cache_block::RESULT;
@@ -1276,6 +1356,7 @@ Query_cache::Query_cache(ulong query_cache_limit_arg,
    queries_in_cache(0), hits(0), inserts(0), refused(0),
    total_blocks(0), lowmem_prunes(0),
    m_cache_status(OK),
+   partitions(NULL), n_partitions(1), slot_tables(NULL),
    min_allocation_unit(ALIGN_SIZE(min_allocation_unit_arg)),
    min_result_data_size(ALIGN_SIZE(min_result_data_size_arg)),
    def_query_hash_size(ALIGN_SIZE(def_query_hash_size_arg)),
@@ -1309,6 +1390,21 @@ ulong Query_cache::resize(ulong query_cache_size_arg)
 
   lock_and_suspend();
 
+  if (partitions)
+  {
+    /* The first partition gets the rest, so the sizes add up to the total */
+    ulong part_size= query_cache_size_arg / n_partitions;
+    new_query_cache_size= partitions[0].resize(part_size +
+                                               query_cache_size_arg %
+                                               n_partitions);
+    for (uint i= 1; i < n_partitions; i++)
+      new_query_cache_size+= partitions[i].resize(part_size);
+    query_cache_size= new_query_cache_size;
+    m_cache_status= new_query_cache_size ? OK : DISABLED;
+    unlock();
+    DBUG_RETURN(new_query_cache_size);
+  }
+
   /*
     Wait for all readers and writers to exit. When the list of all queries
     is iterated over with a block level lock, we are done.
@@ -1360,12 +1456,29 @@ ulong Query_cache::resize(ulong query_cache_size_arg)
 ulong Query_cache::set_min_res_unit(ulong size)
 {
   DBUG_ASSERT(size % 8 == 0);
+  for (uint i= 0; partitions && i < n_partitions; i++)
+    partitions[i].set_min_res_unit(size);
   if (size < min_allocation_unit)
     size= ALIGN_SIZE(min_allocation_unit);
   return (min_result_data_size= size);
 }
 
 
+/**
+  Find the partition of a query by the hash of its key
+*/
+
+Query_cache *Query_cache::partition_for(const uchar *key, ulong key_length)
+{
+  ulong nr1= 1, nr2= 4;
+  if (!partitions)
+    return this;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, key, key_length,
+                                 &nr1, &nr2);
+  return partitions + nr1 % n_partitions;
+}
+
+
 void Query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
 {
   TABLE_COUNTER_TYPE local_tables;
@@ -1466,33 +1579,6 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
     */
     ha_release_temporary_latches(thd);
 
-    /*
-      A table- or a full flush operation can potentially take a long time to
-      finish. We choose not to wait for them and skip caching statements
-      instead.
-
-      In case the wait time can't be determined there is an upper limit which
-      causes try_lock() to abort with a time out.
-
-      The 'TIMEOUT' parameter indicate that the lock is allowed to timeout
-
-    */
-    if (try_lock(thd, Query_cache::TIMEOUT))
-      DBUG_VOID_RETURN;
-    if (query_cache_size == 0)
-    {
-      unlock();
-      DBUG_VOID_RETURN;
-    }
-    DUMP(this);
-
-    if (ask_handler_allowance(thd, tables_used))
-    {
-      refused++;
-      unlock();
-      DBUG_VOID_RETURN;
-    }
-
     query=        thd->base_query.ptr();
     query_length= thd->base_query.length();
 
@@ -1517,75 +1603,123 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
     memcpy((void*) (query + (tot_length - QUERY_CACHE_FLAGS_SIZE)),
 	   &flags, QUERY_CACHE_FLAGS_SIZE);
 
-    /* Check if another thread is processing the same query? */
-    Query_cache_block *competitor = (Query_cache_block *)
-      my_hash_search(&queries, (uchar*) query, tot_length);
-    DBUG_PRINT("qcache", ("competitor 0x%lx", (ulong) competitor));
-    if (competitor == 0)
-    {
-      /* Query is not in cache and no one is working with it; Store it */
-      Query_cache_block *query_block;
-      query_block= write_block_data(tot_length, (uchar*) query,
-				    ALIGN_SIZE(sizeof(Query_cache_query)),
-				    Query_cache_block::QUERY, local_tables);
-      if (query_block != 0)
-      {
-	DBUG_PRINT("qcache", ("query block 0x%lx allocated, %lu",
-			    (ulong) query_block, query_block->used));
+    partition_for((uchar*) query, tot_length)->
+      insert_query(thd, tables_used, query, tot_length, local_tables,
+                   tables_type);
+  }
+  else
+    statistic_increment(refused, &structure_guard_mutex);
 
-	Query_cache_query *header = query_block->query();
-	header->init_n_lock();
-	if (my_hash_insert(&queries, (uchar*) query_block))
-	{
-	  refused++;
-	  DBUG_PRINT("qcache", ("insertion in query hash"));
-	  header->unlock_n_destroy();
-	  free_memory_block(query_block);
-          unlock();
-	  goto end;
-	}
-	if (!register_all_tables(thd, query_block, tables_used, local_tables))
-	{
-	  refused++;
-	  DBUG_PRINT("warning", ("tables list including failed"));
-	  my_hash_delete(&queries, (uchar *) query_block);
-	  header->unlock_n_destroy();
-	  free_memory_block(query_block);
-          unlock();
-	  goto end;
-	}
-	double_linked_list_simple_include(query_block, &queries_blocks);
-	inserts++;
-	queries_in_cache++;
-	thd->query_cache_tls.first_query_block= query_block;
-	header->writer(&thd->query_cache_tls);
-	header->tables_type(tables_type);
+  DBUG_VOID_RETURN;
+}
 
-        unlock();
 
-	// init_n_lock make query block locked
-	BLOCK_UNLOCK_WR(query_block);
+/**
+  Register the query in this partition of the cache
+
+  @param query        the key of the query, made by store_query()
+  @param tot_length   the length of the key
+*/
+
+void Query_cache::insert_query(THD *thd, TABLE_LIST *tables_used,
+                               const char *query, ulong tot_length,
+                               TABLE_COUNTER_TYPE local_tables,
+                               uint8 tables_type)
+{
+  DBUG_ENTER("Query_cache::insert_query");
+
+  /*
+    A table- or a full flush operation can potentially take a long time to
+    finish. We choose not to wait for them and skip caching statements
+    instead.
+
+    In case the wait time can't be determined there is an upper limit which
+    causes try_lock() to abort with a time out.
+
+    The 'TIMEOUT' parameter indicate that the lock is allowed to timeout
+
+  */
+  if (try_lock(thd, Query_cache::TIMEOUT))
+    DBUG_VOID_RETURN;
+  if (query_cache_size == 0)
+  {
+    unlock();
+    DBUG_VOID_RETURN;
+  }
+  DUMP(this);
+
+  if (ask_handler_allowance(thd, tables_used))
+  {
+    refused++;
+    unlock();
+    DBUG_VOID_RETURN;
+  }
+
+  /* Check if another thread is processing the same query? */
+  Query_cache_block *competitor = (Query_cache_block *)
+    my_hash_search(&queries, (uchar*) query, tot_length);
+  DBUG_PRINT("qcache", ("competitor 0x%lx", (ulong) competitor));
+  if (competitor == 0)
+  {
+    /* Query is not in cache and no one is working with it; Store it */
+    Query_cache_block *query_block;
+    query_block= write_block_data(tot_length, (uchar*) query,
+                                  ALIGN_SIZE(sizeof(Query_cache_query)),
+                                  Query_cache_block::QUERY, local_tables);
+    if (query_block != 0)
+    {
+      DBUG_PRINT("qcache", ("query block 0x%lx allocated, %lu",
+                          (ulong) query_block, query_block->used));
+
+      Query_cache_query *header = query_block->query();
+      header->init_n_lock();
+      if (my_hash_insert(&queries, (uchar*) query_block))
+      {
+        refused++;
+        DBUG_PRINT("qcache", ("insertion in query hash"));
+        header->unlock_n_destroy();
+        free_memory_block(query_block);
+        unlock();
+        DBUG_VOID_RETURN;
       }
-      else
+      if (!register_all_tables(thd, query_block, tables_used, local_tables))
       {
-	// We have not enough memory to store query => do nothing
-	refused++;
+        refused++;
+        DBUG_PRINT("warning", ("tables list including failed"));
+        my_hash_delete(&queries, (uchar *) query_block);
+        header->unlock_n_destroy();
+        free_memory_block(query_block);
         unlock();
-	DBUG_PRINT("warning", ("Can't allocate query"));
+        DBUG_VOID_RETURN;
       }
+      double_linked_list_simple_include(query_block, &queries_blocks);
+      inserts++;
+      queries_in_cache++;
+      thd->query_cache_tls.first_query_block= query_block;
+      thd->query_cache_tls.partition= this;
+      header->writer(&thd->query_cache_tls);
+      header->tables_type(tables_type);
+
+      unlock();
+
+      // init_n_lock make query block locked
+      BLOCK_UNLOCK_WR(query_block);
     }
     else
     {
-      // Another thread is processing the same query => do nothing
+      // We have not enough memory to store query => do nothing
       refused++;
       unlock();
-      DBUG_PRINT("qcache", ("Another thread process same query"));
+      DBUG_PRINT("warning", ("Can't allocate query"));
     }
   }
   else
-    statistic_increment(refused, &structure_guard_mutex);
-
-end:
+  {
+    // Another thread is processing the same query => do nothing
+    refused++;
+    unlock();
+    DBUG_PRINT("qcache", ("Another thread process same query"));
+  }
   DBUG_VOID_RETURN;
 }
 
@@ -1698,13 +1832,6 @@ size_t build_normalized_name(char *buff, size_t bufflen,
 int
 Query_cache::send_result_to_client(THD *thd, char *org_sql, uint query_length)
 {
-  ulonglong engine_data;
-  Query_cache_query *query;
-#ifndef EMBEDDED_LIBRARY
-  Query_cache_block *first_result_block;
-#endif
-  Query_cache_block *result_block;
-  Query_cache_block_table *block_table, *block_table_end;
   ulong tot_length;
   Query_cache_query_flags flags;
   const char *sql, *sql_end, *found_brace= 0;
@@ -1848,23 +1975,6 @@ Query_cache::send_result_to_client(THD *thd, char *org_sql, uint query_length)
       goto err;
     }
   }
-  /*
-    Try to obtain an exclusive lock on the query cache. If the cache is
-    disabled or if a full cache flush is in progress, the attempt to
-    get the lock is aborted.
-
-    The TIMEOUT parameter indicate that the lock is allowed to timeout.
-  */
-  if (try_lock(thd, Query_cache::TIMEOUT))
-    goto err;
-
-  if (query_cache_size == 0)
-  {
-    thd->query_cache_is_applicable= 0;            // Query can't be cached
-    goto err_unlock;
-  }
-
-  Query_cache_block *query_block;
   if (thd->variables.query_cache_strip_comments)
   {
     if (found_brace)
@@ -1947,6 +2057,53 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
                           (int)flags.autocommit));
   memcpy((uchar *)(sql + (tot_length - QUERY_CACHE_FLAGS_SIZE)),
 	 (uchar*) &flags, QUERY_CACHE_FLAGS_SIZE);
+  DBUG_RETURN(partition_for((uchar*) sql, tot_length)->
+              send_cached_result(thd, sql, tot_length));
+
+err:
+  thd->query_cache_is_applicable= 0;            // Query can't be cached
+  DBUG_RETURN(0);				// Query was not cached
+}
+
+
+/**
+  Look up the query in this partition of the cache and send the result
+
+  @param sql         the key of the query, made by send_result_to_client()
+  @param tot_length  the length of the key
+
+  @return as send_result_to_client()
+*/
+
+int
+Query_cache::send_cached_result(THD *thd, const char *sql, ulong tot_length)
+{
+  ulonglong engine_data;
+  Query_cache_query *query;
+#ifndef EMBEDDED_LIBRARY
+  Query_cache_block *first_result_block;
+#endif
+  Query_cache_block *result_block;
+  Query_cache_block_table *block_table, *block_table_end;
+  Query_cache_block *query_block;
+  DBUG_ENTER("Query_cache::send_cached_result");
+
+  /*
+    Try to obtain an exclusive lock on the query cache. If the cache is
+    disabled or if a full cache flush is in progress, the attempt to
+    get the lock is aborted.
+
+    The TIMEOUT parameter indicate that the lock is allowed to timeout.
+  */
+  if (try_lock(thd, Query_cache::TIMEOUT))
+    goto err;
+
+  if (query_cache_size == 0)
+  {
+    thd->query_cache_is_applicable= 0;            // Query can't be cached
+    goto err_unlock;
+  }
+
   query_block = (Query_cache_block *)  my_hash_search(&queries, (uchar*) sql,
                                                       tot_length);
   /* Quick abort on unlocked data */
@@ -1985,11 +2142,29 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
     BLOCK_UNLOCK_RD(query_block);
     goto err_unlock;
   }
+
+  /*
+    A table of the query may have been changed after the query was stored
+    and not yet invalidated in this partition.
+  */
+  block_table= query_block->table(0);
+  block_table_end= block_table+query_block->n_tables;
+  for (; block_table != block_table_end; block_table++)
+  {
+    if (block_table->version !=
+        table_version(block_table->parent->version_slot))
+    {
+      DBUG_PRINT("qcache", ("Table changed after the query was stored"));
+      BLOCK_UNLOCK_RD(query_block);
+      BLOCK_LOCK_WR(query_block);
+      free_query(query_block);
+      goto err_unlock;
+    }
+  }
       
   // Check access;
   THD_STAGE_INFO(thd, stage_checking_privileges_on_cached_query);
   block_table= query_block->table(0);
-  block_table_end= block_table+query_block->n_tables;
   for (; block_table != block_table_end; block_table++)
   {
     TABLE_LIST table_list;
@@ -2079,6 +2254,7 @@ def_week_frmt: %lu, in_trans: %d, autocommit: %d",
                      ("Handler require invalidation queries of %.*s %lu-%lu",
                       qcache_se_key_len, qcache_se_key_name,
                       (ulong) engine_data, (ulong) table->engine_data()));
+          invalidate_table_version(table->version_slot);
           invalidate_table_internal(thd,
                                     (uchar *) table->db(),
                                     table->key_length());
@@ -2306,6 +2482,13 @@ void Query_cache::invalidate(THD *thd, char *db)
   if (is_disabled())
     DBUG_VOID_RETURN;
 
+  if (partitions)
+  {
+    for (uint i= 0; i < n_partitions; i++)
+      partitions[i].invalidate(thd, db);
+    DBUG_VOID_RETURN;
+  }
+
   bool restart= FALSE;
   /*
     Lock the query cache and queue all invalidation attempts to avoid
@@ -2327,6 +2510,7 @@ void Query_cache::invalidate(THD *thd, char *db)
           if (strcmp(table->db(),db) == 0)
           {
             Query_cache_block_table *list_root= table_block->table(0);
+            invalidate_table_version(table->version_slot);
             invalidate_query_block_list(thd,list_root);
           }
 
@@ -2395,6 +2579,13 @@ void Query_cache::flush()
   if (is_disabled())
     DBUG_VOID_RETURN;
 
+  if (partitions)
+  {
+    for (uint i= 0; i < n_partitions; i++)
+      partitions[i].flush();
+    DBUG_VOID_RETURN;
+  }
+
   QC_DEBUG_SYNC("wait_in_query_cache_flush1");
 
   lock_and_suspend();
@@ -2405,7 +2596,7 @@ void Query_cache::flush()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
   unlock();
   DBUG_VOID_RETURN;
 }
@@ -2428,6 +2619,13 @@ void Query_cache::pack(THD *thd, ulong join_limit, uint iteration_limit)
   if (is_disabled())
     DBUG_VOID_RETURN;
 
+  if (partitions)
+  {
+    for (uint i= 0; i < n_partitions; i++)
+      partitions[i].pack(thd, join_limit, iteration_limit);
+    DBUG_VOID_RETURN;
+  }
+
   /*
     If the entire qc is being invalidated we can bail out early
     instead of waiting for the lock.
@@ -2461,22 +2659,41 @@ void Query_cache::destroy()
   }
   else
   {
-    /* Underlying code expects the lock. */
-    lock_and_suspend();
-    free_cache();
-    unlock();
-
-    mysql_cond_destroy(&COND_cache_status_changed);
-    mysql_mutex_destroy(&structure_guard_mutex);
-    initialized = 0;
-    DBUG_ASSERT(m_requests_in_progress == 0);
+    if (partitions)
+    {
+      for (uint i= 0; i < n_partitions; i++)
+        partitions[i].destroy_partition();
+      delete [] partitions;
+      partitions= NULL;
+      n_partitions= 1;
+    }
+    destroy_partition();
+    my_atomic_rwlock_destroy(&LOCK_table_versions);
   }
   DBUG_VOID_RETURN;
 }
 
 
+void Query_cache::destroy_partition()
+{
+  /* Underlying code expects the lock. */
+  lock_and_suspend();
+  free_cache();
+  unlock();
+
+  mysql_cond_destroy(&COND_cache_status_changed);
+  mysql_mutex_destroy(&structure_guard_mutex);
+  my_free(slot_tables);
+  slot_tables= NULL;
+  initialized = 0;
+  DBUG_ASSERT(m_requests_in_progress == 0);
+}
+
+
 void Query_cache::disable_query_cache(THD *thd)
 {
+  for (uint i= 0; partitions && i < n_partitions; i++)
+    partitions[i].disable_query_cache(thd);
   m_cache_status= DISABLE_REQUEST;
   /*
     If there is no requests in progress try to free buffer.
@@ -2488,13 +2705,76 @@ void Query_cache::disable_query_cache(THD *thd)
 }
 
 
+/**
+  Add the statistics of the cache and its partitions to stats
+
+  The queries that are refused before a partition is chosen are counted
+  in this object.
+*/
+
+void Query_cache::get_statistics(Query_cache_statistics *stats)
+{
+  stats->free_memory_blocks+= free_memory_blocks;
+  stats->free_memory+= free_memory;
+  stats->hits+= hits;
+  stats->inserts+= inserts;
+  stats->lowmem_prunes+= lowmem_prunes;
+  stats->refused+= refused;
+  stats->queries_in_cache+= queries_in_cache;
+  stats->total_blocks+= total_blocks;
+  for (uint i= 0; partitions && i < n_partitions; i++)
+    partitions[i].get_statistics(stats);
+}
+
+
+/* Reset the counters that FLUSH STATUS resets */
+
+void Query_cache::reset_statistics()
+{
+  for (uint i= 0; partitions && i < n_partitions; i++)
+    partitions[i].reset_statistics();
+  hits= inserts= lowmem_prunes= refused= 0;
+}
+
+
 /*****************************************************************************
   init/destroy
 *****************************************************************************/
 
-void Query_cache::init()
+/**
+  Initialize the cache
+
+  @param partitions_arg  the number of partitions, see "8. Partitions
+                         and table versions" at the top of the file
+*/
+
+void Query_cache::init(uint partitions_arg)
 {
   DBUG_ENTER("Query_cache::init");
+  my_atomic_rwlock_init(&LOCK_table_versions);
+  init_partition();
+  if (partitions_arg > 1 &&
+      (partitions= new Query_cache[partitions_arg]))
+  {
+    n_partitions= partitions_arg;
+    for (uint i= 0; i < n_partitions; i++)
+    {
+      partitions[i].init_partition();
+      partitions[i].set_min_res_unit(min_result_data_size);
+      partitions[i].result_size_limit(query_cache_limit);
+    }
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+void Query_cache::init_partition()
+{
+  DBUG_ENTER("Query_cache::init_partition");
+  /* The partitions are allocated on the heap and are not zero filled */
+  make_disabled();
+  my_hash_clear(&queries);
+  my_hash_clear(&tables);
   mysql_mutex_init(key_structure_guard_mutex,
                    &structure_guard_mutex, MY_MUTEX_INIT_FAST);
   mysql_cond_init(key_COND_cache_status_changed,
@@ -2502,6 +2782,8 @@ void Query_cache::init()
   m_cache_lock_status= Query_cache::UNLOCKED;
   m_cache_status= Query_cache::OK;
   m_requests_in_progress= 0;
+  slot_tables= (int32*) my_malloc(QUERY_CACHE_TABLE_VERSIONS * sizeof(int32),
+                                  MYF(MY_WME | MY_ZEROFILL));
   initialized = 1;
   /*
     Using state_map from latin1 should be fine in all cases:
@@ -2731,6 +3013,8 @@ void Query_cache::make_disabled()
   first_block= 0;
   total_blocks= 0;
   tables_blocks= 0;
+  if (slot_tables)
+    bzero(slot_tables, QUERY_CACHE_TABLE_VERSIONS * sizeof(int32));
   DBUG_VOID_RETURN;
 }
 
@@ -3229,22 +3513,53 @@ void Query_cache::invalidate_table(THD *thd, TABLE *table)
                    table->s->table_cache_key.length);
 }
 
+/**
+  Check without the lock if the partition may have a table
+
+  The answer may be out of date, which is safe as the version of the
+  table has been incremented before: a query stored after it is not
+  stale, and the stale ones are not sent anyway.
+*/
+
+bool Query_cache::has_tables_in_slot(uint slot)
+{
+  int32 count;
+  if (!slot_tables)
+    return TRUE;                                // Out of memory at init
+  my_atomic_rwlock_rdlock(&LOCK_table_versions);
+  count= my_atomic_load32(&slot_tables[slot]);
+  my_atomic_rwlock_rdunlock(&LOCK_table_versions);
+  return count != 0;
+}
+
+
 void Query_cache::invalidate_table(THD *thd, uchar * key, uint32  key_length)
 {
+  uint slot= table_version_slot(key, key_length);
+
   DEBUG_SYNC(thd, "wait_in_query_cache_invalidate1");
 
-  /*
-    Lock the query cache and queue all invalidation attempts to avoid
-    the risk of a race between invalidation, cache inserts and flushes.
-  */
-  lock(thd);
+  invalidate_table_version(slot);
 
-  DEBUG_SYNC(thd, "wait_in_query_cache_invalidate2");
+  for (uint i= 0; i < n_partitions; i++)
+  {
+    Query_cache *part= partition(i);
+    if (!part->has_tables_in_slot(slot))
+      continue;
 
-  if (query_cache_size > 0)
-    invalidate_table_internal(thd, key, key_length);
+    /*
+      Lock the query cache and queue all invalidation attempts to avoid
+      the risk of a race between invalidation, cache inserts and flushes.
+    */
+    part->lock(thd);
 
-  unlock();
+    DEBUG_SYNC(thd, "wait_in_query_cache_invalidate2");
+
+    if (part->query_cache_size > 0)
+      part->invalidate_table_internal(thd, key, key_length);
+
+    part->unlock();
+  }
 }
 
 
@@ -3457,6 +3772,7 @@ Query_cache::insert_table(uint key_len, const char *key,
     */
     {
       Query_cache_block_table *list_root= table_block->table(0);
+      invalidate_table_version(table_block->table()->version_slot);
       invalidate_query_block_list(thd, list_root);
     }
 
@@ -3506,12 +3822,20 @@ Query_cache::insert_table(uint key_len, const char *key,
     header->callback(callback);
     header->engine_data(engine_data);
     header->set_hashed(hash);
+    header->version_slot= table_version_slot((uchar*) key, key_len);
 
     /*
       We insert this table without the assumption that it isn't refrenenced by
       any queries.
     */
     header->m_cached_query_count= 0;
+
+    if (slot_tables)
+    {
+      my_atomic_rwlock_wrlock(&LOCK_table_versions);
+      my_atomic_add32(&slot_tables[header->version_slot], 1);
+      my_atomic_rwlock_wrunlock(&LOCK_table_versions);
+    }
   }
 
   /*
@@ -3531,6 +3855,7 @@ Query_cache::insert_table(uint key_len, const char *key,
   */
   Query_cache_table *table_block_data= table_block->table();
   table_block_data->m_cached_query_count++;
+  node->version= table_version(table_block_data->version_slot);
   DBUG_RETURN(1);
 }
 
@@ -3562,6 +3887,12 @@ void Query_cache::unlink_table(Query_cache_block_table *node)
     Query_cache_table *header= table_block->table();
     if (header->is_hashed())
       my_hash_delete(&tables,(uchar *) table_block);
+    if (slot_tables)
+    {
+      my_atomic_rwlock_wrlock(&LOCK_table_versions);
+      my_atomic_add32(&slot_tables[header->version_slot], -1);
+      my_atomic_rwlock_wrunlock(&LOCK_table_versions);
+    }
     free_memory_block(table_block);
   }
   DBUG_VOID_RETURN;
@@ -4173,7 +4504,7 @@ void Query_cache::pack_cache()
 {
   DBUG_ENTER("Query_cache::pack_cache");
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
 
   uchar *border = 0;
   Query_cache_block *before = 0;
@@ -4205,7 +4536,7 @@ void Query_cache::pack_cache()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
   DBUG_VOID_RETURN;
 }
 
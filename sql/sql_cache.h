@@ -66,6 +66,9 @@ typedef struct st_changed_table_list CHANGED_TABLE_LIST;
 #define QUERY_CACHE_PACK_ITERATION		2
 #define QUERY_CACHE_PACK_LIMIT			(512*1024L)
 
+/* number of table version counters (see Query_cache::invalidate_table) */
+#define QUERY_CACHE_TABLE_VERSIONS		1024
+
 #define TABLE_COUNTER_TYPE uint
 
 struct Query_cache_block;
@@ -111,6 +114,13 @@ struct Query_cache_block_table
   */
   Query_cache_table *parent;
 
+  /**
+    The version of the table when the query was stored. The query is
+    stale when the table has been changed since, see
+    Query_cache::invalidate_table().
+  */
+  int32 version;
+
   /**
     A method to calculate the address of the query cache block
     owning this node. The purpose of this calculation is to 
@@ -205,6 +215,10 @@ struct Query_cache_table
     If table included in the table hash to be found by other queries
   */
   my_bool hashed;
+  /**
+    The version counter of the table, by the hash of the table key
+  */
+  uint version_slot;
 
   inline char *db()			     { return (char *) data(); }
   inline char *table()			     { return tbl; }
@@ -287,6 +301,12 @@ struct Query_cache_memory_bin_step
   }
 };
 
+struct Query_cache_statistics
+{
+  ulong free_memory_blocks, free_memory, hits, inserts, lowmem_prunes,
+    refused, queries_in_cache, total_blocks;
+};
+
 class Query_cache
 {
 public:
@@ -308,8 +328,32 @@ private:
   enum Cache_staus {OK, DISABLE_REQUEST, DISABLED};
   Cache_staus m_cache_status;
 
+  /*
+    The cache can be split in partitions by the hash of the query. Each
+    partition is a Query_cache of its own with its own lock and memory,
+    and this object only passes the calls on to them.
+  */
+  Query_cache *partitions;
+  uint n_partitions;
+  /*
+    Number of cached tables by version slot. It is changed under the
+    lock and read without it, to skip the partitions that don't have
+    the table when invalidating it.
+  */
+  int32 *slot_tables;
+
   void free_query_internal(Query_cache_block *point);
   void invalidate_table_internal(THD *thd, uchar *key, uint32 key_length);
+  Query_cache *partition(uint i)
+  { return partitions ? partitions + i : this; }
+  Query_cache *partition_for(const uchar *key, ulong key_length);
+  bool has_tables_in_slot(uint slot);
+  void init_partition();
+  void destroy_partition();
+  void insert_query(THD *thd, TABLE_LIST *tables_used,
+                    const char *query, ulong tot_length,
+                    TABLE_COUNTER_TYPE local_tables, uint8 tables_type);
+  int send_cached_result(THD *thd, const char *sql, ulong tot_length);
 
 protected:
   /*
@@ -445,14 +489,24 @@ protected:
 
   inline bool is_disabled(void) { return m_cache_status != OK; }
   inline bool is_disable_in_progress(void)
-  { return m_cache_status == DISABLE_REQUEST; }
+  {
+    for (uint i= 0; i < n_partitions; i++)
+      if (partition(i)->m_cache_status == DISABLE_REQUEST)
+        return TRUE;
+    return FALSE;
+  }
 
   /* initialize cache (mutex) */
-  void init();
+  void init(uint partitions_arg= 1);
   /* resize query cache (return real query size, 0 if disabled) */
   ulong resize(ulong query_cache_size);
   /* set limit on result size */
-  inline void result_size_limit(ulong limit){query_cache_limit=limit;}
+  inline void result_size_limit(ulong limit)
+  {
+    for (uint i= 0; partitions && i < n_partitions; i++)
+      partitions[i].query_cache_limit= limit;
+    query_cache_limit= limit;
+  }
   /* set minimal result data allocation unit size */
   ulong set_min_res_unit(ulong size);
 
@@ -502,6 +556,9 @@ protected:
   void end_of_result(THD *thd);
   void abort(Query_cache_tls *query_cache_tls);
 
+  void get_statistics(Query_cache_statistics *stats);
+  void reset_statistics();
+
   /*
     The following functions are only used when debugging
     We don't protect these with ifndef DBUG_OFF to not have to recompile
@@ -563,7 +620,7 @@ struct Query_cache_query_flags
 #define query_cache_store_query(A, B) query_cache.store_query(A, B)
 #define query_cache_destroy() query_cache.destroy()
 #define query_cache_result_size_limit(A) query_cache.result_size_limit(A)
-#define query_cache_init() query_cache.init()
+#define query_cache_init() query_cache.init(query_cache_partitions)
 #define query_cache_resize(A) query_cache.resize(A)
 #define query_cache_set_min_res_unit(A) query_cache.set_min_res_unit(A)
 #define query_cache_invalidate3(A, B, C) query_cache.invalidate(A, B, C)
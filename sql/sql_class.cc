@@ -862,43 +862,12 @@ bool Drop_table_error_handler::handle_condition(THD *thd,
 THD::THD()
    :Statement(&main_lex, &main_mem_root, STMT_CONVENTIONAL_EXECUTION,
               /* statement id */ 0),
-   rli_fake(0), rgi_fake(0), rgi_slave(NULL),
-   in_sub_stmt(0), log_all_errors(0),
-   binlog_unsafe_warning_flags(0),
-   binlog_table_maps(0),
-   table_map_for_update(0),
-   arg_of_last_insert_id_function(FALSE),
-   first_successful_insert_id_in_prev_stmt(0),
-   first_successful_insert_id_in_prev_stmt_for_binlog(0),
-   first_successful_insert_id_in_cur_stmt(0),
-   stmt_depends_on_first_successful_insert_id_in_prev_stmt(FALSE),
-   m_examined_row_count(0),
-   accessed_rows_and_keys(0),
-   m_statement_psi(NULL),
-   m_idle_psi(NULL),
-   m_server_idle(false),
-   thread_id(0),
-   global_disable_checkpoint(0),
-   failed_com_change_user(0),
-   is_fatal_error(0),
-   transaction_rollback_request(0),
-   is_fatal_sub_stmt_error(0),
-   rand_used(0),
-   time_zone_used(0),
-   in_lock_tables(0),
-   bootstrap(0),
-   derived_tables_processing(FALSE),
-   spcont(NULL),
-   m_parser_state(NULL),
 #if defined(ENABLED_DEBUG_SYNC)
    debug_sync_control(0),
 #endif /* defined(ENABLED_DEBUG_SYNC) */
-   wait_for_commit_ptr(0),
     main_da(0, false, false),
    m_stmt_da(&main_da)
 {
-  ulong tmp;
-
   mdl_context.init(this);
   /*
     We set THR_THD to temporally point to this THD to register all the
@@ -917,6 +886,84 @@ THD::THD()
   init_sql_alloc(&main_mem_root, ALLOC_ROOT_MIN_BLOCK_SIZE, 0,
                  MYF(MY_THREAD_SPECIFIC));
 
+#ifndef DBUG_OFF
+  dbug_sentry=THD_SENTRY_MAGIC;
+#endif
+  mysql_mutex_init(key_LOCK_thd_data, &LOCK_thd_data, MY_MUTEX_INIT_FAST);
+  mysql_mutex_init(key_LOCK_wakeup_ready, &LOCK_wakeup_ready, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_wakeup_ready, &COND_wakeup_ready, 0);
+  /*
+    LOCK_thread_count goes before LOCK_thd_data - the former is called around
+    'delete thd', the latter - in THD::~THD
+  */
+  mysql_mutex_record_order(&LOCK_thread_count, &LOCK_thd_data);
+  main_security_ctx.init();
+
+  init_connection_state();
+#if defined(ENABLED_PROFILING)
+  profiling.set_thd(this);
+#endif
+
+  /* Protocol */
+  protocol_text.init(this);
+  protocol_binary.init(this);
+
+  /* Restore THR_THD */
+  set_current_thd(old_THR_THD);
+}
+
+
+/*
+  Initialize the state that belongs to one client connection
+
+  SYNOPSIS
+    init_connection_state()
+
+  NOTES
+    Called by the constructor, and by reset_for_reuse() for a THD taken
+    from the connection cache. The mutexes, the MDL context, the memory
+    roots and the security context are set up by the constructor only.
+*/
+
+void THD::init_connection_state()
+{
+  ulong tmp;
+
+  rli_fake= 0;
+  rgi_fake= 0;
+  rgi_slave= NULL;
+  in_sub_stmt= 0;
+  log_all_errors= 0;
+  binlog_unsafe_warning_flags= 0;
+  binlog_table_maps= 0;
+  table_map_for_update= 0;
+  arg_of_last_insert_id_function= FALSE;
+  first_successful_insert_id_in_prev_stmt= 0;
+  first_successful_insert_id_in_prev_stmt_for_binlog= 0;
+  first_successful_insert_id_in_cur_stmt= 0;
+  stmt_depends_on_first_successful_insert_id_in_prev_stmt= FALSE;
+  auto_inc_intervals_in_cur_stmt_for_binlog.empty();
+  auto_inc_intervals_forced.empty();
+  m_examined_row_count= 0;
+  accessed_rows_and_keys= 0;
+  m_statement_psi= NULL;
+  m_idle_psi= NULL;
+  m_server_idle= false;
+  thread_id= 0;
+  global_disable_checkpoint= 0;
+  failed_com_change_user= 0;
+  is_fatal_error= 0;
+  transaction_rollback_request= 0;
+  is_fatal_sub_stmt_error= 0;
+  rand_used= 0;
+  time_zone_used= 0;
+  in_lock_tables= 0;
+  bootstrap= 0;
+  derived_tables_processing= FALSE;
+  spcont= NULL;
+  m_parser_state= NULL;
+  wait_for_commit_ptr= 0;
+
   stmt_arena= this;
   thread_stack= 0;
   scheduler= thread_scheduler;                 // Will be fixed later
@@ -925,7 +972,6 @@ THD::THD()
   skip_wait_timeout= false;
   extra_port= 0;
   catalog= (char*)"std"; // the only catalog we have for now
-  main_security_ctx.init();
   security_ctx= &main_security_ctx;
   no_errors= 0;
   password= 0;
@@ -967,15 +1013,15 @@ THD::THD()
   enable_slow_log= 0;
   durability_property= HA_REGULAR_DURABILITY;
 
-#ifndef DBUG_OFF
-  dbug_sentry=THD_SENTRY_MAGIC;
-#endif
 #ifndef EMBEDDED_LIBRARY
   mysql_audit_init_thd(this);
 #endif
   net.vio=0;
   net.buff= 0;
+  net.compress_stream= 0;
+  net.extension= 0;                             // see net_end()
   client_capabilities= 0;                       // minimalistic client
+  client_ext_capabilities= 0;
   system_thread= NON_SYSTEM_THREAD;
   cleanup_done= abort_on_warning= 0;
   peer_port= 0;					// For SHOW PROCESSLIST
@@ -988,14 +1034,6 @@ THD::THD()
 #ifdef SIGNAL_WITH_VIO_CLOSE
   active_vio = 0;
 #endif
-  mysql_mutex_init(key_LOCK_thd_data, &LOCK_thd_data, MY_MUTEX_INIT_FAST);
-  mysql_mutex_init(key_LOCK_wakeup_ready, &LOCK_wakeup_ready, MY_MUTEX_INIT_FAST);
-  mysql_cond_init(key_COND_wakeup_ready, &COND_wakeup_ready, 0);
-  /*
-    LOCK_thread_count goes before LOCK_thd_data - the former is called around
-    'delete thd', the latter - in THD::~THD
-  */
-  mysql_mutex_record_order(&LOCK_thread_count, &LOCK_thd_data);
 
   /* Variables with default values */
   proc_info="login";
@@ -1009,13 +1047,11 @@ THD::THD()
   reset_open_tables_state(this);
 
   init();
-#if defined(ENABLED_PROFILING)
-  profiling.set_thd(this);
-#endif
   user_connect=(USER_CONN *)0;
   my_hash_init(&user_vars, system_charset_info, USER_VARS_HASH_SIZE, 0, 0,
                (my_hash_get_key) get_var_key,
                (my_hash_free_key) free_user_var, HASH_THREAD_SPECIFIC);
+  my_hash_clear(&normalized_stmts);
 
   sp_proc_cache= NULL;
   sp_func_cache= NULL;
@@ -1027,10 +1063,7 @@ THD::THD()
   else
     bzero((char*) &user_var_events, sizeof(user_var_events));
 
-  /* Protocol */
   protocol= &protocol_text;			// Default protocol
-  protocol_text.init(this);
-  protocol_binary.init(this);
 
   tablespace_op=FALSE;
 
@@ -1053,8 +1086,6 @@ THD::THD()
   prepare_derived_at_open= FALSE;
   create_tmp_table_for_derived= FALSE;
   save_prep_leaf_list= FALSE;
-  /* Restore THR_THD */
-  set_current_thd(old_THR_THD);
 }
 
 
@@ -1553,6 +1584,7 @@ void THD::cleanup(void)
 
   delete_dynamic(&user_var_events);
   my_hash_free(&user_vars);
+  my_hash_free(&normalized_stmts);
   sp_cache_clear(&sp_proc_cache);
   sp_cache_clear(&sp_func_cache);
 
@@ -1638,6 +1670,117 @@ THD::~THD()
 }
 
 
+/*
+  Free everything that belongs to the connection, but not the THD itself
+
+  SYNOPSIS
+    free_connection()
+
+  NOTES
+    This is the part of ~THD() that is done when the THD is put in the
+    connection cache instead of being deleted. cleanup() must have been
+    called. The mutexes, the MDL context and the preallocated blocks of
+    the memory roots are kept for the next connection, which will call
+    reset_for_reuse() before using the object.
+*/
+
+void THD::free_connection()
+{
+  THD *orig_thd= current_thd;
+  THD_CHECK_SENTRY(this);
+  DBUG_ENTER("THD::free_connection");
+  DBUG_ASSERT(cleanup_done);
+  DBUG_ASSERT(!mdl_context.has_locks());
+
+  /* Memory freed below is accounted to this THD */
+  set_current_thd(this);
+
+  /* Ensure that no one is using THD */
+  mysql_mutex_lock(&LOCK_thd_data);
+  mysql_mutex_unlock(&LOCK_thd_data);
+
+#ifndef EMBEDDED_LIBRARY
+  if (net.vio)
+    vio_delete(net.vio);
+  net.vio= 0;
+  net_end(&net);
+#endif
+  stmt_map.reset();                     /* close all prepared statements */
+
+  ha_close_connection(this);
+  mysql_audit_release(this);
+  plugin_thdvar_cleanup(this);
+
+  main_security_ctx.destroy();
+  main_security_ctx.init();
+  my_free(db);
+  db= NULL;
+  db_length= 0;
+  free_root(&transaction.mem_root, MYF(MY_KEEP_PREALLOC));
+#ifndef EMBEDDED_LIBRARY
+  if (rgi_fake)
+  {
+    delete rgi_fake;
+    rgi_fake= NULL;
+  }
+  if (rli_fake)
+  {
+    delete rli_fake;
+    rli_fake= NULL;
+  }
+  mysql_audit_free_thd(this);
+#endif
+#if defined(ENABLED_PROFILING)
+  profiling.restart();
+#endif
+
+  free_root(&main_mem_root, MYF(MY_KEEP_PREALLOC));
+  m_stmt_da= &main_da;
+  main_da.reset_diagnostics_area();
+  main_da.clear_warning_info(0);
+
+  set_current_thd(orig_thd);
+  DBUG_VOID_RETURN;
+}
+
+
+/*
+  Prepare a THD from the connection cache for a new connection
+
+  SYNOPSIS
+    reset_for_reuse()
+
+  NOTES
+    Redoes the per connection initialization of THD::THD() on an object
+    that has been through free_connection(). Anything that the
+    constructor sets up for a connection must be done in
+    init_connection_state(), which is called by both.
+*/
+
+void THD::reset_for_reuse()
+{
+  THD *orig_thd= current_thd;
+  THD_CHECK_SENTRY(this);
+  DBUG_ENTER("THD::reset_for_reuse");
+  set_current_thd(this);
+
+  /* The Statement part, set by its constructor for a new THD */
+  id= 0;
+  mark_used_columns= MARK_COLUMNS_READ;
+  lex= &main_lex;
+  mem_root= &main_mem_root;
+  free_list= 0;
+  state= STMT_CONVENTIONAL_EXECUTION;
+  name.str= NULL;
+  reset_query();
+
+  init_connection_state();
+
+  set_current_thd(orig_thd);
+  DBUG_VOID_RETURN;
+}
+
+
 /*
   Add all status variables to another status variable array
 
@@ -1709,6 +1852,166 @@ void add_diff_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
   to_var->busy_time+=            from_var->busy_time - dec_var->busy_time;
 }
 
+/*
+  Global status counters of the threads.
+
+  A thread counts its statistics in THD::status_var without any locking
+  and adds what has changed since the last time to the global status
+  with THD::add_status_to_global(), after every command and when it
+  ends. The global counters are kept in one slab per CPU, each padded
+  to its own cache lines, and are updated with atomic additions into
+  the slab of the CPU the thread runs on. So adding to the global status
+  takes no lock, and threads on different CPUs don't share cache lines.
+
+  SHOW GLOBAL STATUS sums the slabs, see calc_sum_of_all_status(). It
+  doesn't need to walk the list of all threads under LOCK_thread_count
+  any more, which stalled new connections while the status was read.
+*/
+
+struct global_status_slab
+{
+  STATUS_VAR status;
+} MY_ALIGNED(64);
+
+static global_status_slab *global_status_slabs;
+static uint global_status_slab_count;
+/* my_malloc() doesn't align to cache lines, this is what it returned */
+static void *global_status_slabs_buf;
+
+bool init_global_status_slabs()
+{
+  DBUG_ENTER("init_global_status_slabs");
+  global_status_slab_count= MY_MAX(my_getncpus(), 1);
+  global_status_slabs_buf=
+    my_malloc(global_status_slab_count * sizeof(global_status_slab) + 63,
+              MYF(MY_WME | MY_ZEROFILL));
+  if (!global_status_slabs_buf)
+  {
+    global_status_slab_count= 0;
+    DBUG_RETURN(TRUE);
+  }
+  global_status_slabs= (global_status_slab*)
+    MY_ALIGN((size_t) global_status_slabs_buf, 64);
+  DBUG_RETURN(FALSE);
+}
+
+
+void free_global_status_slabs()
+{
+  global_status_slab_count= 0;
+  my_free(global_status_slabs_buf);
+  global_status_slabs_buf= NULL;
+  global_status_slabs= NULL;
+}
+
+
+/*
+  Add the global status counters of all slabs to a status array
+
+  NOTES
+    The slabs are read without locks while other threads add to them,
+    so the sum is not a consistent snapshot of one point in time.
+*/
+
+void add_global_status_slabs(STATUS_VAR *to_var)
+{
+  for (uint i= 0; i < global_status_slab_count; i++)
+    add_to_status(to_var, &global_status_slabs[i].status);
+}
+
+
+#if SIZEOF_LONG == 8
+#define status_atomic_add(A, V) \
+  my_atomic_add64((int64 volatile *) (A), (int64) (V))
+#else
+#define status_atomic_add(A, V) \
+  my_atomic_add32((int32 volatile *) (A), (int32) (V))
+#endif
+
+static inline void status_atomic_add_ulonglong(ulonglong *to, ulonglong *from,
+                                               ulonglong *in_global)
+{
+  if (*from != *in_global)
+  {
+    my_atomic_add64((int64 volatile *) to, (int64) (*from - *in_global));
+    *in_global= *from;
+  }
+}
+
+static inline void status_atomic_add_double(double *to, double *from,
+                                            double *in_global)
+{
+  if (*from != *in_global)
+  {
+    union { double d; int64 i; } old_val, new_val;
+    old_val.i= my_atomic_load64((int64 volatile *) to);
+    do
+      new_val.d= old_val.d + (*from - *in_global);
+    while (!my_atomic_cas64((int64 volatile *) to, &old_val.i, new_val.i));
+    *in_global= *from;
+  }
+}
+
+
+/*
+  Add the changes of status_var since the last call to the global status
+
+  NOTES
+    This is cheap when little has changed: only the counters that differ
+    from status_in_global are added, with an atomic addition each, to the
+    slab of the current CPU.
+*/
+
+void THD::add_status_to_global()
+{
+  uint slab;
+  if (unlikely(!global_status_slab_count))
+    return;
+#ifdef HAVE_SCHED_GETCPU
+  int cpu= sched_getcpu();
+  slab= (uint) (cpu >= 0 ? cpu : thread_id) % global_status_slab_count;
+#else
+  slab= (uint) (thread_id % global_status_slab_count);
+#endif
+  STATUS_VAR *to_var= &global_status_slabs[slab].status;
+
+  ulong *end= (ulong*) ((uchar*) &status_var +
+                        offsetof(STATUS_VAR, last_system_status_var) +
+                        sizeof(ulong));
+  ulong *to= (ulong*) to_var, *from= (ulong*) &status_var;
+  ulong *in_global= (ulong*) &status_in_global;
+
+  for (; from != end; to++, from++, in_global++)
+  {
+    if (*from != *in_global)
+    {
+      status_atomic_add(to, *from - *in_global);
+      *in_global= *from;
+    }
+  }
+
+  /* Handle the not ulong variables. See end of system_status_var */
+  status_atomic_add_ulonglong(&to_var->bytes_received,
+                              &status_var.bytes_received,
+                              &status_in_global.bytes_received);
+  status_atomic_add_ulonglong(&to_var->bytes_sent, &status_var.bytes_sent,
+                              &status_in_global.bytes_sent);
+  status_atomic_add_ulonglong(&to_var->rows_read, &status_var.rows_read,
+                              &status_in_global.rows_read);
+  status_atomic_add_ulonglong(&to_var->rows_sent, &status_var.rows_sent,
+                              &status_in_global.rows_sent);
+  status_atomic_add_ulonglong(&to_var->rows_tmp_read,
+                              &status_var.rows_tmp_read,
+                              &status_in_global.rows_tmp_read);
+  status_atomic_add_ulonglong(&to_var->binlog_bytes_written,
+                              &status_var.binlog_bytes_written,
+                              &status_in_global.binlog_bytes_written);
+  status_atomic_add_double(&to_var->cpu_time, &status_var.cpu_time,
+                           &status_in_global.cpu_time);
+  status_atomic_add_double(&to_var->busy_time, &status_var.busy_time,
+                           &status_in_global.busy_time);
+}
+
 #define SECONDS_TO_WAIT_FOR_KILL 2
 #if !defined(__WIN__) && defined(HAVE_SELECT)
 /* my_sleep() can wait for sub second times */
@@ -2539,7 +2842,7 @@ int select_send::send_data(List<Item> &items)
   */
   ha_release_temporary_latches(thd);
 
-  protocol->prepare_for_resend();
+  protocol->start_row();
   if (protocol->send_result_set_row(&items))
   {
     protocol->remove_last_row();
@@ -2548,10 +2851,7 @@ int select_send::send_data(List<Item> &items)
 
   thd->inc_sent_row_count(1);
 
-  if (thd->vio_ok())
-    DBUG_RETURN(protocol->write());
-
-  DBUG_RETURN(0);
+  DBUG_RETURN(protocol->end_row());
 }
 
 
@@ -3804,6 +4104,8 @@ void THD::set_status_var_init()
 {
   bzero((char*) &status_var, offsetof(STATUS_VAR,
                                       last_cleared_system_status_var));
+  bzero((char*) &status_in_global, offsetof(STATUS_VAR,
+                                            last_cleared_system_status_var));
 }
 
 
@@ -376,6 +376,7 @@ class MY_LOCALE;
 */
 
 struct Query_cache_block;
+class Query_cache;
 
 struct Query_cache_tls
 {
@@ -384,12 +385,14 @@ struct Query_cache_tls
     functions and methods to maintain proper locking.
   */
   Query_cache_block *first_query_block;
+  /* The partition of the query cache that has first_query_block */
+  Query_cache *partition;
   void set_first_query_block(Query_cache_block *first_query_block_arg)
   {
     first_query_block= first_query_block_arg;
   }
 
-  Query_cache_tls() :first_query_block(NULL) {}
+  Query_cache_tls() :first_query_block(NULL), partition(NULL) {}
 };
 
 /* SIGNAL / RESIGNAL / GET DIAGNOSTICS */
@@ -526,6 +529,7 @@ typedef struct system_variables
   ulong max_error_count;
   ulong max_length_for_sort_data;
   ulong max_sort_length;
+  ulong max_sort_threads;
   ulong max_tmp_tables;
   ulong max_insert_delayed_threads;
   ulong min_examined_row_limit;
@@ -533,6 +537,7 @@ typedef struct system_variables
   ulong net_buffer_length;
   ulong net_interactive_timeout;
   ulong net_read_timeout;
+  ulong net_result_buffer_length;
   ulong net_retry_count;
   ulong net_wait_timeout;
   ulong net_write_timeout;
@@ -554,6 +559,7 @@ typedef struct system_variables
   ulong max_sp_recursion_depth;
   ulong default_week_format;
   ulong max_seeks_for_key;
+  ulong normalized_stmt_cache_size;
   ulong range_alloc_block_size;
   ulong query_alloc_block_size;
   ulong query_prealloc_size;
@@ -605,6 +611,7 @@ typedef struct system_variables
   my_bool old_passwords;
   my_bool big_tables;
   my_bool query_cache_strip_comments;
+  my_bool prepared_stmt_plan_cache;
 
   plugin_ref table_plugin;
 
@@ -698,6 +705,7 @@ typedef struct system_status_var
   ulong executed_triggers;
   ulong long_query_count;
   ulong filesort_merge_passes_;
+  ulong filesort_radix_count_;
   ulong filesort_range_count_;
   ulong filesort_rows_;
   ulong filesort_scan_count_;
@@ -709,6 +717,8 @@ typedef struct system_status_var
   ulong com_stmt_fetch;
   ulong com_stmt_reset;
   ulong com_stmt_close;
+  ulong ps_plan_cache_hits;         /* +1 when a saved join order is used */
+  ulong normalized_stmt_cache_hits;
 
   /* Features used */
   ulong feature_dynamic_columns;    /* +1 when creating a dynamic column */
@@ -759,6 +769,10 @@ void add_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var);
 void add_diff_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
                         STATUS_VAR *dec_var);
 
+bool init_global_status_slabs();
+void free_global_status_slabs();
+void add_global_status_slabs(STATUS_VAR *to_var);
+
 void mark_transaction_to_rollback(THD *thd, bool all);
 
 
@@ -1856,6 +1870,8 @@ public:
   struct  my_rnd_struct rand;		// used for authentication
   struct  system_variables variables;	// Changeable local variables
   struct  system_status_var status_var; // Per thread statistic vars
+  /* The part of status_var already added to the global status */
+  struct  system_status_var status_in_global;
   struct  system_status_var org_status_var; // For user statistics
   struct  system_status_var *initial_status_var; /* used by show status */
   THR_LOCK_INFO lock_info;              // Locking info of this thread
@@ -1871,6 +1887,8 @@ public:
 
   /* all prepared statements and cursors of this connection */
   Statement_map stmt_map;
+  /* text protocol statements prepared by the normalized statement cache */
+  HASH normalized_stmts;
   /*
     A pointer to the stack frame of handle_one_connection(),
     which is called first in the thread for handling a client
@@ -1933,6 +1951,7 @@ public:
   const char *where;
 
   ulong client_capabilities;		/* What the client supports */
+  ulong client_ext_capabilities;        /* CLIENT_EXT_* the client supports */
   ulong max_client_packet_length;
 
   HASH		handler_tables_hash;
@@ -2768,6 +2787,16 @@ public:
   void update_stats(void);
   void change_user(void);
   void cleanup(void);
+  /*
+    free_connection() releases everything a connection owns but keeps the
+    object, its mutexes and the preallocated blocks of its memory roots,
+    so that the THD can be parked in the connection cache.
+    reset_for_reuse() brings such a THD back to the state of a freshly
+    constructed one.
+  */
+  void free_connection();
+  void reset_for_reuse();
+  void init_connection_state();
   void cleanup_after_query();
   bool store_globals();
   void reset_globals();
@@ -3621,12 +3650,7 @@ public:
   /* Wake this thread up from wait_for_wakeup_ready(). */
   void signal_wakeup_ready();
 
-  void add_status_to_global()
-  {
-    mysql_mutex_lock(&LOCK_status);
-    add_to_status(&global_status_var, &status_var);
-    mysql_mutex_unlock(&LOCK_status);
-  }
+  void add_status_to_global();
 
   wait_for_commit *wait_for_commit_ptr;
   int wait_for_prior_commit()
@@ -4419,6 +4443,7 @@ typedef struct st_sort_field {
   Item_result result_type;		/* Type of item */
   bool reverse;				/* if descending sort */
   bool need_strxnfrm;			/* If we have to use strxnfrm() */
+  uchar *pad_image;                     /* Set if the key part is packed */
 } SORT_FIELD;
 
 
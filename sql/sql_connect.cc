@@ -1210,7 +1210,18 @@ void prepare_new_connection_state(THD* thd)
   Security_context *sctx= thd->security_ctx;
 
   if (thd->client_capabilities & CLIENT_COMPRESS)
+  {
     thd->net.compress=1;				// Use compression
+#ifdef HAVE_COMPRESS
+    if ((thd->client_ext_capabilities & CLIENT_EXT_COMPRESS_STREAM) &&
+        !(thd->net.compress_stream=
+          my_compress_stream_alloc((int) net_compression_level)))
+    {
+      thd->killed= KILL_CONNECTION;
+      return;
+    }
+#endif
+  }
 
   /*
     Much of this is duplicated in create_embedded_thd() for the
@@ -648,6 +648,12 @@ void Explain_table_access::append_tag_name(String *str, enum explain_extra_tag t
       str->append(STRING_WITH_LEN(", "));
       str->append(bka_type.join_alg);
       str->append(STRING_WITH_LEN(" join"));
+      if (bka_type.passes > 1)
+      {
+        str->append(STRING_WITH_LEN(", "));
+        str->append_ulonglong(bka_type.passes);
+        str->append(STRING_WITH_LEN(" passes"));
+      }
       str->append(STRING_WITH_LEN(")"));
       if (bka_type.mrr_type.length())
         str->append(bka_type.mrr_type);
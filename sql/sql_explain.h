@@ -325,6 +325,12 @@ typedef struct st_explain_bka_type
   bool incremental;
   const char *join_alg;
   StringBuffer<64> mrr_type;
+  /*
+    Expected number of passes over the records of the joined table when
+    they are re-read from a temporary file for each refill of the join
+    buffer, 0 if the records are not saved
+  */
+  uint passes;
 
 } EXPLAIN_BKA_TYPE;
 
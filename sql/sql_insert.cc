@@ -2912,6 +2912,7 @@ pthread_handler_t handle_delayed_insert(void *arg)
           /* Some fatal error */
           thd->killed= KILL_CONNECTION;
         }
+        thd->add_status_to_global();
       }
       di->status=0;
       if (!di->stacked_inserts && !di->tables_in_use && thd->lock)
@@ -2571,6 +2571,7 @@ finish:
 void JOIN_CACHE::save_explain_data(struct st_explain_bka_type *explain)
 {
   explain->incremental= MY_TEST(prev_cache);
+  explain->passes= 0;
 
   switch (get_join_alg()) {
   case BNL_JOIN_ALG:
@@ -2600,6 +2601,48 @@ THD *JOIN_CACHE::thd()
 }
 
 
+/* 
+  Prepare the join cache for another execution of the join
+
+  SYNOPSIS
+    reinit()
+
+  DESCRIPTION
+    The function is called when the join is going to be executed again,
+    e.g. for a correlated subquery. The records of join_tab saved by
+    the table scan object in the previous execution may not be valid
+    anymore and they are discarded.
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE::reinit()
+{
+  if (join_tab_scan)
+    join_tab_scan->reinit();
+}
+
+
+/* 
+  Free the join buffer and the resources used by the table scan object
+
+  SYNOPSIS
+    free()
+
+  RETURN VALUE
+    none
+*/
+
+void JOIN_CACHE::free()
+{
+  my_free(buff);
+  buff= 0;
+  if (join_tab_scan)
+    join_tab_scan->cleanup();
+}
+
+
 static void add_mrr_explain_info(String *str, uint mrr_mode, handler *file)
 {
   char mrr_str_buf[128]={0};
@@ -2676,7 +2719,7 @@ int JOIN_CACHE_HASHED::init()
   ref_key_info= join_tab->get_keyinfo_by_key_no(join_tab->ref.key);
   ref_used_key_parts= join_tab->ref.key_parts;
 
-  hash_func= &JOIN_CACHE_HASHED::get_hash_idx_simple;
+  hash_func= &JOIN_CACHE_HASHED::get_hash_value_simple;
   hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_simple;
 
   KEY_PART_INFO *key_part= ref_key_info->key_part;
@@ -2685,7 +2728,7 @@ int JOIN_CACHE_HASHED::init()
   {
     if (!key_part->field->eq_cmp_as_binary())
     {
-      hash_func= &JOIN_CACHE_HASHED::get_hash_idx_complex;
+      hash_func= &JOIN_CACHE_HASHED::get_hash_value_complex;
       hash_cmp_func= &JOIN_CACHE_HASHED::equal_keys_complex;
       break;
     }
@@ -2737,6 +2780,7 @@ int JOIN_CACHE_HASHED::init_hash_table()
   {    
     key_entry_length= get_size_of_rec_offset() + // key chain header
                       size_of_key_ofs +          // reference to the next key 
+                      JOIN_CACHE_KEY_FINGERPRINT_LENGTH +
                       (use_emb_key ?  get_size_of_rec_offset() : key_length);
 
     ulong space_per_rec= avg_record_length +
@@ -2826,6 +2870,7 @@ uint JOIN_CACHE_HASHED::get_max_key_addon_space_per_record()
   len= (use_emb_key ?  get_size_of_rec_offset() : ref->key_length) +
         size_of_rec_ofs +    // size of the key chain header
         size_of_rec_ofs +    // >= size of the reference to the next key 
+        JOIN_CACHE_KEY_FINGERPRINT_LENGTH +
         2*size_of_rec_ofs;   // >= 2*( size of hash table entry)
   return len; 
 }    
@@ -2891,6 +2936,7 @@ bool JOIN_CACHE_HASHED::put_record()
   uchar *key;
   uint key_len= key_length;
   uchar *key_ref_ptr;
+  uint32 key_fingerprint;
   uchar *link= 0;
   TABLE_REF *ref= &join_tab->ref;
   uchar *next_ref_ptr= pos;
@@ -2914,7 +2960,7 @@ bool JOIN_CACHE_HASHED::put_record()
   }
 
   /* Look for the key in the hash table */
-  if (key_search(key, key_len, &key_ref_ptr))
+  if (key_search(key, key_len, &key_ref_ptr, &key_fingerprint))
   {
     uchar *last_next_ref_ptr;
     /* 
@@ -2946,6 +2992,8 @@ bool JOIN_CACHE_HASHED::put_record()
     store_null_key_ref(cp);
     store_next_rec_ref(next_ref_ptr, next_ref_ptr);
     store_next_rec_ref(cp+get_size_of_key_offset(), next_ref_ptr);
+    cp-= JOIN_CACHE_KEY_FINGERPRINT_LENGTH;
+    int4store(cp, key_fingerprint);
     if (use_emb_key)
     {
       cp-= get_size_of_rec_offset();
@@ -3058,6 +3106,8 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
                       a position where the reference to the the hash 
                       element for the key is to be added in the
                       case when the key has not been found
+      key_fingerprint OUT if not NULL, the fingerprint of the hash value
+                      of the key to be stored in a new hash element
       
   DESCRIPTION
     The function looks for a key in the hash table of the join buffer.
@@ -3065,6 +3115,11 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
     to the next key from  to the hash element for the given key. 
     Otherwise the function returns the position where the reference to the
     newly created hash element for the given key is to be added.  
+    The key values of the hash elements in the chain are compared with
+    the given key only if their fingerprints coincide with the fingerprint
+    of the hash value of the key. This saves a random access to the key
+    value (that is located in the record when use_emb_key is set) and 
+    a call of the comparison function for almost all non-matching elements.
 
   RETURN VALUE
     TRUE    the key is found in the hash table
@@ -3072,17 +3127,25 @@ bool JOIN_CACHE_HASHED::skip_if_not_needed_match()
 */
 
 bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
-                                   uchar **key_ref_ptr) 
+                                   uchar **key_ref_ptr,
+                                   uint32 *key_fingerprint) 
 {
   bool is_found= FALSE;
-  uint idx= (this->*hash_func)(key, key_length);
+  ulong hash_value= (this->*hash_func)(key, key_length);
+  uint32 fingerprint= (uint32) hash_value;
+  uint idx= (uint) (hash_value % hash_entries);
   uchar *ref_ptr= hash_table+size_of_key_ofs*idx;
   while (!is_null_key_ref(ref_ptr))
   {
     uchar *next_key;
+    uchar *fingerprint_ptr;
     ref_ptr= get_next_key_ref(ref_ptr);
-    next_key= use_emb_key ? get_emb_key(ref_ptr-get_size_of_rec_offset()) :
-                            ref_ptr-key_length;
+    fingerprint_ptr= ref_ptr-JOIN_CACHE_KEY_FINGERPRINT_LENGTH;
+    if (uint4korr(fingerprint_ptr) != fingerprint)
+      continue;
+    next_key= use_emb_key ?
+              get_emb_key(fingerprint_ptr-get_size_of_rec_offset()) :
+              fingerprint_ptr-key_length;
 
     if ((this->*hash_cmp_func)(next_key, key, key_len))
     {
@@ -3091,6 +3154,8 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
     }
   }
   *key_ref_ptr= ref_ptr;
+  if (key_fingerprint)
+    *key_fingerprint= fingerprint;
   return is_found;
 } 
 
@@ -3099,21 +3164,23 @@ bool JOIN_CACHE_HASHED::key_search(uchar *key, uint key_len,
   Hash function that considers a key in the hash table as byte array
 
   SYNOPSIS
-    get_hash_idx_simple()
+    get_hash_value_simple()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It considers the key just as
-    a sequence of bytes of the length key_len.
+    The function calculates the hash value for the given key. It considers
+    the key just as a sequence of bytes of the length key_len.
+    The index of the hash entry for the key in the hash table of the join
+    buffer is the hash value modulo the number of hash entries, while the
+    lower 32 bits of the value are used as the fingerprint of the key.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_value_simple(uchar* key, uint key_len)
 {
   ulong nr= 1;
   ulong nr2= 4;
@@ -3124,7 +3191,7 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     nr^= (ulong) ((((uint) nr & 63)+nr2)*((uint) *pos))+ (nr << 8);
     nr2+= 3;
   }
-  return nr % hash_entries;
+  return nr;
 }
 
 
@@ -3132,14 +3199,14 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
   Hash function that takes into account collations of the components of the key  
 
   SYNOPSIS
-    get_hash_idx_complex()
+    get_hash_value_complex()
       key             pointer to the key value
       key_len         key value length
       
   DESCRIPTION
-    The function calculates an index of the hash entry in the hash table
-    of the join buffer for the given key. It takes into account that the
-    components of the key may be of a varchar type with different collations.
+    The function calculates the hash value for the given key. It takes
+    into account that the components of the key may be of a varchar type
+    with different collations.
     The function guarantees that the same hash value for any two equal
     keys that may differ as byte sequences.
     The function takes the info about the components of the key, their
@@ -3148,14 +3215,13 @@ uint JOIN_CACHE_HASHED::get_hash_idx_simple(uchar* key, uint key_len)
     operation.
 
   RETURN VALUE
-    the calculated index of the hash entry for the given key  
+    the calculated hash value for the given key  
 */
 
 inline
-uint JOIN_CACHE_HASHED::get_hash_idx_complex(uchar *key, uint key_len)
+ulong JOIN_CACHE_HASHED::get_hash_value_complex(uchar *key, uint key_len)
 {
-  return 
-    (uint) (key_hashnr(ref_key_info, ref_used_key_parts, key) % hash_entries);
+  return key_hashnr(ref_key_info, ref_used_key_parts, key);
 }
 
 
@@ -3445,6 +3511,174 @@ void JOIN_TAB_SCAN::close()
 }
 
 
+/* 
+  Initiate an iteration process over records in the joined table
+
+  SYNOPSIS
+    open()
+
+  DESCRIPTION
+    If all records of join_tab that meet the pushed condition have been
+    saved in the temporary file by one of the previous scans the function
+    just prepares the file for reading. Otherwise it initiates a scan of
+    the table and starts saving the records if this is not the first scan
+    of the current join execution, or if the join buffer is expected to be
+    refilled.
+
+  RETURN VALUE   
+    0            the initiation is a success 
+    error code   otherwise     
+*/
+
+int JOIN_TAB_SCAN_SPILL::open()
+{
+  int err;
+  scans++;
+  scan_is_complete= FALSE;
+  if (spill_state == SPILL_READY)
+  {
+    save_or_restore_used_tabs(join_tab, FALSE);
+    if (!reinit_io_cache(&spill_file, READ_CACHE, 0L, 0, 0))
+      return 0;
+    /* Fall back to the scan of the table if the file cannot be read */
+    spill_state= SPILL_FAILED;
+  }
+  if (spill_state == SPILL_NONE && (expect_refills || scans > 1))
+  {
+    if ((my_b_inited(&spill_file) ||
+         !open_cached_file(&spill_file, mysql_tmpdir, TEMP_PREFIX,
+                           DISK_BUFFER_SIZE, MYF(0))) &&
+        !reinit_io_cache(&spill_file, WRITE_CACHE, 0L, 0, 0))
+      spill_state= SPILL_WRITING;
+    else
+      spill_state= SPILL_FAILED;
+  }
+  err= JOIN_TAB_SCAN::open();
+  if (err < 0)
+    scan_is_complete= TRUE;
+  return err;
+}
+
+
+/* 
+  Read the next record that can match while scanning the joined table
+
+  SYNOPSIS
+    next()
+
+  DESCRIPTION
+    The function reads the next record of join_tab that meets the condition
+    pushed to the table either from the temporary file, or, if the records
+    have not been saved yet, from the table itself. In the latter case
+    the record is saved in the file if the current scan does so.
+    A failure to write into the file is not an error: the records of the
+    table will be just scanned again for the next refill.
+
+  NOTES
+    A record read from the file is counted for LIMIT ROWS EXAMINED as if
+    it was read from the table, and the function catches the signal that
+    kills the query.
+
+  RETURN VALUE   
+    0            the next record exists and has been successfully read 
+    error code   otherwise     
+*/
+
+int JOIN_TAB_SCAN_SPILL::next()
+{
+  int err;
+  TABLE *table= join_tab->table;
+
+  if (spill_state == SPILL_READY)
+  {
+    THD *thd= join->thd;
+    if (my_b_read(&spill_file, table->record[0], table->s->reclength))
+      return spill_file.error ? 1 : -1;
+    table->status= 0;
+    thd->check_limit_rows_examined();
+    if (thd->check_killed())
+      return 1;
+    return 0;
+  }
+
+  err= JOIN_TAB_SCAN::next();
+  if (spill_state == SPILL_WRITING)
+  {
+    if (!err)
+    {
+      if (my_b_write(&spill_file, table->record[0], table->s->reclength))
+        spill_state= SPILL_FAILED;
+    }
+    else if (err < 0)
+      scan_is_complete= TRUE;
+  }
+  return err;
+}
+
+
+/* 
+  Perform finalizing actions for a scan over the table records
+
+  SYNOPSIS
+    close()
+
+  DESCRIPTION
+    If the records have been saved during the scan that has reached the end
+    of join_tab the temporary file is marked as ready to be read by the next
+    scans. If the scan has been interrupted the saved records are discarded.
+
+  RETURN VALUE   
+    none      
+*/
+
+void JOIN_TAB_SCAN_SPILL::close()
+{
+  if (spill_state == SPILL_WRITING)
+    spill_state= scan_is_complete ? SPILL_READY : SPILL_NONE;
+  JOIN_TAB_SCAN::close();
+}
+
+
+/* 
+  Discard the records saved by the previous executions of the join
+
+  SYNOPSIS
+    reinit()
+
+  DESCRIPTION
+    The condition pushed to join_tab may refer to the fields of outer
+    tables, so the records saved in one execution of the join cannot be
+    used in the next one. The temporary file itself is kept to be
+    rewritten.
+
+  RETURN VALUE   
+    none      
+*/
+
+void JOIN_TAB_SCAN_SPILL::reinit()
+{
+  spill_state= SPILL_NONE;
+  scans= 0;
+}
+
+
+/* 
+  Close the temporary file used to save the records of join_tab
+
+  SYNOPSIS
+    cleanup()
+
+  RETURN VALUE   
+    none      
+*/
+
+void JOIN_TAB_SCAN_SPILL::cleanup()
+{
+  close_cached_file(&spill_file);
+  reinit();
+}
+
+
 /*
   Prepare to iterate over the BNL join cache buffer to look for matches 
 
@@ -3765,7 +3999,10 @@ void JOIN_CACHE_BNLH::read_next_candidate_for_match(uchar *rec_ptr)
 
   NOTES
     The function first constructs a companion object of the type JOIN_TAB_SCAN,
-    then it calls the init method of the parent class.
+    or of the type JOIN_TAB_SCAN_SPILL if the records of join_tab can be saved
+    in a temporary file, then it calls the init method of the parent class.
+    When the size of the join buffer is known the spilling scan is told
+    whether the buffer is expected to be refilled.
     
   RETURN VALUE  
     0   initialization with buffer allocations has been succeeded
@@ -3774,12 +4011,122 @@ void JOIN_CACHE_BNLH::read_next_candidate_for_match(uchar *rec_ptr)
 
 int JOIN_CACHE_BNLH::init()
 {
+  int rc;
+  JOIN_TAB_SCAN_SPILL *spill_scan= NULL;
   DBUG_ENTER("JOIN_CACHE_BNLH::init");
 
-  if (!(join_tab_scan= new JOIN_TAB_SCAN(join, join_tab)))
+  if (can_spill_join_tab_records())
+    join_tab_scan= spill_scan= new JOIN_TAB_SCAN_SPILL(join, join_tab);
+  else
+    join_tab_scan= new JOIN_TAB_SCAN(join, join_tab);
+  if (!join_tab_scan)
     DBUG_RETURN(1);
 
-  DBUG_RETURN(JOIN_CACHE_HASHED::init());
+  if ((rc= JOIN_CACHE_HASHED::init()))
+    DBUG_RETURN(rc);
+
+  if (spill_scan)
+    spill_scan->set_expect_refills(get_expected_buffer_fills() > 1);
+
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Check whether the records of the joined table can be saved in a file
+
+  SYNOPSIS
+    can_spill_join_tab_records()
+
+  DESCRIPTION
+    The function checks whether the records of join_tab read by a scan for
+    one refill of the join buffer can be saved in a temporary file and read
+    back for the next refills. This is not possible if:
+    - the table has blob fields as only pointers to their values are stored
+      in the record buffer
+    - the table is an internal temporary table that is re-filled during
+      the join execution
+    - the rowids of the records are needed for duplicate elimination
+    - the condition pushed to the table is not deterministic
+
+  RETURN VALUE
+    TRUE    the records can be saved
+    FALSE   otherwise
+*/
+
+bool JOIN_CACHE_BNLH::can_spill_join_tab_records()
+{
+  TABLE *table= join_tab->table;
+  SQL_SELECT *select= join_tab->cache_select;
+
+  return !table->s->blob_fields &&
+         table->s->tmp_table == NO_TMP_TABLE &&
+         !join_tab->keep_current_rowid &&
+         !(select && select->cond &&
+           (select->cond->used_tables() & RAND_TABLE_BIT));
+}
+
+
+/*
+  Estimate how many times the join buffer is going to be filled
+
+  SYNOPSIS
+    get_expected_buffer_fills()
+
+  DESCRIPTION
+    The function divides the expected number of the partial join records
+    by the number of records that fit into the join buffer. When the buffer
+    has been allocated, the space per record is estimated as in
+    init_hash_table(): the record with its auxiliary data, its key entry
+    and its share of the hash table. EXPLAIN does not allocate the buffer,
+    so then the function assumes a buffer of join_buffer_size and counts
+    the used fields of the records and the key. The buffer cannot be filled
+    more times than there are records.
+
+  RETURN VALUE
+    the expected number of fills of the join buffer
+*/
+
+double JOIN_CACHE_BNLH::get_expected_buffer_fills()
+{
+  double records= (join_tab-1)->get_partial_join_cardinality();
+  size_t size;
+  size_t space_per_rec;
+
+  if (records <= 1)
+    return 1.0;
+  if (buff)
+  {
+    size= buff_size;
+    space_per_rec= avg_record_length + avg_aux_buffer_incr +
+                   get_key_entry_length() + get_size_of_key_offset();
+  }
+  else
+  {
+    JOIN_TAB *first= join_tab->bush_root_tab ?
+                       join_tab->bush_root_tab->bush_children->start :
+                       join->join_tab + join->const_tables;
+    size= join->thd->variables.join_buff_size;
+    if (join_tab->join_buffer_size_limit)
+      set_if_smaller(size, join_tab->join_buffer_size_limit);
+    space_per_rec= join_tab->ref.key_length + JOIN_CACHE_KEY_FINGERPRINT_LENGTH;
+    for (JOIN_TAB *tab= first; tab < join_tab; tab++)
+      space_per_rec+= tab->get_used_fieldlength();
+  }
+  double recs_per_fill= (double) (size / MY_MAX(space_per_rec, 1));
+  set_if_bigger(recs_per_fill, 1.0);
+  return MY_MIN(ceil(records / recs_per_fill), ceil(records));
+}
+
+
+void JOIN_CACHE_BNLH::save_explain_data(struct st_explain_bka_type *explain)
+{
+  JOIN_CACHE::save_explain_data(explain);
+  if (can_spill_join_tab_records())
+  {
+    double fills= get_expected_buffer_fills();
+    explain->passes= fills < (double) UINT_MAX ? (uint) fills : UINT_MAX;
+  }
 }
 
 
@@ -23,6 +23,9 @@
 #define JOIN_CACHE_HASHED_BIT                2
 #define JOIN_CACHE_BKA_BIT                   4
 
+/* Length of the hash value fingerprint stored in a key entry of a hash table */
+#define JOIN_CACHE_KEY_FINGERPRINT_LENGTH    4
+
 /* 
   Categories of data fields of variable length written into join cache buffers.
   The value of any of these fields is written into cache together with the
@@ -537,6 +540,7 @@ protected:
     join_tab= tab;
     prev_cache= next_cache= 0;
     buff= 0;
+    join_tab_scan= 0;
   }
 
   /* 
@@ -552,6 +556,7 @@ protected:
     next_cache= 0;
     prev_cache= prev;
     buff= 0;
+    join_tab_scan= 0;
     if (prev)
       prev->next_cache= this;
   }
@@ -665,11 +670,11 @@ public:
 
   virtual ~JOIN_CACHE() {}
   void reset_join(JOIN *j) { join= j; }
-  void free()
-  { 
-    my_free(buff);
-    buff= 0;
-  }   
+
+  /* Prepare the join cache for another execution of the join */
+  void reinit();
+
+  void free();
   
   friend class JOIN_CACHE_HASHED;
   friend class JOIN_CACHE_BNL;
@@ -702,6 +707,7 @@ public:
         uchar[] value;
         cache_ref *value_ref; // offset from the beginning of the buffer
       } hash_table_key;
+      uint32 fingerprint; // lower 32 bits of the hash value of the key
       key_ref next_key; // offset backward from the beginning of hash table
       cache_ref *last_rec // offset from the beginning of the buffer
     }
@@ -760,7 +766,7 @@ public:
 class JOIN_CACHE_HASHED: public JOIN_CACHE
 {
 
-  typedef uint (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
+  typedef ulong (JOIN_CACHE_HASHED::*Hash_func) (uchar *key, uint key_len);
   typedef bool (JOIN_CACHE_HASHED::*Hash_cmp_func) (uchar *key1, uchar *key2,
                                                     uint key_len);
   
@@ -773,6 +779,9 @@ private:
     Length of the key entry in the hash table.
     A key entry either contains the key value, or it contains a reference
     to the key value if use_emb_key flag is set for the cache.
+    The key value is followed by the fingerprint of its hash value that
+    allows to skip most of the non-matching keys in a hash chain without
+    comparing the key values.
   */ 
   uint key_entry_length;
  
@@ -788,8 +797,8 @@ private:
   /* The offset of the data fields from the beginning of the record fields */
   uint data_fields_offset;
 
-  inline uint get_hash_idx_simple(uchar *key, uint key_len);
-  inline uint get_hash_idx_complex(uchar *key, uint key_len);
+  inline ulong get_hash_value_simple(uchar *key, uint key_len);
+  inline ulong get_hash_value_complex(uchar *key, uint key_len);
 
   inline bool equal_keys_simple(uchar *key1, uchar *key2, uint key_len);
   inline bool equal_keys_complex(uchar *key1, uchar *key2, uint key_len);
@@ -846,6 +855,8 @@ protected:
 
   uint get_size_of_key_offset() { return size_of_key_ofs; }
 
+  uint get_key_entry_length() { return key_entry_length; }
+
   /* 
     Get the position of the next_key_ptr field pointed to by 
     a linking reference stored at the position key_ref_ptr. 
@@ -967,7 +978,8 @@ protected:
   bool skip_if_not_needed_match();
 
   /* Search for a key in the hash table of the join buffer */
-  bool key_search(uchar *key, uint key_len, uchar **key_ref_ptr);
+  bool key_search(uchar *key, uint key_len, uchar **key_ref_ptr,
+                  uint32 *key_fingerprint= NULL);
 
   /* Reallocate the join buffer of a hashed join cache */
   int realloc_buffer();
@@ -1081,6 +1093,76 @@ public:
   */ 
   virtual void close();
 
+  /* 
+    Shall discard any data on the joined table saved by the previous
+    executions of the join operation
+  */
+  virtual void reinit() {}
+
+  /* Shall release the resources allocated by the table scan object */
+  virtual void cleanup() {}
+
+};
+
+
+/*
+  The class JOIN_TAB_SCAN_SPILL is used by the BNLH join algorithm instead
+  of JOIN_TAB_SCAN when the join buffer may have to be refilled several
+  times. The records of join_tab that meet the condition pushed to the table
+  are written into a temporary file during a full scan of the table.
+  Each following scan for the next refill of the join buffer reads the
+  records back from the file instead of scanning the table again and
+  checking the pushed condition.
+  If the join buffer is expected to be refilled the file is written during
+  the first scan, otherwise it is written only when the join buffer is
+  refilled for the first time.
+*/
+
+class JOIN_TAB_SCAN_SPILL: public JOIN_TAB_SCAN
+{
+private:
+  /* The temporary file with the records of join_tab */
+  IO_CACHE spill_file;
+
+  enum enum_spill_state
+  {
+    SPILL_NONE,        /* no records have been saved yet                 */
+    SPILL_WRITING,     /* the records are saved in the current scan      */
+    SPILL_READY,       /* all records have been saved                    */
+    SPILL_FAILED       /* the file cannot be used in this join execution */
+  };
+  enum_spill_state spill_state;
+
+  /* TRUE if the records are to be saved already during the first scan */
+  bool expect_refills;
+
+  /* The number of scans of join_tab in the current join execution */
+  uint scans;
+
+  /* TRUE if the current scan has reached the end of join_tab */
+  bool scan_is_complete;
+
+public:
+
+  JOIN_TAB_SCAN_SPILL(JOIN *j, JOIN_TAB *tab)
+    :JOIN_TAB_SCAN(j, tab), spill_state(SPILL_NONE), expect_refills(FALSE),
+     scans(0), scan_is_complete(FALSE)
+  {
+    my_b_clear(&spill_file);
+  }
+
+  void set_expect_refills(bool refills) { expect_refills= refills; }
+
+  int open();
+
+  int next();
+
+  void close();
+
+  void reinit();
+
+  void cleanup();
+
 };
 
 /*
@@ -1175,6 +1257,15 @@ protected:
 
   void read_next_candidate_for_match(uchar *rec_ptr);
 
+  /* 
+    Check whether the records of join_tab can be saved in a temporary file
+    to be re-read for the next refills of the join buffer
+  */
+  bool can_spill_join_tab_records();
+
+  /* Estimate how many times the join buffer is going to be filled */
+  double get_expected_buffer_fills();
+
 public:
 
   /* 
@@ -1200,6 +1291,8 @@ public:
 
   bool is_key_access() { return TRUE; }
 
+  void save_explain_data(struct st_explain_bka_type *explain);
+
 };
 
 
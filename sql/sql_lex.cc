@@ -1825,6 +1825,7 @@ void st_select_lex::init_query()
   leaf_tables.empty();
   item_list.empty();
   join= 0;
+  saved_join_order= 0;
   having= prep_having= where= prep_where= 0;
   olap= UNSPECIFIED_OLAP_TYPE;
   having_fix_field= 0;
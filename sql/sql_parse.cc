@@ -933,6 +933,10 @@ bool do_command(THD *thd)
   */
   DEBUG_SYNC(thd, "before_do_command_net_read");
 
+#ifndef EMBEDDED_LIBRARY
+  /* Don't keep results of pipelined commands while blocked in read */
+  net_flush_pending(net);
+#endif
   thd->m_server_idle= TRUE;
   packet_length= my_net_read(net);
   thd->m_server_idle= FALSE;
@@ -1321,6 +1325,7 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
 
       /* Finalize server status flags after executing a statement. */
       thd->update_server_status();
+      thd->add_status_to_global();
       thd->protocol->end_statement();
       query_cache_end_of_result(thd);
 
@@ -1726,7 +1731,20 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   thd_proc_info(thd, "updating status");
   /* Finalize server status flags after executing a command. */
   thd->update_server_status();
+  /*
+    A client that pipelines its commands gets the result together with
+    the results of the commands it has already sent after this one.
+  */
+  thd->m_net_server_extension.m_pipelined=
+    MY_TEST(thd->client_ext_capabilities & CLIENT_EXT_PIPELINE);
+  /*
+    Add the status to the global status before the client gets the
+    result, so that it sees its command counted in SHOW GLOBAL STATUS
+    of other connections.
+  */
+  thd->add_status_to_global();
   thd->protocol->end_statement();
+  thd->m_net_server_extension.m_pipelined= FALSE;
   query_cache_end_of_result(thd);
 
   if (!thd->is_error() && !thd->killed_errno())
@@ -1740,6 +1758,8 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   thd->update_all_stats();
 
   log_slow_statement(thd);
+  /* Bytes_sent of the result and Slow_queries */
+  thd->add_status_to_global();
 
   THD_STAGE_INFO(thd, stage_cleaning_up);
   thd->reset_query();
@@ -1753,6 +1773,9 @@ bool dispatch_command(enum enum_server_command command, THD *thd,
   thd->set_time();
   dec_thread_running();
   thd->packet.shrink(thd->variables.net_buffer_length);	// Reclaim some memory
+#ifndef EMBEDDED_LIBRARY
+  net_shrink_buffer(net, thd->variables.net_buffer_length);
+#endif
   free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC));
 
 #if defined(ENABLED_PROFILING)
@@ -6400,9 +6423,19 @@ void mysql_parse(THD *thd, char *rawbuf, uint length,
   {
     LEX *lex= thd->lex;
 
-    bool err= parse_sql(thd, parser_state, NULL, true);
-
-    if (!err)
+    if (thd->variables.normalized_stmt_cache_size &&
+#ifndef NO_EMBEDDED_ACCESS_CHECKS
+        !(mqh_used && thd->user_connect) &&
+#endif
+        !mysql_execute_normalized_stmt(thd, rawbuf, length))
+    {
+      /* Executed as a prepared statement, without parsing the query */
+      lex->sql_command= SQLCOM_SELECT;
+      thd->m_statement_psi=
+        MYSQL_REFINE_STATEMENT(thd->m_statement_psi,
+                               sql_statement_info[SQLCOM_SELECT].m_key);
+    }
+    else if (!parse_sql(thd, parser_state, NULL, true))
     {
       thd->m_statement_psi=
         MYSQL_REFINE_STATEMENT(thd->m_statement_psi,
@@ -82,6 +82,16 @@ When one supplies long data for a placeholder:
     server doesn't care; also, the server doesn't notify the client whether
     it got the data or not; if there is any error, then it will be returned
     at statement execute.
+
+When @@normalized_stmt_cache_size is not 0, a text protocol SELECT
+(COM_QUERY) is looked up in the normalized statement cache of the connection:
+
+  - The literals of the WHERE clauses of the query are replaced with
+    parameter markers (see normalize_query()).
+  - The first query of a normalized text is prepared as a statement,
+    which is kept in 'thd->normalized_stmts'.
+  - The statement is executed with the literals of the query as the
+    parameter values, without parsing the query.
 */
 
 #include "my_global.h"                          /* NO_EMBEDDED_ACCESS_CHECKS */
@@ -150,7 +160,8 @@ public:
   enum flag_values
   {
     IS_IN_USE= 1,
-    IS_SQL_PREPARE= 2
+    IS_SQL_PREPARE= 2,
+    IS_NORMALIZED= 4
   };
 
   THD *thd;
@@ -162,8 +173,9 @@ public:
   uint flags;
   char last_error[MYSQL_ERRMSG_SIZE];
 #ifndef EMBEDDED_LIBRARY
-  bool (*set_params)(Prepared_statement *st, uchar *data, uchar *data_end,
-                     uchar *read_pos, String *expanded_query);
+  bool (*set_params)(Prepared_statement *st, uchar *null_array,
+                     uchar **read_pos, uchar *data_end,
+                     String *expanded_query);
 #else
   bool (*set_params_data)(Prepared_statement *st, String *expanded_query);
 #endif
@@ -181,10 +193,17 @@ public:
   inline bool is_in_use() { return flags & (uint) IS_IN_USE; }
   inline bool is_sql_prepare() const { return flags & (uint) IS_SQL_PREPARE; }
   void set_sql_prepare() { flags|= (uint) IS_SQL_PREPARE; }
+  /* A statement of the normalized statement cache, see normalize_query() */
+  inline bool is_normalized() const { return flags & (uint) IS_NORMALIZED; }
+  void set_normalized() { flags|= (uint) IS_SQL_PREPARE | (uint) IS_NORMALIZED; }
   bool prepare(const char *packet, uint packet_length);
   bool execute_loop(String *expanded_query,
                     bool open_cursor,
                     uchar *packet_arg, uchar *packet_end_arg);
+#ifndef EMBEDDED_LIBRARY
+  bool execute_bulk_loop(String *expanded_query, ulong iterations,
+                         uchar *packet, uchar *packet_end);
+#endif
   bool execute_server_runnable(Server_runnable *server_runnable);
   /* Destroy this statement */
   void deallocate();
@@ -199,6 +218,7 @@ private:
   bool set_parameters(String *expanded_query,
                       uchar *packet, uchar *packet_end);
   bool execute(String *expanded_query, bool open_cursor);
+  bool execute_with_reprepare(String *expanded_query, bool open_cursor);
   bool reprepare();
   bool validate_metadata(Prepared_statement  *copy);
   void swap_prepared_statement(Prepared_statement *copy);
@@ -852,10 +872,11 @@ inline bool is_param_long_data_type(Item_param *param)
 */
 
 static bool insert_params_with_log(Prepared_statement *stmt, uchar *null_array,
-                                   uchar *read_pos, uchar *data_end,
+                                   uchar **data, uchar *data_end,
                                    String *query)
 {
   THD  *thd= stmt->thd;
+  uchar *read_pos= *data;
   Item_param **begin= stmt->param_array;
   Item_param **end= begin + stmt->param_count;
   uint32 length= 0;
@@ -907,14 +928,16 @@ static bool insert_params_with_log(Prepared_statement *stmt, uchar *null_array,
 
     length+= res->length()-1;
   }
+  *data= read_pos;
   DBUG_RETURN(0);
 }
 
 
 static bool insert_params(Prepared_statement *stmt, uchar *null_array,
-                          uchar *read_pos, uchar *data_end,
+                          uchar **data, uchar *data_end,
                           String *expanded_query)
 {
+  uchar *read_pos= *data;
   Item_param **begin= stmt->param_array;
   Item_param **end= begin + stmt->param_count;
 
@@ -947,6 +970,7 @@ static bool insert_params(Prepared_statement *stmt, uchar *null_array,
     if (param->convert_str_value(stmt->thd))
       DBUG_RETURN(1);                           /* out of memory */
   }
+  *data= read_pos;
   DBUG_RETURN(0);
 }
 
@@ -2695,8 +2719,10 @@ void mysqld_stmt_execute(THD *thd, char *packet_arg, uint packet_length)
   Prepared_statement *stmt;
   Protocol *save_protocol= thd->protocol;
   bool open_cursor;
+  ulong iterations;
   DBUG_ENTER("mysqld_stmt_execute");
 
+  iterations= uint4korr(packet + 5);
   packet+= 9;                               /* stmt_id + 5 bytes of flags */
 
   /* First of all clear possible warnings from the previous command */
@@ -2719,7 +2745,13 @@ void mysqld_stmt_execute(THD *thd, char *packet_arg, uint packet_length)
   open_cursor= MY_TEST(flags & (ulong) CURSOR_TYPE_READ_ONLY);
 
   thd->protocol= &thd->protocol_binary;
-  stmt->execute_loop(&expanded_query, open_cursor, packet, packet_end);
+#ifndef EMBEDDED_LIBRARY
+  if (iterations > 1 &&
+      (thd->client_ext_capabilities & CLIENT_EXT_STMT_BULK) && !open_cursor)
+    stmt->execute_bulk_loop(&expanded_query, iterations, packet, packet_end);
+  else
+#endif
+    stmt->execute_loop(&expanded_query, open_cursor, packet, packet_end);
   thd->protocol= save_protocol;
 
   sp_cache_enforce_limit(thd->sp_proc_cache, stored_program_cache_size);
@@ -2951,6 +2983,553 @@ void mysql_sql_stmt_close(THD *thd)
 }
 
 
+/***************************************************************************
+ Normalized statement cache
+****************************************************************************/
+
+/** The maximum nesting of parentheses in a query that is normalized */
+#define NORMALIZE_MAX_DEPTH 64
+
+/** A literal of a query that is replaced with a parameter marker */
+
+struct Normalized_literal
+{
+  enum enum_type { INT_LITERAL, DECIMAL_LITERAL, STRING_LITERAL } type;
+  const char *str;                      // Without the quotes
+  uint length;
+};
+
+
+/** An element of THD::normalized_stmts */
+
+struct Normalized_stmt
+{
+  LEX_STRING key;
+  Prepared_statement *stmt;             // NULL if it can't be prepared
+};
+
+
+static uchar *get_normalized_stmt_key(const uchar *arg, size_t *length,
+                                      my_bool not_used __attribute__((unused)))
+{
+  const Normalized_stmt *entry= (const Normalized_stmt *) arg;
+  *length= entry->key.length;
+  return (uchar*) entry->key.str;
+}
+
+
+static void free_normalized_stmt(void *arg)
+{
+  Normalized_stmt *entry= (Normalized_stmt *) arg;
+  delete entry->stmt;
+  my_free(entry);
+}
+
+
+static inline bool is_ident_char(char c)
+{
+  return my_isvar(&my_charset_latin1, c) || c == '$' || (uchar) c >= 0x80;
+}
+
+
+static inline uint char_length(CHARSET_INFO *cs, const char *p,
+                               const char *end)
+{
+  uint length;
+  return use_mb(cs) && (length= my_ismbchar(cs, p, end)) ? length : 1;
+}
+
+
+static bool is_keyword(const char *word, size_t length, const char *keyword)
+{
+  size_t i;
+  for (i= 0; i < length; i++)
+  {
+    if (!keyword[i] || my_toupper(&my_charset_latin1, word[i]) != keyword[i])
+      return false;
+  }
+  return !keyword[i];
+}
+
+
+static bool is_one_of_keywords(const char *word, size_t length,
+                               const char **keywords)
+{
+  for (; *keywords; keywords++)
+  {
+    if (is_keyword(word, length, *keywords))
+      return true;
+  }
+  return false;
+}
+
+
+/**
+  Normalize a text protocol query for the normalized statement cache.
+
+  The numbers and the strings in the WHERE clauses of a SELECT are
+  replaced with parameter markers, so that the queries which differ
+  only in these values have the same normalized text. The literals of
+  the other clauses, like the select list or LIMIT, are kept, as they
+  define the result set metadata or must be constant at prepare. So are
+  the literals of the subqueries that are not in a WHERE clause, as the
+  text of a subquery of the select list is the name of its column.
+
+  Strings with an introducer (like _latin1'a' or DATE'2014-01-01'),
+  with escaped characters, followed by another string or by COLLATE
+  are kept as well. The queries with comments, parameter markers or
+  several statements are not normalized.
+
+  @param thd             thread handle
+  @param query           the query, in character_set_client
+  @param length          the length of the query
+  @param[out] text       the normalized text, in thd->mem_root
+  @param[out] literals   the replaced literals in the order of the
+                         parameter markers, in thd->mem_root
+  @param[out] count      the number of the replaced literals
+
+  @retval FALSE  ok
+  @retval TRUE   the query can't be normalized
+*/
+
+static bool normalize_query(THD *thd, const char *query, uint length,
+                            LEX_STRING *text, Normalized_literal **literals,
+                            uint *count)
+{
+  static const char *where_keywords[]= { "WHERE", NullS };
+  static const char *end_where_keywords[]=
+  {
+    "SELECT", "GROUP", "ORDER", "HAVING", "LIMIT", "PROCEDURE", "INTO",
+    "FOR", "LOCK", "UNION", NullS
+  };
+  static const char *introducer_keywords[]=
+  {
+    "N", "X", "B", "DATE", "TIME", "TIMESTAMP", "ESCAPE", NullS
+  };
+  CHARSET_INFO *cs= thd->charset();
+  bool escapes= !(thd->variables.sql_mode & MODE_NO_BACKSLASH_ESCAPES);
+  const char *p= query, *end= query + length;
+  const char *word= NULL;               // The previous token, if a word
+  size_t word_length= 0;
+  bool after_string= false;             // The previous token is a string
+  bool first= true;                     // The first token
+  /* For each nesting level: in a WHERE clause, in a WHERE of the outer */
+  bool in_where[NORMALIZE_MAX_DEPTH], in_outer_where[NORMALIZE_MAX_DEPTH];
+  uint depth= 0;
+  char *to;
+  Normalized_literal *literal, *literals_end;
+  /*
+    A literal and what separates it from the next one take two bytes in
+    most queries. The queries with more literals are not normalized.
+  */
+  uint max_literals= length / 2 + 1;
+
+  if (!(text->str= (char*) thd->alloc(length + 1)) ||
+      !(*literals= (Normalized_literal*)
+        thd->alloc(sizeof(Normalized_literal) * max_literals)))
+    return TRUE;
+  to= text->str;
+  literal= *literals;
+  literals_end= *literals + max_literals;
+  in_where[0]= false;
+  in_outer_where[0]= true;
+
+  while (p < end)
+  {
+    const char *start= p;
+    char c= *p;
+
+    if (my_isspace(&my_charset_latin1, c))
+    {
+      *to++= *p++;
+      continue;
+    }
+
+    if (is_ident_char(c) && !my_isdigit(&my_charset_latin1, c))
+    {
+      while (p < end && is_ident_char(*p))
+        p+= char_length(cs, p, end);
+      if (first && !is_keyword(start, p - start, "SELECT"))
+        return TRUE;
+      first= false;
+      if (is_one_of_keywords(start, p - start, where_keywords))
+        in_where[depth]= in_outer_where[depth];
+      else if (is_one_of_keywords(start, p - start, end_where_keywords))
+        in_where[depth]= false;
+      memcpy(to, start, p - start);
+      to+= p - start;
+      word= start;
+      word_length= p - start;
+      after_string= false;
+      continue;
+    }
+    if (first)
+      return TRUE;                              // Not a SELECT
+
+    if (my_isdigit(&my_charset_latin1, c))
+    {
+      bool is_decimal= false;
+      while (p < end && my_isdigit(&my_charset_latin1, *p))
+        p++;
+      if (p < end && *p == '.')
+      {
+        is_decimal= true;
+        for (p++; p < end && my_isdigit(&my_charset_latin1, *p); p++)
+        {}
+      }
+      if (p < end && (is_ident_char(*p) || *p == '.'))
+      {
+        /* A float, a hexadecimal number or an identifier: keep it */
+        while (p < end && (is_ident_char(*p) || *p == '.'))
+          p+= char_length(cs, p, end);
+      }
+      else if (in_where[depth] && to[-1] != '.')
+      {
+        if (literal == literals_end)
+          return TRUE;
+        literal->type= is_decimal || p - start > 18 ?
+                       Normalized_literal::DECIMAL_LITERAL :
+                       Normalized_literal::INT_LITERAL;
+        literal->str= start;
+        literal->length= (uint) (p - start);
+        literal++;
+        *to++= '?';
+        word= NULL;
+        after_string= false;
+        continue;
+      }
+      memcpy(to, start, p - start);
+      to+= p - start;
+      word= NULL;
+      after_string= false;
+      continue;
+    }
+
+    if (c == '\'' || c == '"' || c == '`')
+    {
+      bool is_simple= c == '\'';
+      bool has_escapes= escapes &&
+        (c == '\'' ||
+         (c == '"' && !(thd->variables.sql_mode & MODE_ANSI_QUOTES)));
+      for (p++; ; )
+      {
+        if (p >= end)
+          return TRUE;
+        if (*p == '\\' && has_escapes)
+        {
+          is_simple= false;
+          if (++p < end)
+            p+= char_length(cs, p, end);
+        }
+        else if (*p == c)
+        {
+          if (++p < end && *p == c)
+          {
+            is_simple= false;
+            p++;
+          }
+          else
+            break;
+        }
+        else
+          p+= char_length(cs, p, end);
+      }
+      if (is_simple && in_where[depth] && !after_string &&
+          !(word && (*word == '_' ||
+                     is_one_of_keywords(word, word_length,
+                                        introducer_keywords))))
+      {
+        /* Check that the string is not followed by a string or COLLATE */
+        const char *next= p, *next_end;
+        while (next < end && my_isspace(&my_charset_latin1, *next))
+          next++;
+        for (next_end= next; next_end < end && is_ident_char(*next_end);
+             next_end++)
+        {}
+        if ((next == end || (*next != '\'' && *next != '"')) &&
+            !is_keyword(next, next_end - next, "COLLATE"))
+        {
+          if (literal == literals_end)
+            return TRUE;
+          literal->type= Normalized_literal::STRING_LITERAL;
+          literal->str= start + 1;
+          literal->length= (uint) (p - start - 2);
+          literal++;
+          *to++= '?';
+          word= NULL;
+          after_string= true;
+          continue;
+        }
+      }
+      memcpy(to, start, p - start);
+      to+= p - start;
+      word= NULL;
+      after_string= true;
+      continue;
+    }
+
+    switch (c) {
+    case '?':                                   // A parameter marker
+    case ';':                                   // Several statements
+    case '#':
+    case '{':                                   // ODBC escape syntax
+      return TRUE;
+    case '/':
+      if (p + 1 < end && p[1] == '*')
+        return TRUE;
+      break;
+    case '-':
+      if (p + 1 < end && p[1] == '-')
+        return TRUE;
+      break;
+    case '(':
+      if (depth + 1 == NORMALIZE_MAX_DEPTH)
+        return TRUE;
+      in_where[depth + 1]= in_outer_where[depth + 1]= in_where[depth];
+      depth++;
+      break;
+    case ')':
+      if (!depth)
+        return TRUE;
+      depth--;
+      break;
+    }
+    *to++= *p++;
+    word= NULL;
+    after_string= false;
+  }
+
+  if (first || depth)
+    return TRUE;
+  *to= 0;
+  text->length= to - text->str;
+  *count= (uint) (literal - *literals);
+  return FALSE;
+}
+
+
+/**
+  Assign the parameters of a normalized statement from the literals
+  that were replaced in the query.
+*/
+
+static bool set_params_from_literals(Prepared_statement *stmt,
+                                     Normalized_literal *literals)
+{
+  THD *thd= stmt->thd;
+  Item_param **begin= stmt->param_array;
+  Item_param **end= begin + stmt->param_count;
+  DBUG_ENTER("set_params_from_literals");
+
+  for (Item_param **it= begin; it < end; ++it, ++literals)
+  {
+    Item_param *param= *it;
+    param->is_literal= TRUE;
+    switch (literals->type) {
+    case Normalized_literal::INT_LITERAL:
+    {
+      char *literal_end= (char*) literals->str + literals->length;
+      int error;
+      setup_one_conversion_function(thd, param, MYSQL_TYPE_LONGLONG);
+      param->set_int(my_strtoll10(literals->str, &literal_end, &error),
+                     literals->length);
+      break;
+    }
+    case Normalized_literal::DECIMAL_LITERAL:
+      setup_one_conversion_function(thd, param, MYSQL_TYPE_NEWDECIMAL);
+      param->set_decimal(literals->str, literals->length);
+      break;
+    case Normalized_literal::STRING_LITERAL:
+      setup_one_conversion_function(thd, param, MYSQL_TYPE_STRING);
+      if (param->set_str(literals->str, literals->length) ||
+          param->convert_str_value(thd))
+        DBUG_RETURN(TRUE);
+      break;
+    }
+  }
+  DBUG_RETURN(FALSE);
+}
+
+
+/**
+  Prepare a normalized statement for the cache.
+
+  @param      thd          thread handle
+  @param      text         the normalized text
+  @param[out] uncacheable  set if the text can never be prepared, like
+                           when a literal was replaced where a parameter
+                           marker is not allowed
+
+  @return the statement, or NULL if the statement can't be prepared,
+  or if it has warnings, which would be lost in the next executions.
+  The error or the warnings of the prepare are cleared, unless the
+  error is fatal or the query was killed.
+*/
+
+static Prepared_statement *prepare_normalized_stmt(THD *thd,
+                                                   LEX_STRING *text,
+                                                   bool *uncacheable)
+{
+  Prepared_statement *stmt;
+  bool error;
+
+  *uncacheable= FALSE;
+  if (!(stmt= new Prepared_statement(thd)))
+    return NULL;
+  stmt->set_normalized();
+
+  error= stmt->prepare(text->str, (uint) text->length);
+  if (!error && !thd->get_stmt_da()->current_statement_warn_count())
+    return stmt;
+
+  delete stmt;
+  /*
+    Other errors, like a missing table, and the warnings may depend on
+    the state of the server or on the data, so the next query of the
+    text tries to prepare it again.
+  */
+  if (error && thd->is_error())
+  {
+    uint sql_errno= thd->get_stmt_da()->sql_errno();
+    *uncacheable= sql_errno == ER_PARSE_ERROR ||
+                  sql_errno == ER_SYNTAX_ERROR ||
+                  sql_errno == ER_UNSUPPORTED_PS;
+  }
+  if (!error || !(thd->is_fatal_error || thd->killed))
+  {
+    thd->clear_error();
+    thd->get_stmt_da()->clear_warning_info(thd->query_id);
+  }
+  return NULL;
+}
+
+
+/**
+  Execute a text protocol query with the normalized statement cache.
+
+  The query is normalized with normalize_query(). The first query of a
+  normalized text is prepared, and the statement is kept in
+  THD::normalized_stmts. The next queries of the same text, in the
+  same current database and with the same values of the variables used
+  by the parser, like the SQL mode and the character sets, execute the
+  statement with their literals bound to its parameters, without being
+  parsed.
+
+  The statements of the cache are not counted in Prepared_stmt_count.
+  The cache holds at most @@normalized_stmt_cache_size statements, and
+  is emptied when it is full.
+
+  @param thd     thread handle
+  @param query   the query
+  @param length  the length of the query
+
+  @retval FALSE  the query is executed, successfully or not
+  @retval TRUE   the query can't be executed with the cache, parse it
+*/
+
+bool mysql_execute_normalized_stmt(THD *thd, const char *query, uint length)
+{
+  LEX_STRING text;
+  Normalized_literal *literals;
+  uint count;
+  Normalized_stmt *entry;
+  Prepared_statement *stmt;
+  bool uncacheable;
+  char *key, *pos;
+  uint key_length;
+  /* The query text for the query cache and the logs */
+  String expanded_query(query, length, thd->charset());
+  DBUG_ENTER("mysql_execute_normalized_stmt");
+
+  /*
+    A temporary table may hide a view or a table of a prepared statement
+    without the statement being reprepared, so the cache is not used
+    while there are temporary tables.
+  */
+  if (thd->temporary_tables ||
+      normalize_query(thd, query, length, &text, &literals, &count))
+    DBUG_RETURN(TRUE);
+
+  /*
+    The statement depends on the current database and on the variables
+    that the parser uses as well as on the text
+  */
+  key_length= (uint) text.length + 1 + thd->db_length + 1 + 8 + 4 * 2 + 4;
+  if (!(key= (char*) thd->alloc(key_length)))
+    DBUG_RETURN(TRUE);
+  memcpy(key, text.str, text.length + 1);
+  pos= key + text.length + 1;
+  if (thd->db_length)
+    memcpy(pos, thd->db, thd->db_length);
+  pos+= thd->db_length;
+  *pos++= 0;
+  int8store(pos, thd->variables.sql_mode);
+  int2store(pos + 8, thd->variables.character_set_client->number);
+  int2store(pos + 10, thd->variables.collation_connection->number);
+  int2store(pos + 12, thd->variables.collation_database->number);
+  int2store(pos + 14, thd->variables.character_set_filesystem->number);
+  pos[16]= (char) thd->variables.default_week_format;
+  pos[17]= (char) thd->variables.old_mode;
+  pos[18]= (char) thd->variables.old_passwords;
+  pos[19]= (char) thd->variables.sysdate_is_now;
+
+  if (my_hash_init_opt(&thd->normalized_stmts, &my_charset_bin, 32, 0, 0,
+                       get_normalized_stmt_key, free_normalized_stmt,
+                       HASH_UNIQUE | HASH_THREAD_SPECIFIC))
+    DBUG_RETURN(TRUE);
+
+  if ((entry= (Normalized_stmt*) my_hash_search(&thd->normalized_stmts,
+                                                (uchar*) key, key_length)))
+  {
+    if (!(stmt= entry->stmt))
+      DBUG_RETURN(TRUE);
+    status_var_increment(thd->status_var.normalized_stmt_cache_hits);
+  }
+  else
+  {
+    stmt= prepare_normalized_stmt(thd, &text, &uncacheable);
+    if (!stmt && thd->is_error())
+      DBUG_RETURN(FALSE);
+    /* Only the texts that can never be prepared are cached as NULL */
+    if (!stmt && !uncacheable)
+      DBUG_RETURN(TRUE);
+
+    if (thd->normalized_stmts.records >=
+        thd->variables.normalized_stmt_cache_size)
+      my_hash_reset(&thd->normalized_stmts);
+    if (!(entry= (Normalized_stmt*) my_malloc(sizeof(Normalized_stmt) +
+                                              key_length,
+                                              MYF(MY_THREAD_SPECIFIC))))
+    {
+      delete stmt;
+      DBUG_RETURN(TRUE);
+    }
+    entry->key.str= (char*) (entry + 1);
+    entry->key.length= key_length;
+    memcpy(entry->key.str, key, key_length);
+    entry->stmt= stmt;
+    if (my_hash_insert(&thd->normalized_stmts, (uchar*) entry))
+    {
+      free_normalized_stmt(entry);
+      DBUG_RETURN(TRUE);
+    }
+    if (!stmt)
+      DBUG_RETURN(TRUE);
+  }
+  DBUG_ASSERT(stmt->param_count == count);
+
+  if (set_params_from_literals(stmt, literals))
+  {
+    reset_stmt_params(stmt);
+    if (!thd->is_error())
+      my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR), 0);
+    DBUG_RETURN(FALSE);
+  }
+  (void) stmt->execute_loop(&expanded_query, FALSE, NULL, NULL);
+  DBUG_RETURN(FALSE);
+}
+
+
 /**
   Handle long data in pieces from client.
 
@@ -3348,8 +3927,11 @@ bool Prepared_statement::prepare(const char *packet, uint packet_len)
     If this is an SQLCOM_PREPARE, we also increase Com_prepare_sql.
     However, it seems handy if com_stmt_prepare is increased always,
     no matter what kind of prepare is processed.
+    The statements of the normalized statement cache are not counted, as
+    the client sends a text protocol query for them.
   */
-  status_var_increment(thd->status_var.com_stmt_prepare);
+  if (!is_normalized())
+    status_var_increment(thd->status_var.com_stmt_prepare);
 
   if (! (lex= new (mem_root) st_lex_local))
     DBUG_RETURN(TRUE);
@@ -3483,7 +4065,7 @@ bool Prepared_statement::prepare(const char *packet, uint packet_len)
       sub-statements inside stored procedures are not logged into
       the general log.
     */
-    if (thd->spcont == NULL)
+    if (thd->spcont == NULL && !is_normalized())
       general_log_write(thd, COM_STMT_PREPARE, query(), query_length());
   }
   DBUG_RETURN(error);
@@ -3517,6 +4099,10 @@ Prepared_statement::set_parameters(String *expanded_query,
   bool is_sql_ps= packet == NULL;
   bool res= FALSE;
 
+  /* The literals of a normalized statement are bound by the caller */
+  if (is_normalized())
+    return FALSE;
+
   if (is_sql_ps)
   {
     /* SQL prepared statement */
@@ -3528,7 +4114,7 @@ Prepared_statement::set_parameters(String *expanded_query,
 #ifndef EMBEDDED_LIBRARY
     uchar *null_array= packet;
     res= (setup_conversion_functions(this, &packet, packet_end) ||
-          set_params(this, null_array, packet, packet_end, expanded_query));
+          set_params(this, null_array, &packet, packet_end, expanded_query));
 #else
     /*
       In embedded library we re-install conversion routines each time
@@ -3577,10 +4163,7 @@ Prepared_statement::execute_loop(String *expanded_query,
                                  uchar *packet,
                                  uchar *packet_end)
 {
-  const int MAX_REPREPARE_ATTEMPTS= 3;
-  Reprepare_observer reprepare_observer;
   bool error;
-  int reprepare_attempt= 0;
 
   /* Check if we got an error when sending long data */
   if (state == Query_arena::STMT_ERROR)
@@ -3601,6 +4184,159 @@ Prepared_statement::execute_loop(String *expanded_query,
   }
 #endif
 
+  error= execute_with_reprepare(expanded_query, open_cursor);
+  reset_stmt_params(this);
+
+  return error;
+}
+
+
+#ifndef EMBEDDED_LIBRARY
+/**
+  Execute a prepared statement once for each of the parameter sets of
+  a bulk COM_STMT_EXECUTE (CLIENT_EXT_STMT_BULK).
+
+  The first parameter set has the layout of an ordinary execute packet,
+  each of the following ones only its null bitmap and the values. The
+  statement is executed once per set, and one OK packet with the sum of
+  the affected rows is sent for all of them. A set that fails with a
+  regular error doesn't stop the loop: its error stays in the warning
+  list, followed by a note with the number of the set. Only a fatal
+  error, a kill or a transaction rollback ends the loop early.
+
+  @param expanded_query  see execute_loop()
+  @param iterations      number of parameter sets in the packet
+  @param packet          the parameter sets
+  @param packet_end      end of the packet
+
+  @retval TRUE   the loop was stopped by an error, it is set in THD
+  @retval FALSE  all parameter sets were executed, maybe with warnings
+*/
+
+bool
+Prepared_statement::execute_bulk_loop(String *expanded_query,
+                                      ulong iterations,
+                                      uchar *packet,
+                                      uchar *packet_end)
+{
+  Diagnostics_area *da= thd->get_stmt_da();
+  ulonglong affected_rows= 0;
+  ulonglong insert_id= 0;
+  uint null_count= (param_count + 7) / 8;
+
+  if (state == Query_arena::STMT_ERROR)
+  {
+    my_message(last_errno, last_error, MYF(0));
+    return TRUE;
+  }
+
+  /* A statement with a result set can't share one OK packet */
+  switch (lex->sql_command) {
+  case SQLCOM_INSERT:
+  case SQLCOM_INSERT_SELECT:
+  case SQLCOM_REPLACE:
+  case SQLCOM_REPLACE_SELECT:
+  case SQLCOM_UPDATE:
+  case SQLCOM_UPDATE_MULTI:
+  case SQLCOM_DELETE:
+  case SQLCOM_DELETE_MULTI:
+    break;
+  default:
+    my_error(ER_UNSUPPORTED_PS, MYF(0));
+    return TRUE;
+  }
+
+  /* The long data of a parameter can't be spread over the sets */
+  for (Item_param **it= param_array; it < param_array + param_count; ++it)
+  {
+    if ((*it)->state == Item_param::LONG_DATA_VALUE)
+    {
+      my_error(ER_WRONG_ARGUMENTS, MYF(0), "mysqld_stmt_execute");
+      reset_stmt_params(this);
+      return TRUE;
+    }
+  }
+
+  for (ulong row= 0; row < iterations; row++)
+  {
+    uchar *null_array= packet;
+    bool error;
+
+    if (row == 0)
+    {
+      if (setup_conversion_functions(this, &packet, packet_end))
+        goto malformed;
+    }
+    else if ((packet+= null_count) > packet_end)
+      goto malformed;
+    if (set_params(this, null_array, &packet, packet_end, expanded_query))
+      goto malformed;
+
+    error= execute_with_reprepare(expanded_query, FALSE);
+    reset_stmt_params(this);
+
+    if (!error)
+    {
+      affected_rows+= da->affected_rows();
+      if (!insert_id)
+        insert_id= da->last_insert_id();
+      da->reset_diagnostics_area();
+    }
+    else if (thd->is_fatal_error || thd->killed ||
+             thd->transaction_rollback_request || !da->is_error())
+      return TRUE;
+    else
+    {
+      /* The error itself is already in the warning list */
+      thd->clear_error();
+      push_warning_printf(thd, Sql_condition::WARN_LEVEL_NOTE,
+                          ER_STMT_BULK_ROW_FAILED,
+                          ER(ER_STMT_BULK_ROW_FAILED), row);
+    }
+
+    /*
+      Free what the execution allocated in the runtime memory root, as
+      the end of the command would, with the query plan kept for it.
+      Each set is binlogged as a statement of its own, so it gets its
+      own query id and user variable events, but the warnings of all
+      sets are kept.
+    */
+    thd->reset_query();
+    delete_explain_query(thd->lex);
+    if (opt_bin_log)
+      reset_dynamic(&thd->user_var_events);
+    free_root(thd->mem_root, MYF(MY_KEEP_PREALLOC));
+    thd->set_query_id(next_query_id());
+    da->set_warning_info_id(thd->query_id);
+  }
+
+  my_ok(thd, affected_rows, insert_id);
+  return FALSE;
+
+malformed:
+  my_error(ER_WRONG_ARGUMENTS, MYF(0), "mysqld_stmt_execute");
+  reset_stmt_params(this);
+  return TRUE;
+}
+#endif /* EMBEDDED_LIBRARY */
+
+
+/**
+  Execute the statement with the parameters already set, repreparing
+  it if its metadata has changed since prepare, see execute_loop().
+
+  @return TRUE if an error, FALSE if success
+*/
+
+bool
+Prepared_statement::execute_with_reprepare(String *expanded_query,
+                                           bool open_cursor)
+{
+  const int MAX_REPREPARE_ATTEMPTS= 3;
+  Reprepare_observer reprepare_observer;
+  bool error;
+  int reprepare_attempt= 0;
+
 reexecute:
   /*
     If the free_list is not empty, we'll wrongly free some externally
@@ -3640,7 +4376,6 @@ reexecute:
     if (! error)                                /* Success */
       goto reexecute;
   }
-  reset_stmt_params(this);
 
   return error;
 }
@@ -3705,7 +4440,11 @@ Prepared_statement::reprepare()
 
   Prepared_statement copy(thd);
 
-  copy.set_sql_prepare(); /* To suppress sending metadata to the client. */
+  /* To suppress sending metadata to the client. */
+  if (is_normalized())
+    copy.set_normalized();
+  else
+    copy.set_sql_prepare();
 
   status_var_increment(thd->status_var.com_stmt_reprepare);
 
@@ -3863,7 +4602,8 @@ bool Prepared_statement::execute(String *expanded_query, bool open_cursor)
 
   LEX_STRING stmt_db_name= { db, db_length };
 
-  status_var_increment(thd->status_var.com_stmt_execute);
+  if (!is_normalized())
+    status_var_increment(thd->status_var.com_stmt_execute);
 
   if (flags & (uint) IS_IN_USE)
   {
@@ -4041,7 +4781,7 @@ bool Prepared_statement::execute(String *expanded_query, bool open_cursor)
     sub-statements inside stored procedures are not logged into
     the general log.
   */
-  if (error == 0 && thd->spcont == NULL)
+  if (error == 0 && thd->spcont == NULL && !is_normalized())
     general_log_write(thd, COM_STMT_EXECUTE, thd->query(), thd->query_length());
 
 error:
@@ -328,12 +328,22 @@ PROFILING::PROFILING()
 }
 
 PROFILING::~PROFILING()
+{
+  restart();
+}
+
+/**
+  Forget all profiles, as if the object had just been created.
+  Used when the THD is reused for a new connection.
+*/
+void PROFILING::restart()
 {
   while (! history.is_empty())
     delete history.pop();
 
-  if (current != NULL)
-    delete current;
+  delete current;
+  current= last= NULL;
+  profile_id_counter= 1;
 }
 
 /**
@@ -282,6 +282,8 @@ public:
 
   inline void set_thd(THD *thd_arg) { thd= thd_arg; };
 
+  void restart();
+
   /* SHOW PROFILES */
   bool show_profiles();
 
@@ -316,7 +316,10 @@ bool reload_acl_and_cache(THD *thd, unsigned long long options,
   if (thd && (options & REFRESH_STATUS))
     refresh_status(thd);
   if (options & REFRESH_THREADS)
+  {
     flush_thread_cache();
+    flush_connection_cache();
+  }
 #ifdef HAVE_REPLICATION
   if (options & REFRESH_MASTER)
   {
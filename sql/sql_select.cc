@@ -47,6 +47,7 @@
                                  // print_sjm, print_plan, TEST_join
 #include "records.h"             // init_read_record, end_read_record
 #include "filesort.h"            // filesort_free_buffers
+#include "group_by_hash.h"
 #include "sql_union.h"           // mysql_union
 #include "opt_subselect.h"
 #include "log_slow.h"
@@ -86,6 +87,9 @@ void best_access_path(JOIN *join, JOIN_TAB *s,
                              bool disable_jbuf, double record_count,
                              POSITION *pos, POSITION *loose_scan_pos);
 static void optimize_straight_join(JOIN *join, table_map join_tables);
+static bool join_order_can_be_saved(JOIN *join);
+static bool restore_join_order(JOIN *join);
+static void save_join_order(JOIN *join);
 static bool greedy_search(JOIN *join, table_map remaining_tables,
                           uint depth, uint prune_level,
                           uint use_cond_selectivity);
@@ -169,6 +173,7 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static bool write_group_by_hash(JOIN *join, TABLE *table);
 
 static int test_if_group_changed(List<Cached_item> &list);
 static int join_read_const_table(JOIN_TAB *tab, POSITION *pos);
@@ -1968,6 +1973,16 @@ int JOIN::init_execution()
 			   select_options, tmp_rows_limit, "")))
       DBUG_RETURN(1);
 
+    /* Keep the groups in memory while they fit in, see end_update() */
+    if (exec_tmp_table1->group && exec_tmp_table1->s->keys &&
+        !exec_tmp_table1->s->uniques &&
+        exec_tmp_table1->s->db_type() == heap_hton &&
+        !(group_by_hash=
+          new Group_by_hash(exec_tmp_table1, tmp_table_param.group_length,
+                            (size_t) MY_MIN(thd->variables.tmp_table_size,
+                                            thd->variables.max_heap_table_size))))
+      DBUG_RETURN(1);
+
     /*
       We don't have to store rows in temp table that doesn't match HAVING if:
       - we are sorting the table and writing complete group rows to the
@@ -2233,6 +2248,8 @@ JOIN::reinit()
     free_io_cache(exec_tmp_table1);
     filesort_free_buffers(exec_tmp_table1,0);
   }
+  if (group_by_hash)
+    group_by_hash->reset();
   if (exec_tmp_table2)
   {
     exec_tmp_table2->file->extra(HA_EXTRA_RESET_STATE);
@@ -2254,6 +2271,9 @@ JOIN::reinit()
          tab= next_linear_tab(this, tab, WITH_BUSH_ROOTS))
     {
       tab->ref.key_err= TRUE;
+      /* Records saved by join caches in the previous execution are stale */
+      if (tab->cache)
+        tab->cache->reinit();
     }
   }
 
@@ -3137,6 +3157,7 @@ JOIN::destroy()
     free_tmp_table(thd, exec_tmp_table1);
   if (exec_tmp_table2)
     free_tmp_table(thd, exec_tmp_table2);
+  delete group_by_hash;
   delete select;
   destroy_sj_tmp_tables(this);
   delete_dynamic(&keyuse);
@@ -6372,6 +6393,10 @@ static void choose_initial_table_order(JOIN *join)
   the array 'join->best_positions', and the cost of the plan in
   'join->best_read'.
 
+  With @@prepared_stmt_plan_cache, a prepared statement saves the join
+  order that was found, and the next executions use it without a search
+  as long as it is valid, see restore_join_order().
+
   @param join         pointer to the structure providing all context info for
                       the query
   @param join_tables  set of the tables in the query
@@ -6441,6 +6466,12 @@ choose_plan(JOIN *join, table_map join_tables)
   {
     optimize_straight_join(join, join_tables);
   }
+  else if (join_order_can_be_saved(join) && restore_join_order(join))
+  {
+    /* Only find the access methods for the join order of the last execution */
+    optimize_straight_join(join, join_tables);
+    join->thd->status_var.ps_plan_cache_hits++;
+  }
   else
   {
     if (search_depth == MAX_TABLES+2)
@@ -6464,6 +6495,8 @@ choose_plan(JOIN *join, table_map join_tables)
                         use_cond_selectivity))
         DBUG_RETURN(TRUE);
     }
+    if (join_order_can_be_saved(join))
+      save_join_order(join);
   }
 
   /* 
@@ -6478,6 +6511,126 @@ choose_plan(JOIN *join, table_map join_tables)
 }
 
 
+/**
+  Check if the join order may be saved for the next executions of the
+  prepared statement, or taken from the last one.
+
+  Only joins of two or more non-constant tables without outer joins and
+  semi-join nests are handled, as the order of the tables of the others is
+  restricted in ways that don't only depend on the tables.
+*/
+
+static bool join_order_can_be_saved(JOIN *join)
+{
+  THD *thd= join->thd;
+  return (thd->variables.prepared_stmt_plan_cache &&
+          thd->stmt_arena->type() == Query_arena::PREPARED_STATEMENT &&
+          thd->stmt_arena->is_stmt_execute() &&
+          !join->emb_sjm_nest && !join->outer_join &&
+          join->select_lex->sj_nests.is_empty() &&
+          join->table_count - join->const_tables > 1);
+}
+
+
+/**
+  Check if two estimates of a number of rows differ at most by a factor of
+  two.
+*/
+
+static inline bool similar_row_estimates(ha_rows a, ha_rows b)
+{
+  return a <= 2 * b + 1 && b <= 2 * a + 1;
+}
+
+
+/**
+  Put the non-constant tables in the join order saved by the last
+  execution of the prepared statement, if it is still valid.
+
+  The saved order is valid if the same tables are constant, and the
+  estimated numbers of rows of each table, which depend on the table
+  statistics and, through the range analysis, on the parameters, are
+  similar to the saved ones.
+
+  @return TRUE if the tables are in the saved order in join->best_ref
+*/
+
+static bool restore_join_order(JOIN *join)
+{
+  Saved_join_order *saved= join->select_lex->saved_join_order;
+  JOIN_TAB **best_ref= join->best_ref + join->const_tables;
+  uint n_tables= join->table_count - join->const_tables;
+  table_map done_tables= join->const_table_map;
+  uint i, j;
+  DBUG_ENTER("restore_join_order");
+
+  if (!saved || saved->const_table_map != join->const_table_map ||
+      saved->n_tables != n_tables)
+    DBUG_RETURN(FALSE);
+
+  for (i= 0; i < n_tables; i++)
+  {
+    Saved_join_order::Table *table= saved->tables + i;
+    for (j= 0; j < n_tables && best_ref[j]->table->map != table->map; j++)
+    {}
+    if (j == n_tables ||
+        (best_ref[j]->dependent & ~done_tables) ||
+        !similar_row_estimates(best_ref[j]->records, table->records) ||
+        !similar_row_estimates(best_ref[j]->found_records,
+                               table->found_records))
+      DBUG_RETURN(FALSE);
+    done_tables|= table->map;
+  }
+
+  for (i= 0; i < n_tables; i++)
+  {
+    for (j= i; best_ref[j]->table->map != saved->tables[i].map; j++)
+    {}
+    swap_variables(JOIN_TAB*, best_ref[i], best_ref[j]);
+  }
+  DBUG_RETURN(TRUE);
+}
+
+
+/**
+  Save the join order in join->best_positions for the next executions of
+  the prepared statement.
+
+  The order is kept in the memory of the statement, which is reused when the
+  same SELECT is optimized again.
+*/
+
+static void save_join_order(JOIN *join)
+{
+  SELECT_LEX *select_lex= join->select_lex;
+  Saved_join_order *saved= select_lex->saved_join_order;
+  uint n_tables= join->table_count - join->const_tables;
+  DBUG_ENTER("save_join_order");
+
+  if (!saved || saved->n_tables < n_tables)
+  {
+    Saved_join_order::Table *tables;
+    if (!multi_alloc_root(join->thd->stmt_arena->mem_root,
+                          &saved, sizeof(*saved),
+                          &tables, sizeof(*tables) * n_tables,
+                          NullS))
+      DBUG_VOID_RETURN;
+    saved->tables= tables;
+    select_lex->saved_join_order= saved;
+  }
+  saved->const_table_map= join->const_table_map;
+  saved->n_tables= n_tables;
+  for (uint i= 0; i < n_tables; i++)
+  {
+    JOIN_TAB *tab= join->best_positions[join->const_tables + i].table;
+    saved->tables[i].map= tab->table->map;
+    saved->tables[i].records= tab->records;
+    saved->tables[i].found_records= tab->found_records;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
 /*
   Compare two join tabs based on the subqueries they are from.
    - top-level join tabs go first
@@ -17158,6 +17311,11 @@ do_select(JOIN *join,List<Item> *fields,TABLE *table,Procedure *procedure)
     if ((error == NESTED_LOOP_OK || error == NESTED_LOOP_NO_MORE_ROWS) &&
         join->thd->killed != ABORT_QUERY)
       error= sub_select(join,join_tab,1);
+    else if (join->thd->killed == ABORT_QUERY && join->group_by_hash &&
+             join->group_by_hash->table == table &&
+             !join->group_by_hash->is_empty() &&
+             write_group_by_hash(join, table))
+      error= NESTED_LOOP_ERROR;       // Could not keep the groups found so far
     if (error == NESTED_LOOP_QUERY_LIMIT)
       error= NESTED_LOOP_OK;                    /* select_limit used */
   }
@@ -18857,20 +19015,64 @@ end:
   DBUG_RETURN(NESTED_LOOP_OK);
 }
 
+/**
+  Write the groups kept in memory by end_update() to the temporary table.
+
+  The groups are not in the table, so they are just added to it.
+*/
+
+static bool write_group_by_hash(JOIN *join, TABLE *table)
+{
+  Group_by_hash *hash= join->group_by_hash;
+  uchar *record;
+  int error;
+  DBUG_ENTER("write_group_by_hash");
+
+  hash->start_reading();
+  while ((record= hash->read_next()))
+  {
+    memcpy(table->record[0], record, table->s->reclength);
+    if ((error= table->file->ha_write_tmp_row(table->record[0])) &&
+        create_internal_tmp_table_from_heap(join->thd, table,
+                                            join->tmp_table_param.start_recinfo,
+                                            &join->tmp_table_param.recinfo,
+                                            error, 0, NULL))
+      DBUG_RETURN(true);
+  }
+  hash->reset();
+  DBUG_RETURN(false);
+}
+
+
 /* ARGSUSED */
-/** Group by searching after group record and updating it if possible. */
+/**
+  Group by searching after group record and updating it if possible.
+
+  The groups are kept in join->group_by_hash as long as they fit in, which
+  saves a lookup and an update of the temporary table for every row. New
+  groups that don't fit in the hash go to the temporary table on disk,
+  and the groups of the hash are written to the table at the end.
+*/
 
 static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 	   bool end_of_records)
 {
   TABLE *table=join->tmp_table;
+  Group_by_hash *hash= join->group_by_hash;
   ORDER   *group;
   int	  error;
   DBUG_ENTER("end_update");
 
+  if (hash && hash->table != table)
+    hash= 0;
+
   if (end_of_records)
+  {
+    if (hash && !hash->is_empty() && write_group_by_hash(join, table))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
     DBUG_RETURN(NESTED_LOOP_OK);
+  }
 
   join->found_records++;
   copy_fields(&join->tmp_table_param);		// Groups are copied twice.
@@ -18892,6 +19094,54 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     if (item->maybe_null)
       group->buff[-1]= (char) group->field->is_null();
   }
+  if (hash)
+  {
+    ulong hash_value;
+    uchar *record;
+    /* Count the lookup as the index read it replaces, see LIMIT ROWS EXAMINED */
+    join->thd->check_limit_rows_examined();
+    if ((record= hash->find(join->tmp_table_param.group_buff, &hash_value)))
+    {						/* Update old group */
+      memcpy(table->record[0], record, table->s->reclength);
+      update_tmptable_sum_func(join->sum_funcs,table);
+      memcpy(record, table->record[0], table->s->reclength);
+      goto end;
+    }
+    /* A group that is not in the hash is in the table if the hash is full */
+    if (hash->has_room())
+    {
+      init_tmptable_sum_functions(join->sum_funcs);
+      if (copy_funcs(join->tmp_table_param.items_to_copy, join->thd) ||
+          hash->add(join->tmp_table_param.group_buff, hash_value,
+                    table->record[0]))
+        DBUG_RETURN(NESTED_LOOP_ERROR);         /* purecov: inspected */
+      join->send_records++;
+      goto end;
+    }
+    if (table->s->db_type() == heap_hton)
+    {
+      /*
+        The hash is full, so the memory for the groups is used up and the
+        table doesn't have any of them yet. Move the table to disk before
+        the first group is written to it, which copies no rows, and add
+        the rest of the groups there.
+      */
+      init_tmptable_sum_functions(join->sum_funcs);
+      if (copy_funcs(join->tmp_table_param.items_to_copy, join->thd) ||
+          create_internal_tmp_table_from_heap(join->thd, table,
+                                              join->tmp_table_param.start_recinfo,
+                                              &join->tmp_table_param.recinfo,
+                                              HA_ERR_RECORD_FILE_FULL, 0, NULL))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      if ((error= table->file->ha_index_init(0, 0)))
+      {
+        table->file->print_error(error, MYF(0));
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      }
+      join->send_records++;
+      goto end;
+    }
+  }
   if (!table->file->ha_index_read_map(table->record[1],
                                       join->tmp_table_param.group_buff,
                                       HA_WHOLE_KEY,
@@ -18925,7 +19175,10 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
       DBUG_RETURN(NESTED_LOOP_ERROR);
     }
 
-    join->join_tab[join->top_join_tab_count-1].next_select=end_unique_update;
+    /* The groups in the hash are looked up here until they are written */
+    if (!hash)
+      join->join_tab[join->top_join_tab_count-1].next_select=
+        end_unique_update;
   }
   join->send_records++;
 end:
@@ -196,6 +196,7 @@ int rr_sequential_and_unpack(READ_RECORD *info);
  *************************************************************************************/
 
 class JOIN_CACHE;
+class Group_by_hash;
 class SJ_TMP_TABLE;
 class JOIN_TAB_RANGE;
 
@@ -853,6 +854,24 @@ public:
 };
 
 
+/**
+  Join order of a SELECT, saved by an execution of a prepared statement
+  for the next ones. See choose_plan().
+*/
+
+struct Saved_join_order
+{
+  table_map const_table_map;
+  uint n_tables;                        /* Number of non-constant tables */
+  struct Table
+  {
+    table_map map;
+    ha_rows records;                    /* JOIN_TAB::records */
+    ha_rows found_records;              /* JOIN_TAB::found_records */
+  } *tables;                            /* The non-constant tables in order */
+};
+
+
 class JOIN :public Sql_alloc
 {
 private:
@@ -1080,6 +1099,8 @@ public:
   TABLE    *tmp_table;
   /// used to store 2 possible tmp table of SELECT
   TABLE    *exec_tmp_table1, *exec_tmp_table2;
+  /// In-memory groups of exec_tmp_table1, see end_update()
+  Group_by_hash *group_by_hash;
   THD	   *thd;
   Item_sum  **sum_funcs, ***sum_funcs_end;
   /** second copy of sumfuncs (for queries with 2 temporary tables */
@@ -1282,6 +1303,7 @@ public:
     examined_rows= 0;
     exec_tmp_table1= 0;
     exec_tmp_table2= 0;
+    group_by_hash= 0;
     sortorder= 0;
     table_reexec[0]= 0;
     join_tab_reexec= 0;
@@ -3440,26 +3440,30 @@ int fill_schema_index_stats(THD *thd, TABLE_LIST *tables, COND *cond)
 }
 
 
-/* collect status for all running threads */
+/*
+  Collect the global status
+
+  NOTES
+    The threads add their status to the global status slabs after every
+    command, so the status of the running threads is included without
+    walking the list of threads. Only the statement being run by the
+    other threads is not counted yet.
+*/
 
 void calc_sum_of_all_status(STATUS_VAR *to)
 {
+  THD *thd;
   DBUG_ENTER("calc_sum_of_all_status");
 
-  /* Ensure that thread id not killed during loop */
-  mysql_mutex_lock(&LOCK_thread_count); // For unlink from list
-
-  I_List_iterator<THD> it(threads);
-  THD *tmp;
-
   /* Get global values as base */
   *to= global_status_var;
 
-  /* Add to this status from existing threads */
-  while ((tmp= it++))
-    add_to_status(to, &tmp->status_var);
-  
-  mysql_mutex_unlock(&LOCK_thread_count);
+  add_global_status_slabs(to);
+
+  /* Add what the current thread has not added to the global status yet */
+  if ((thd= current_thd))
+    add_diff_to_status(to, &thd->status_var, &thd->status_in_global);
+
   DBUG_VOID_RETURN;
 }
 
@@ -21,27 +21,40 @@
 #include "my_base.h"                            /* ha_rows */
 #include "my_sys.h"                             /* qsort2_cmp */
 #include "queues.h"
+#include "sql_const.h"                          /* MAX_SORT_THREADS */
 
 typedef struct st_buffpek BUFFPEK;
 typedef struct st_sort_field SORT_FIELD;
 
 class Field;
 struct TABLE;
+struct Sort_job;
 
 /* Defines used by filesort and uniques */
 
 #define MERGEBUFF		7
 #define MERGEBUFF2		15
 
+/*
+  String key parts shorter than this are not packed: the length prefix and
+  the slower comparison would cost more than the padding saves.
+*/
+#define MIN_PACKED_SORT_KEY_PART_LENGTH 32
+
 /*
    The structure SORT_ADDON_FIELD describes a fixed layout
    for field values appended to sorted values in records to be sorted
    in the sort buffer.
-   Only fixed layout is supported now.
    Null bit maps for the appended values is placed before the values 
    themselves. Offsets are from the last sorted field, that is from the
    record referefence, which is still last component of sorted records.
    It is preserved for backward compatiblility.
+   With packed addon fields (Sort_param::using_packed_addons) the values
+   are stored one after the other with the length of Field::pack() and
+   nothing is stored for NULL values, so only the offset of the first
+   field (the size of the null bit map) and the null bits are used. The
+   packed values are preceded by the 4 byte length of the whole addon
+   part, including the length itself.
    The structure is used tp store values of the additional fields 
    in the sort buffer. It is used also when these values are read
    from a temporary file/buffer. As the reading procedures are beyond the
@@ -66,6 +79,69 @@ struct BUFFPEK_COMPARE_CONTEXT
 };
 
 
+/*
+  Records in the sort buffer and in the merge files are normally of fixed
+  length rec_length: the sort key of sort_length bytes followed by either
+  the addon fields or the record reference.
+
+  Records are of variable length if the sort keys or the addon fields are
+  packed, and rec_length is then the maximum length of a record:
+  - A packed sort key starts with its 4 byte length, including the length
+    itself and the record reference at its end, if any. A key part that
+    is packed (SORT_FIELD::pad_image is set) consists of the null byte, if
+    the part is nullable, a 2 byte length and the key bytes up to the
+    first byte from which on the key is equal to pad_image. Other parts
+    are stored as in a fixed length key.
+  - The packed addon part starts with its 4 byte length,
+    see SORT_ADDON_FIELD.
+*/
+
+/*
+  The threads that help one filesort() to sort its sort buffers.
+
+  The threads are created when the first sort buffer that is worth to be
+  sorted in parallel is sorted, and are then reused for all the ranges and
+  merge rounds of the following sort buffers until end() is called. The
+  number of these threads in the whole server is limited by
+  max_total_sort_threads.
+*/
+
+class Sort_threads
+{
+public:
+  Sort_threads() : m_count(0), m_inited(false) {}
+  ~Sort_threads() { end(); }
+
+  /**
+    Makes sure that there are n_threads - 1 threads, if the limit allows.
+
+    @return the number of threads that sort, including the caller
+  */
+  uint start(uint n_threads);
+  /// Runs the jobs by the threads and the caller, waits until all are done.
+  void run(Sort_job *jobs, uint count);
+  /// Stops the threads.
+  void end();
+
+  /* For the threads */
+  Sort_job *next_job();
+  void job_done();
+
+private:
+  mysql_mutex_t m_lock;
+  mysql_cond_t m_cond_job;                 // new jobs, or end()
+  mysql_cond_t m_cond_done;                // all the jobs are done
+  pthread_t m_threads[MAX_SORT_THREADS];
+  uint m_count;                            // number of threads
+  Sort_job *m_jobs;
+  uint m_job_count;
+  uint m_next_job;                         // the first job not started
+  uint m_jobs_left;                        // jobs that are not done
+  bool m_stop;
+  bool m_inited;
+};
+
+
 class Sort_param {
 public:
   uint rec_length;            // Length of sorted records.
@@ -74,6 +150,10 @@ public:
   uint addon_length;          // Length of added packed fields.
   uint res_length;            // Length of records in final sorted file/buffer.
   uint max_keys_per_buffer;   // Max keys / buffer.
+  uint max_threads;           // Max threads sorting one buffer.
+  Sort_threads *threads;      // The threads sorting the buffers, or NULL.
+  bool using_packed_sortkeys; // String key parts are packed.
+  bool using_packed_addons;   // Addon fields are packed.
   uint min_dupl_count;
   ha_rows max_rows;           // Select limit, or HA_POS_ERROR if unlimited.
   ha_rows examined_rows;      // Number of examined rows.
@@ -84,6 +164,8 @@ public:
   uchar *unique_buff;
   bool not_killable;
   char* tmp_buffer;
+  uchar *pad_images;          // Pad images of the packed key parts.
+  uchar *packed_record;       // A packed record is made here.
   // The fields below are used only by Unique class.
   qsort2_cmp compare;
   BUFFPEK_COMPARE_CONTEXT cmp_context;
@@ -95,8 +177,46 @@ public:
   void init_for_filesort(uint sortlen, TABLE *table,
                          ulong max_length_for_sort_data,
                          ha_rows maxrows, bool sort_positions);
+  void try_to_pack_sortkeys();
+  void try_to_pack_addons();
+
+  bool using_packed_records() const
+  { return using_packed_sortkeys || using_packed_addons; }
+
+  /// Length of the sort key of a record, including the record reference.
+  uint get_sort_key_length(const uchar *rec) const
+  { return using_packed_sortkeys ? uint4korr(rec) : sort_length; }
+
+  uint get_record_length(const uchar *rec) const
+  {
+    if (!using_packed_records())
+      return rec_length;
+    uint key_length= get_sort_key_length(rec);
+    return key_length + (using_packed_addons ? uint4korr(rec + key_length) :
+                         addon_length);
+  }
+
+  /// The part of a record that is returned: the addon fields or the ref.
+  uchar *get_result(uchar *rec, uint *length) const
+  {
+    if (!using_packed_records())
+    {
+      *length= res_length;
+      return rec + rec_length - res_length;
+    }
+    uint key_length= get_sort_key_length(rec);
+    if (!addon_field)
+    {
+      *length= ref_length;
+      return rec + key_length - ref_length;
+    }
+    *length= using_packed_addons ? uint4korr(rec + key_length) : addon_length;
+    return rec + key_length;
+  }
 };
 
+int compare_packed_sort_keys(const Sort_param *param, uchar **a, uchar **b);
+
 
 int merge_many_buff(Sort_param *param, uchar *sort_buffer,
 		    BUFFPEK *buffpek,
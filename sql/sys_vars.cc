@@ -1943,6 +1943,24 @@ static Sys_var_ulong Sys_max_sort_length(
        SESSION_VAR(max_sort_length), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(4, 8192*1024L), DEFAULT(1024), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_max_sort_threads(
+       "max_sort_threads",
+       "The maximum number of threads used to sort the contents of the sort "
+       "buffer of one query. Large sort buffers are split into parts that "
+       "are sorted in parallel and then merged. 1 means that the sort is "
+       "done by the connection thread only",
+       SESSION_VAR(max_sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, MAX_SORT_THREADS), DEFAULT(1), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_max_total_sort_threads(
+       "max_total_sort_threads",
+       "The maximum number of threads that help the connection threads to "
+       "sort their sort buffers (see max_sort_threads) in the whole server. "
+       "A sort that cannot get all the threads it asks for uses fewer. "
+       "0 means that every sort is done by its connection thread only",
+       GLOBAL_VAR(max_total_sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 64*1024), DEFAULT(MAX_SORT_THREADS), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_max_sp_recursion_depth(
        "max_sp_recursion_depth",
        "Maximum stored procedure recursion depth",
@@ -2021,6 +2039,24 @@ static Sys_var_ulong Sys_net_buffer_length(
        VALID_RANGE(1024, 1024*1024), DEFAULT(16384), BLOCK_SIZE(1024),
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(check_net_buffer_length));
 
+static Sys_var_ulong Sys_net_result_buffer_length(
+       "net_result_buffer_length",
+       "Buffer length for sending large result sets. When the rows of a "
+       "result set don't fit in the buffer of net_buffer_length bytes, it "
+       "is grown to this size, so that they are sent with fewer writes. "
+       "The buffer is shrunk back when the statement ends",
+       SESSION_VAR(net_result_buffer_length), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1024, 1024*1024*1024), DEFAULT(256*1024),
+       BLOCK_SIZE(1024));
+
+static Sys_var_ulong Sys_net_compression_level(
+       "net_compression_level",
+       "The zlib compression level, from 1 (fastest) to 9 (smallest), of "
+       "the packets sent to clients that use the compressed protocol as "
+       "one stream. Takes effect for new connections",
+       GLOBAL_VAR(net_compression_level), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 9), DEFAULT(6), BLOCK_SIZE(1));
+
 static bool fix_net_read_timeout(sys_var *self, THD *thd, enum_var_type type)
 {
   if (type != OPT_GLOBAL)
@@ -2158,6 +2194,25 @@ static Sys_var_ulong Sys_optimizer_search_depth(
        NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_optimizer_search_depth));
 
+static Sys_var_mybool Sys_prepared_stmt_plan_cache(
+       "prepared_stmt_plan_cache",
+       "Save the join order chosen by the first execution of a prepared "
+       "statement, and use it in the next executions without a search, "
+       "as long as the same tables are constant and the estimated numbers "
+       "of rows of the tables change at most by a factor of two",
+       SESSION_VAR(prepared_stmt_plan_cache), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
+static Sys_var_ulong Sys_normalized_stmt_cache_size(
+       "normalized_stmt_cache_size",
+       "The maximum number of text protocol SELECT statements that a "
+       "connection keeps prepared. The literals of the WHERE clauses of a "
+       "query are replaced with parameters, and the queries that differ "
+       "only in these literals are executed with the same prepared "
+       "statement, without being parsed. 0 disables the cache",
+       SESSION_VAR(normalized_stmt_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024), DEFAULT(0), BLOCK_SIZE(1));
+
 /* this is used in the sigsegv handler */
 export const char *optimizer_switch_names[]=
 {
@@ -2617,6 +2672,14 @@ static Sys_var_ulong Sys_query_cache_min_res_unit(
        BLOCK_SIZE(8), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_qcache_min_res_unit));
 
+static Sys_var_uint Sys_query_cache_partitions(
+       "query_cache_partitions",
+       "The number of partitions of the query cache. The queries are "
+       "spread over the partitions by their hash, and each partition has "
+       "its own lock and 1/query_cache_partitions of query_cache_size",
+       READ_ONLY GLOBAL_VAR(query_cache_partitions), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
 static const char *query_cache_type_names[]= { "OFF", "ON", "DEMAND", 0 };
 static bool check_query_cache_type(sys_var *self, THD *thd, set_var *var)
 {
@@ -3056,12 +3119,36 @@ static Sys_var_ulong Sys_table_cache_size(
        BLOCK_SIZE(1), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_table_open_cache));
 
+static Sys_var_uint Sys_table_cache_instances(
+       "table_open_cache_instances",
+       "The number of table cache instances. Each instance has its own "
+       "lists of unused tables and its own lock, and a connection uses the "
+       "instance chosen by its id. table_open_cache is divided among them",
+       READ_ONLY GLOBAL_VAR(tc_instances), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(1), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_thread_cache_size(
        "thread_cache_size",
        "How many threads we should keep in a cache for reuse",
        GLOBAL_VAR(thread_cache_size), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 16384), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_connection_cache_size(
+       "connection_cache_size",
+       "How many connection objects (THD), with their preallocated buffers, "
+       "we should keep in a cache for reuse by new connections",
+       GLOBAL_VAR(connection_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 16384), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_acceptor_threads(
+       "acceptor_threads",
+       "Number of threads accepting connections on the TCP/IP port. "
+       "Each thread has its own listening socket, bound to the port with "
+       "SO_REUSEPORT, and the kernel spreads the new connections between "
+       "them. Only supported on systems that have SO_REUSEPORT",
+       READ_ONLY GLOBAL_VAR(acceptor_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 256), DEFAULT(1), BLOCK_SIZE(1));
+
 #ifdef HAVE_POOL_OF_THREADS
 static bool fix_tp_max_threads(sys_var *, THD *, enum_var_type)
 {
@@ -3118,6 +3205,15 @@ static Sys_var_uint Sys_threadpool_min_threads(
   ON_UPDATE(fix_tp_min_threads)
   );
 #else
+static Sys_var_uint Sys_threadpool_high_prio_tickets(
+  "thread_pool_high_prio_tickets",
+  "Number of times a connection inside a transaction may be put into the "
+  "high priority queue before it is queued like any other connection. "
+  "High priority connections are served first, so that open transactions "
+  "finish before new ones are started. 0 disables the high priority queue.",
+  GLOBAL_VAR(threadpool_high_prio_tickets), CMD_LINE(REQUIRED_ARG),
+  VALID_RANGE(0, UINT_MAX), DEFAULT(UINT_MAX), BLOCK_SIZE(1)
+);
 static Sys_var_uint Sys_threadpool_idle_thread_timeout(
   "thread_pool_idle_timeout",
   "Timeout in seconds for an idle thread in the thread pool."
@@ -3125,6 +3221,16 @@ static Sys_var_uint Sys_threadpool_idle_thread_timeout(
   GLOBAL_VAR(threadpool_idle_timeout), CMD_LINE(REQUIRED_ARG),
   VALID_RANGE(1, UINT_MAX), DEFAULT(60), BLOCK_SIZE(1)
 );
+static Sys_var_uint Sys_threadpool_login_threads(
+  "thread_pool_login_threads",
+  "Number of threads doing the handshake and authentication of new "
+  "connections, SSL handshake included. Connections are given to the "
+  "thread groups once logged in, so that many new connections do not "
+  "slow down the queries of the existing ones. "
+  "If 0, logins are done by the worker threads of the groups.",
+  READ_ONLY GLOBAL_VAR(threadpool_login_threads), CMD_LINE(REQUIRED_ARG),
+  VALID_RANGE(0, 1000), DEFAULT(0), BLOCK_SIZE(1)
+);
 static Sys_var_uint Sys_threadpool_oversubscribe(
   "thread_pool_oversubscribe",
   "How many additional active worker threads in a group are allowed.",
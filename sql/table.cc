@@ -293,6 +293,7 @@ TABLE_SHARE *alloc_table_share(const char *db, const char *table_name,
   char *key_buff, *path_buff;
   char path[FN_REFLEN];
   uint path_length;
+  TABLE_SHARE::TABLE_list *free_tables;
   DBUG_ENTER("alloc_table_share");
   DBUG_PRINT("enter", ("table: '%s'.'%s'", db, table_name));
 
@@ -303,9 +304,11 @@ TABLE_SHARE *alloc_table_share(const char *db, const char *table_name,
                        &share, sizeof(*share),
                        &key_buff, key_length,
                        &path_buff, path_length + 1,
+                       &free_tables, sizeof(*free_tables) * tc_instances,
                        NULL))
   {
     bzero((char*) share, sizeof(*share));
+    share->tdc.free_tables= free_tables;
 
     share->set_table_cache_key(key_buff, key, key_length);
 
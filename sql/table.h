@@ -332,12 +332,13 @@ public:
   size_t    addon_length;       /* Length of the buffer */
   struct st_sort_addon_field *addon_field;     /* Pointer to the fields info */
   void    (*unpack)(struct st_sort_addon_field *, uchar *, uchar *); /* To unpack back */
+  bool      using_packed_addons; /* Addon fields are of variable length */
   uchar     *record_pointers;    /* If sorted in memory */
   ha_rows   found_records;      /* How many records in sort */
 
   /** Sort filesort_buffer */
-  void sort_buffer(Sort_param *param, uint count)
-  { filesort_buffer.sort_buffer(param, count); }
+  bool sort_buffer(Sort_param *param, uint count)
+  { return filesort_buffer.sort_buffer(param, count); }
 
   /**
      Accessors for Filesort_buffer (which @c).
@@ -345,6 +346,9 @@ public:
   uchar *get_record_buffer(uint idx)
   { return filesort_buffer.get_record_buffer(idx); }
 
+  bool add_packed_record(uint idx, const uchar *record, uint length)
+  { return filesort_buffer.add_packed_record(idx, record, length); }
+
   uchar **get_sort_keys()
   { return filesort_buffer.get_sort_keys(); }
 
@@ -616,7 +620,7 @@ struct TABLE_SHARE
   struct
   {
     /**
-      Protects ref_count, m_flush_tickets, all_tables, free_tables, flushed,
+      Protects ref_count, m_flush_tickets, all_tables, flushed,
       all_tables_refs.
     */
     mysql_mutex_t LOCK_table_share;
@@ -630,10 +634,11 @@ struct TABLE_SHARE
     Wait_for_flush_list m_flush_tickets;
     /*
       Doubly-linked (back-linked) lists of used and unused TABLE objects
-      for this share.
+      for this share. There is a list of unused objects for each table
+      cache instance, protected by the mutex of the instance.
     */
     All_share_tables_list all_tables;
-    TABLE_list free_tables;
+    TABLE_list *free_tables;
     ulong version;
     bool flushed;
   } tdc;
@@ -1031,6 +1036,8 @@ public:
   THD	*in_use;                        /* Which thread uses this */
   /* Time when table was released to table cache. Valid for unused tables. */
   ulonglong tc_time;
+  /* Table cache instance that the table belongs to */
+  uint instance;
   Field **field;			/* Pointer to fields */
 
   uchar *record[2];			/* Pointer to records */
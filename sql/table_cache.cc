@@ -42,10 +42,21 @@
   - alloc_table_share()
   - free_table_share()
 
+  Table cache instances:
+  The table cache is split into table_open_cache_instances instances. Each
+  TABLE object belongs to the instance of the thread that created it, and
+  TABLE_SHARE::tdc.free_tables has one list of unused objects per instance,
+  protected by the mutex of the instance. A thread acquires and releases
+  objects through its own instance, so threads using the same table don't
+  all wait for TABLE_SHARE::tdc.LOCK_table_share. If the list of its own
+  instance is empty, a thread borrows an unused object of another instance
+  if that one is not locked. table_open_cache is divided among the instances.
+
   Table cache invariants:
   - TABLE_SHARE::free_tables shall not contain objects with TABLE::in_use != 0
   - TABLE_SHARE::free_tables shall not receive new objects if
     TABLE_SHARE::tdc.flushed is true
+  - TABLE_SHARE::tdc.free_tables[i] shall only contain objects of instance i
 */
 
 #include "my_global.h"
@@ -56,6 +67,7 @@
 /** Configuration. */
 ulong tdc_size; /**< Table definition cache threshold for LRU eviction. */
 ulong tc_size; /**< Table cache threshold for LRU eviction. */
+uint tc_instances; /**< Number of table cache instances. */
 
 /** Data collections. */
 static HASH tdc_hash; /**< Collection of TABLE_SHARE objects. */
@@ -66,7 +78,22 @@ static int64 tdc_version;  /* Increments on each reload */
 static int64 last_table_id;
 static bool tdc_inited;
 
-static int32 tc_count; /**< Number of TABLE objects in table cache. */
+
+/**
+  Table cache instance.
+*/
+
+struct Table_cache_instance
+{
+  /** Protects TABLE_SHARE::tdc.free_tables[] of this instance. */
+  mysql_mutex_t LOCK_table_cache;
+  /** Number of TABLE objects of this instance. Protected by LOCK_tdc_atomics */
+  int32 records;
+  /** Keep the mutexes of the instances in different cache lines */
+  char pad[64];
+};
+
+static Table_cache_instance *tc;
 
 
 /**
@@ -83,10 +110,12 @@ static mysql_rwlock_t LOCK_tdc; /**< Protects tdc_hash. */
 my_atomic_rwlock_t LOCK_tdc_atomics; /**< Protects tdc_version. */
 
 #ifdef HAVE_PSI_INTERFACE
-static PSI_mutex_key key_LOCK_unused_shares, key_TABLE_SHARE_LOCK_table_share;
+static PSI_mutex_key key_LOCK_unused_shares, key_TABLE_SHARE_LOCK_table_share,
+                     key_LOCK_table_cache;
 static PSI_mutex_info all_tc_mutexes[]=
 {
   { &key_LOCK_unused_shares, "LOCK_unused_shares", PSI_FLAG_GLOBAL },
+  { &key_LOCK_table_cache, "LOCK_table_cache", 0 },
   { &key_TABLE_SHARE_LOCK_table_share, "TABLE_SHARE::tdc.LOCK_table_share", 0 }
 };
 
@@ -137,30 +166,80 @@ static void init_tc_psi_keys(void)
 
 uint tc_records(void)
 {
-  uint count;
+  uint count= 0;
   my_atomic_rwlock_rdlock(&LOCK_tdc_atomics);
-  count= my_atomic_load32(&tc_count);
+  for (uint i= 0; i < tc_instances; i++)
+    count+= my_atomic_load32(&tc[i].records);
   my_atomic_rwlock_rdunlock(&LOCK_tdc_atomics);
   return count;
 }
 
 
+/**
+  Get the threshold for LRU eviction of a table cache instance.
+
+  Rounded up, so that each instance can cache a table unless tc_size is 0.
+*/
+
+static inline int32 tc_instance_size(void)
+{
+  return (int32) ((tc_size + tc_instances - 1) / tc_instances);
+}
+
+
+/**
+  Get the table cache instance of a thread.
+*/
+
+static inline uint tc_instance(THD *thd)
+{
+  return (uint) (thd->thread_id % tc_instances);
+}
+
+
 /**
   Remove TABLE object from table cache.
 
-  - decrement tc_count
+  - decrement TABLE object counter of the instance
   - remove object from TABLE_SHARE::tdc.all_tables
 */
 
 static void tc_remove_table(TABLE *table)
 {
   my_atomic_rwlock_wrlock(&LOCK_tdc_atomics);
-  my_atomic_add32(&tc_count, -1);
+  my_atomic_add32(&tc[table->instance].records, -1);
   my_atomic_rwlock_wrunlock(&LOCK_tdc_atomics);
   table->s->tdc.all_tables.remove(table);
 }
 
 
+/**
+  Remove all unused TABLE objects of a share from table cache.
+
+  @pre TABLE_SHARE::tdc.LOCK_table_share is locked and the MDL deadlock
+       detector doesn't traverse TABLE_SHARE::tdc.all_tables.
+
+  @param share         the share
+  @param purge_tables  [out] the removed objects, to be freed by the caller
+*/
+
+static void tc_remove_all_unused_tables(TABLE_SHARE *share,
+                                        TABLE_SHARE::TABLE_list *purge_tables)
+{
+  TABLE *table;
+  for (uint i= 0; i < tc_instances; i++)
+  {
+    mysql_mutex_lock(&tc[i].LOCK_table_cache);
+    while ((table= share->tdc.free_tables[i].pop_front()))
+    {
+      tc_remove_table(table);
+      purge_tables->push_front(table);
+    }
+    mysql_mutex_unlock(&tc[i].LOCK_table_cache);
+  }
+}
+
+
 /**
   Wait for MDL deadlock detector to complete traversing tdc.all_tables.
 
@@ -175,12 +254,14 @@ static void tc_wait_for_mdl_deadlock_detector(TABLE_SHARE *share)
 
 
 /**
-  Get last element of tdc.free_tables.
+  Get last element of tdc.free_tables of an instance.
+
+  @pre The mutex of the instance is locked.
 */
 
-static TABLE *tc_free_tables_back(TABLE_SHARE *share)
+static TABLE *tc_free_tables_back(TABLE_SHARE *share, uint instance)
 {
-  TABLE_SHARE::TABLE_list::Iterator it(share->tdc.free_tables);
+  TABLE_SHARE::TABLE_list::Iterator it(share->tdc.free_tables[instance]);
   TABLE *entry, *last= 0;
    while ((entry= it++))
      last= entry;
@@ -218,11 +299,7 @@ void tc_purge(bool mark_flushed)
 
     if (mark_flushed)
       share->tdc.flushed= true;
-    while ((table= share->tdc.free_tables.pop_front()))
-    {
-      tc_remove_table(table);
-      purge_tables.push_front(table);
-    }
+    tc_remove_all_unused_tables(share, &purge_tables);
     mysql_mutex_unlock(&share->tdc.LOCK_table_share);
   }
   tdc_it.deinit();
@@ -239,10 +316,12 @@ void tc_purge(bool mark_flushed)
 
   Added object cannot be evicted or acquired.
 
+  The object belongs to the table cache instance of the thread.
+
   While locked:
   - add object to TABLE_SHARE::tdc.all_tables
-  - increment tc_count
-  - evict LRU object from table cache if we reached threshold
+  - increment TABLE object counter of the instance
+  - evict LRU object of the instance if it reached threshold
 
   While unlocked:
   - free evicted object
@@ -251,7 +330,9 @@ void tc_purge(bool mark_flushed)
 void tc_add_table(THD *thd, TABLE *table)
 {
   bool need_purge;
+  uint i= tc_instance(thd);
   DBUG_ASSERT(table->in_use == thd);
+  table->instance= i;
   mysql_mutex_lock(&table->s->tdc.LOCK_table_share);
   tc_wait_for_mdl_deadlock_detector(table->s);
   table->s->tdc.all_tables.push_front(table);
@@ -259,7 +340,7 @@ void tc_add_table(THD *thd, TABLE *table)
 
   /* If we have too many TABLE instances around, try to get rid of them */
   my_atomic_rwlock_wrlock(&LOCK_tdc_atomics);
-  need_purge= my_atomic_add32(&tc_count, 1) >= (int32) tc_size;
+  need_purge= my_atomic_add32(&tc[i].records, 1) >= tc_instance_size();
   my_atomic_rwlock_wrunlock(&LOCK_tdc_atomics);
 
   if (need_purge)
@@ -273,14 +354,14 @@ void tc_add_table(THD *thd, TABLE *table)
     tdc_it.init();
     while ((share= tdc_it.next()))
     {
-      mysql_mutex_lock(&share->tdc.LOCK_table_share);
-      if ((entry= tc_free_tables_back(share)) &&
+      mysql_mutex_lock(&tc[i].LOCK_table_cache);
+      if ((entry= tc_free_tables_back(share, i)) &&
           (!purge_share || entry->tc_time < purge_time))
       {
           purge_share= share;
           purge_time= entry->tc_time;
       }
-      mysql_mutex_unlock(&share->tdc.LOCK_table_share);
+      mysql_mutex_unlock(&tc[i].LOCK_table_cache);
     }
 
     if (purge_share)
@@ -293,16 +374,21 @@ void tc_add_table(THD *thd, TABLE *table)
         just go ahead, number of objects in table cache will normalize
         eventually.
       */
-      if ((entry= tc_free_tables_back(purge_share)) &&
+      mysql_mutex_lock(&tc[i].LOCK_table_cache);
+      if ((entry= tc_free_tables_back(purge_share, i)) &&
           entry->tc_time == purge_time)
       {
-        entry->s->tdc.free_tables.remove(entry);
+        entry->s->tdc.free_tables[i].remove(entry);
+        mysql_mutex_unlock(&tc[i].LOCK_table_cache);
         tc_remove_table(entry);
         mysql_mutex_unlock(&purge_share->tdc.LOCK_table_share);
         intern_close_table(entry);
       }
       else
+      {
+        mysql_mutex_unlock(&tc[i].LOCK_table_cache);
         mysql_mutex_unlock(&purge_share->tdc.LOCK_table_share);
+      }
     }
     else
       tdc_it.deinit();
@@ -317,31 +403,56 @@ void tc_add_table(THD *thd, TABLE *table)
 
   Acquired object cannot be evicted or acquired again.
 
-  While locked:
-  - pop object from TABLE_SHARE::tdc.free_tables
+  While locked by the mutex of the instance of thd:
+  - pop object from TABLE_SHARE::tdc.free_tables of the instance
+  - mark object used by thd
 
-  While unlocked:
+  If there is none, while locked by the mutex of another instance, unless
+  the mutex is locked by somebody else:
+  - pop object from TABLE_SHARE::tdc.free_tables of that instance
   - mark object used by thd
 
+  The object is marked before the mutex is released, as a table that is
+  in TABLE_SHARE::tdc.all_tables but not in free_tables must have
+  in_use set, see TABLE_SHARE::visit_subgraph().
+
   @return TABLE object, or NULL if no unused objects.
 */
 
 static TABLE *tc_acquire_table(THD *thd, TABLE_SHARE *share)
 {
   TABLE *table;
+  uint i= tc_instance(thd);
 
-  mysql_mutex_lock(&share->tdc.LOCK_table_share);
-  table= share->tdc.free_tables.pop_front();
-  if (table)
+  mysql_mutex_lock(&tc[i].LOCK_table_cache);
+  if ((table= share->tdc.free_tables[i].pop_front()))
   {
     DBUG_ASSERT(!table->in_use);
     table->in_use= thd;
+  }
+  mysql_mutex_unlock(&tc[i].LOCK_table_cache);
+
+  for (uint n= 1; !table && n < tc_instances; n++)
+  {
+    uint j= (i + n) % tc_instances;
+    if (!mysql_mutex_trylock(&tc[j].LOCK_table_cache))
+    {
+      if ((table= share->tdc.free_tables[j].pop_front()))
+      {
+        DBUG_ASSERT(!table->in_use);
+        table->in_use= thd;
+      }
+      mysql_mutex_unlock(&tc[j].LOCK_table_cache);
+    }
+  }
+
+  if (table)
+  {
     /* The ex-unused table must be fully functional. */
     DBUG_ASSERT(table->db_stat && table->file);
     /* The children must be detached from the table. */
     DBUG_ASSERT(!table->file->extra(HA_EXTRA_IS_ATTACHED_CHILDREN));
   }
-  mysql_mutex_unlock(&share->tdc.LOCK_table_share);
   return table;
 }
 
@@ -353,19 +464,22 @@ static TABLE *tc_acquire_table(THD *thd, TABLE_SHARE *share)
 
   Released object may be evicted or acquired again.
 
-  While locked:
-  - if object is marked for purge, decrement tc_count
-  - add object to TABLE_SHARE::tdc.free_tables
-  - evict LRU object from table cache if we reached threshold
+  While locked by the mutex of the instance of the object:
+  - add object to TABLE_SHARE::tdc.free_tables of the instance
+
+  While locked by TABLE_SHARE::tdc.LOCK_table_share:
+  - if object is marked for purge or the instance reached threshold,
+    decrement TABLE object counter of the instance
 
   While unlocked:
   - mark object not in use by any thread
-  - free evicted/purged object
+  - free purged object
 
   @note Another thread may mark share for purge any moment (even
   after version check). It means to-be-purged object may go to
   unused lists. This other thread is expected to call tc_purge(),
-  which is synchronized with us on TABLE_SHARE::tdc.LOCK_table_share.
+  which marks the share flushed before it locks the mutexes of the
+  instances, so it is synchronized with us on the mutex of the instance.
 
   @return
     @retval true  object purged
@@ -374,20 +488,25 @@ static TABLE *tc_acquire_table(THD *thd, TABLE_SHARE *share)
 
 bool tc_release_table(TABLE *table)
 {
+  uint i= table->instance;
+  int32 records;
   DBUG_ASSERT(table->in_use);
   DBUG_ASSERT(table->file);
 
-  if (table->needs_reopen() || tc_records() > tc_size)
-  {
-    mysql_mutex_lock(&table->s->tdc.LOCK_table_share);
+  my_atomic_rwlock_rdlock(&LOCK_tdc_atomics);
+  records= my_atomic_load32(&tc[i].records);
+  my_atomic_rwlock_rdunlock(&LOCK_tdc_atomics);
+  if (table->needs_reopen() || records > tc_instance_size())
     goto purge;
-  }
 
   table->tc_time= my_interval_timer();
 
-  mysql_mutex_lock(&table->s->tdc.LOCK_table_share);
+  mysql_mutex_lock(&tc[i].LOCK_table_cache);
   if (table->s->tdc.flushed)
+  {
+    mysql_mutex_unlock(&tc[i].LOCK_table_cache);
     goto purge;
+  }
   /*
     in_use doesn't really need mutex protection, but must be reset after
     checking tdc.flushed and before this table appears in free_tables.
@@ -396,11 +515,12 @@ bool tc_release_table(TABLE *table)
   */
   table->in_use= 0;
   /* Add table to the list of unused TABLE objects for this share. */
-  table->s->tdc.free_tables.push_front(table);
-  mysql_mutex_unlock(&table->s->tdc.LOCK_table_share);
+  table->s->tdc.free_tables[i].push_front(table);
+  mysql_mutex_unlock(&tc[i].LOCK_table_cache);
   return false;
 
 purge:
+  mysql_mutex_lock(&table->s->tdc.LOCK_table_share);
   tc_wait_for_mdl_deadlock_detector(table->s);
   tc_remove_table(table);
   mysql_mutex_unlock(&table->s->tdc.LOCK_table_share);
@@ -483,6 +603,12 @@ int tdc_init(void)
 #ifdef HAVE_PSI_INTERFACE
   init_tc_psi_keys();
 #endif
+  if (!(tc= (Table_cache_instance*) my_malloc(sizeof(*tc) * tc_instances,
+                                              MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  for (uint i= 0; i < tc_instances; i++)
+    mysql_mutex_init(key_LOCK_table_cache, &tc[i].LOCK_table_cache,
+                     MY_MUTEX_INIT_FAST);
   tdc_inited= true;
   mysql_mutex_init(key_LOCK_unused_shares, &LOCK_unused_shares,
                    MY_MUTEX_INIT_FAST);
@@ -536,6 +662,10 @@ void tdc_deinit(void)
     my_atomic_rwlock_destroy(&LOCK_tdc_atomics);
     mysql_rwlock_destroy(&LOCK_tdc);
     mysql_mutex_destroy(&LOCK_unused_shares);
+    for (uint i= 0; i < tc_instances; i++)
+      mysql_mutex_destroy(&tc[i].LOCK_table_cache);
+    my_free(tc);
+    tc= 0;
   }
   DBUG_VOID_RETURN;
 }
@@ -601,7 +731,8 @@ void tdc_init_share(TABLE_SHARE *share)
   mysql_cond_init(key_TABLE_SHARE_COND_release, &share->tdc.COND_release, 0);
   share->tdc.m_flush_tickets.empty();
   share->tdc.all_tables.empty();
-  share->tdc.free_tables.empty();
+  for (uint i= 0; i < tc_instances; i++)
+    share->tdc.free_tables[i].empty();
   tdc_assign_new_table_id(share);
   share->tdc.version= tdc_refresh_version();
   share->tdc.flushed= false;
@@ -620,7 +751,10 @@ void tdc_deinit_share(TABLE_SHARE *share)
   DBUG_ASSERT(share->tdc.ref_count == 0);
   DBUG_ASSERT(share->tdc.m_flush_tickets.is_empty());
   DBUG_ASSERT(share->tdc.all_tables.is_empty());
-  DBUG_ASSERT(share->tdc.free_tables.is_empty());
+#ifndef DBUG_OFF
+  for (uint i= 0; i < tc_instances; i++)
+    DBUG_ASSERT(share->tdc.free_tables[i].is_empty());
+#endif
   DBUG_ASSERT(share->tdc.all_tables_refs == 0);
   mysql_cond_destroy(&share->tdc.COND_release);
   mysql_mutex_destroy(&share->tdc.LOCK_table_share);
@@ -1000,11 +1134,7 @@ bool tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
     if (remove_type != TDC_RT_REMOVE_NOT_OWN_KEEP_SHARE)
       share->tdc.flushed= true;
 
-    while ((table= share->tdc.free_tables.pop_front()))
-    {
-      tc_remove_table(table);
-      purge_tables.push_front(table);
-    }
+    tc_remove_all_unused_tables(share, &purge_tables);
     if (kill_delayed_threads)
       kill_delayed_threads_for_table(share);
 
@@ -1030,7 +1160,7 @@ bool tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
         Even though current thread holds exclusive metadata lock on this share
         (asserted above), concurrent FLUSH TABLES threads may be in process of
         closing unused table instances belonging to this share. E.g.:
-        thr1 (FLUSH TABLES): table= share->tdc.free_tables.pop_front();
+        thr1 (FLUSH TABLES): table= share->tdc.free_tables[i].pop_front();
         thr1 (FLUSH TABLES): share->tdc.all_tables.remove(table);
         thr2 (ALTER TABLE): tdc_remove_table();
         thr1 (FLUSH TABLES): intern_close_table(table);
@@ -26,6 +26,7 @@ enum enum_tdc_remove_table_type
 
 extern ulong tdc_size;
 extern ulong tc_size;
+extern uint tc_instances;
 
 extern int tdc_init(void);
 extern void tdc_start_shutdown(void);
@@ -23,6 +23,8 @@ extern uint threadpool_max_size;
 extern uint threadpool_stall_limit;  /* time interval in 10 ms units for stall checks*/
 extern uint threadpool_max_threads;  /* Maximum threads in pool */
 extern uint threadpool_oversubscribe;  /* Maximum active threads in group */
+extern uint threadpool_high_prio_tickets; /* Queue jumps per transaction */
+extern uint threadpool_login_threads; /* Threads doing logins, 0 = workers */
 
 
 
@@ -58,6 +60,47 @@ struct TP_STATISTICS
 extern TP_STATISTICS tp_stats;
 
 
+/*
+  Per thread group state and statistics, for INFORMATION_SCHEMA.THREAD_POOL_*
+
+  Bucket i of a queue wait histogram counts events that waited in the
+  workqueue for less than 10^(i+1) microseconds, the last bucket counts
+  all longer waits.
+*/
+#define TP_QUEUE_WAIT_BUCKETS 10
+
+struct TP_GROUP_STATS
+{
+  /* Current state */
+  int  connections;
+  int  threads;
+  int  active_threads;
+  int  standby_threads;
+  uint queue_length;
+  uint high_prio_queue_length;
+  bool has_listener;
+  bool is_stalled;
+
+  /* Counters since pool startup */
+  ulonglong thread_creations;
+  ulonglong thread_creations_due_to_stall;
+  ulonglong wakes;
+  ulonglong wakes_due_to_stall;
+  ulonglong stalls;
+  ulonglong listener_wakeups;
+  ulonglong polls_by_worker;
+  ulonglong dequeues_by_listener;
+  ulonglong dequeues_by_worker;
+  ulonglong events_stolen;
+  ulonglong high_prio_dequeues;
+  /* [0] normal priority queue, [1] high priority queue */
+  ulonglong queue_wait[2][TP_QUEUE_WAIT_BUCKETS];
+};
+
+extern uint tp_get_group_count();
+extern int  tp_get_group_stats(uint group_id, TP_GROUP_STATS *stats);
+
+
 /* Functions to set threadpool parameters */
 extern void tp_set_min_threads(uint val);
 extern void tp_set_max_threads(uint val);
@@ -34,6 +34,8 @@ uint threadpool_max_size;
 uint threadpool_stall_limit;
 uint threadpool_max_threads;
 uint threadpool_oversubscribe;
+uint threadpool_high_prio_tickets;
+uint threadpool_login_threads;
 
 /* Stats */
 TP_STATISTICS tp_stats;
@@ -244,6 +246,9 @@ int threadpool_process_request(THD *thd)
     { 
       /* More info on this debug sync is in sql_parse.cc*/
       DEBUG_SYNC(thd, "before_do_command_net_read");
+      /* Results of pipelined commands are not kept while in poll */
+      if ((retval= net_flush_pending(&thd->net)) != 0)
+        goto end;
       thd->net.reading_or_writing= 1;
       goto end;
     }
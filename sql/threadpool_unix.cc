@@ -58,26 +58,32 @@ static bool threadpool_started= false;
 #ifdef HAVE_PSI_INTERFACE
 static PSI_mutex_key key_group_mutex;
 static PSI_mutex_key key_timer_mutex;
+static PSI_mutex_key key_login_mutex;
 static PSI_mutex_info mutex_list[]=
 {
   { &key_group_mutex, "group_mutex", 0},
-  { &key_timer_mutex, "timer_mutex", PSI_FLAG_GLOBAL}
+  { &key_timer_mutex, "timer_mutex", PSI_FLAG_GLOBAL},
+  { &key_login_mutex, "login_mutex", PSI_FLAG_GLOBAL}
 };
 
 static PSI_cond_key key_worker_cond;
 static PSI_cond_key key_timer_cond;
+static PSI_cond_key key_login_cond;
 static PSI_cond_info cond_list[]=
 {
   { &key_worker_cond, "worker_cond", 0},
-  { &key_timer_cond, "timer_cond", PSI_FLAG_GLOBAL}
+  { &key_timer_cond, "timer_cond", PSI_FLAG_GLOBAL},
+  { &key_login_cond, "login_cond", PSI_FLAG_GLOBAL}
 };
 
 static PSI_thread_key key_worker_thread;
 static PSI_thread_key key_timer_thread;
+static PSI_thread_key key_login_thread;
 static PSI_thread_info	thread_list[] =
 {
  {&key_worker_thread, "worker_thread", 0},
- {&key_timer_thread, "timer_thread", PSI_FLAG_GLOBAL}
+ {&key_timer_thread, "timer_thread", PSI_FLAG_GLOBAL},
+ {&key_login_thread, "login_thread", PSI_FLAG_GLOBAL}
 };
 
 /* Macro to simplify performance schema registration */ 
@@ -97,6 +103,8 @@ struct worker_thread_t
   thread_group_t* thread_group;   
   worker_thread_t *next_in_list;
   worker_thread_t **prev_in_list;
+  /* Group this worker is lent to while it handles a stolen event, or NULL */
+  thread_group_t *lent_to;
   
   mysql_cond_t  cond;
   bool          woken;
@@ -116,6 +124,10 @@ struct connection_t
   connection_t *next_in_queue;
   connection_t **prev_in_queue;
   ulonglong abs_wait_timeout;
+  /* Time the connection was put into the workqueue, for statistics */
+  ulonglong enqueue_time;
+  /* Remaining high priority dequeues for the current transaction */
+  uint tickets;
   bool logged_in;
   bool bound_to_poll_descriptor;
   bool waiting;
@@ -125,14 +137,37 @@ typedef I_P_List<connection_t,
                      I_P_List_adapter<connection_t,
                                       &connection_t::next_in_queue,
                                       &connection_t::prev_in_queue>,
-                     I_P_List_null_counter,
+                     I_P_List_counter,
                      I_P_List_fast_push_back<connection_t> >
 connection_queue_t;
 
+/*
+  Per-group event counters, only modified with the group mutex held.
+  Exposed by tp_get_group_stats().
+*/
+struct thread_group_counters_t
+{
+  ulonglong thread_creations;
+  ulonglong thread_creations_due_to_stall;
+  ulonglong wakes;
+  ulonglong wakes_due_to_stall;
+  ulonglong stalls;
+  ulonglong listener_wakeups;
+  ulonglong polls_by_worker;
+  ulonglong dequeues_by_listener;
+  ulonglong dequeues_by_worker;
+  ulonglong events_stolen;
+  ulonglong high_prio_dequeues;
+  /* Queue wait time histogram, [0] for normal, [1] for high priority queue */
+  ulonglong queue_wait[2][TP_QUEUE_WAIT_BUCKETS];
+};
+
 struct thread_group_t 
 {
   mysql_mutex_t mutex;
   connection_queue_t queue;
+  /* Connections inside a transaction, served before the normal queue */
+  connection_queue_t high_prio_queue;
   worker_list_t waiting_threads; 
   worker_thread_t *listener;
   pthread_attr_t *pthread_attr;
@@ -147,7 +182,7 @@ struct thread_group_t
   int  shutdown_pipe[2];
   bool shutdown;
   bool stalled;
-  
+  thread_group_counters_t counters;
 } MY_ALIGNED(512);
 
 static thread_group_t *all_groups;
@@ -173,11 +208,46 @@ struct pool_timer_t
 
 static pool_timer_t pool_timer;
 
+/*
+  Login threads, used if thread_pool_login_threads is not 0.
+
+  New connections are queued here instead of in their thread group. A
+  login thread does the handshake and authentication, including the SSL
+  handshake, and hands the connection to its group only once it is
+  logged in. A storm of logins then keeps about
+  thread_pool_login_threads threads busy, and does not take the workers
+  of the groups away from the queries of existing connections.
+
+  A client that stalls in the handshake keeps its login thread until
+  connect_timeout. If no login was started during a stall_limit while
+  connections are queued, the timer adds a login thread, see
+  check_login_stall(), up to thread_pool_max_threads. The added threads
+  exit once the queue is empty.
+*/
+struct login_pool_t
+{
+  mysql_mutex_t mutex;
+  mysql_cond_t cond;
+  connection_queue_t queue;
+  uint thread_count;
+  /* Threads waiting for a connection to log in */
+  uint waiting_count;
+  /* Number of logins started, and its value at the last timer tick */
+  ulonglong dequeues, last_dequeues;
+  bool shutdown;
+};
+
+static login_pool_t login_pool;
+
+static void check_login_stall();
+
 static void queue_put(thread_group_t *thread_group, connection_t *connection);
-static int  wake_thread(thread_group_t *thread_group);
+static int  wake_thread(thread_group_t *thread_group, bool due_to_stall=false);
 static void handle_event(connection_t *connection);
-static int  wake_or_create_thread(thread_group_t *thread_group);
-static int  create_worker(thread_group_t *thread_group);
+static int  wake_or_create_thread(thread_group_t *thread_group,
+                                  bool due_to_stall=false);
+static int  create_worker(thread_group_t *thread_group,
+                          bool due_to_stall=false);
 static void *worker_main(void *param);
 static void check_stall(thread_group_t *thread_group);
 static void connection_abort(connection_t *connection);
@@ -411,16 +481,85 @@ static void* native_event_get_userdata(native_event *event)
 #endif
 
 
-/* Dequeue element from a workqueue */
+/*
+  Check whether connection should be put into the high priority queue.
+
+  Connections that are inside a multi-statement transaction hold locks that
+  other connections may be waiting for, so we let them finish before new
+  transactions are admitted. To prevent a single long transaction from
+  starving everyone else, it may jump the queue at most
+  thread_pool_high_prio_tickets times, see handle_event().
+*/
+
+static bool connection_is_high_prio(connection_t *c)
+{
+  return c->tickets > 0 && c->thd->in_active_multi_stmt_transaction();
+}
+
+
+/* Check whether both workqueues of the group are empty */
+
+static bool queue_is_empty(thread_group_t *thread_group)
+{
+  return thread_group->high_prio_queue.is_empty() &&
+    thread_group->queue.is_empty();
+}
+
+
+/* Enqueue element into the appropriate workqueue */
+
+static void queue_push(thread_group_t *thread_group, connection_t *c)
+{
+  c->enqueue_time= microsecond_interval_timer();
+  if (connection_is_high_prio(c))
+  {
+    c->tickets--;
+    thread_group->high_prio_queue.push_back(c);
+  }
+  else
+  {
+    thread_group->queue.push_back(c);
+  }
+}
+
+
+/*
+  Account the time connection spent in a workqueue.
+  Bucket i of the histogram counts waits shorter than 10^(i+1) microseconds,
+  the last bucket counts all longer waits.
+*/
+
+static void queue_wait_account(thread_group_t *thread_group,
+                               connection_t *c, int prio)
+{
+  ulonglong wait= microsecond_interval_timer() - c->enqueue_time;
+  ulonglong limit= 10;
+  uint i;
+  for (i= 0; i < TP_QUEUE_WAIT_BUCKETS - 1 && wait >= limit; i++)
+    limit*= 10;
+  thread_group->counters.queue_wait[prio][i]++;
+}
+
+
+/* Dequeue element from a workqueue, high priority elements first */
 
 static connection_t *queue_get(thread_group_t *thread_group)
 {
   DBUG_ENTER("queue_get");
   thread_group->queue_event_count++;
-  connection_t *c= thread_group->queue.front();
+  connection_t *c= thread_group->high_prio_queue.front();
+  if (c)
+  {
+    thread_group->high_prio_queue.remove(c);
+    thread_group->counters.high_prio_dequeues++;
+    queue_wait_account(thread_group, c, 1);
+    DBUG_RETURN(c);
+  }
+  c= thread_group->queue.front();
   if (c)
   {
     thread_group->queue.remove(c);
+    queue_wait_account(thread_group, c, 0);
   }
   DBUG_RETURN(c);  
 }
@@ -526,6 +665,9 @@ static void* timer_thread(void *param)
         if(all_groups[i].connection_count)
            check_stall(&all_groups[i]);
       }
+
+      if (threadpool_login_threads)
+        check_login_stall();
       
       /* Check if any client exceeded wait_timeout */
       if (timer->next_timeout_check <= timer->current_microtime)
@@ -557,7 +699,7 @@ void check_stall(thread_group_t *thread_group)
   */
   if (!thread_group->listener && !thread_group->io_event_count)
   {
-    wake_or_create_thread(thread_group);
+    wake_or_create_thread(thread_group, true);
     mysql_mutex_unlock(&thread_group->mutex);
     return;
   }
@@ -591,10 +733,11 @@ void check_stall(thread_group_t *thread_group)
     do wait and indicate that via thd_wait_begin/end callbacks, thread creation
     will be faster.
   */
-  if (!thread_group->queue.is_empty() && !thread_group->queue_event_count)
+  if (!queue_is_empty(thread_group) && !thread_group->queue_event_count)
   {
     thread_group->stalled= true;
-    wake_or_create_thread(thread_group);
+    thread_group->counters.stalls++;
+    wake_or_create_thread(thread_group, true);
   }
   
   /* Reset queue event count */
@@ -664,6 +807,7 @@ static connection_t * listener(worker_thread_t *current_thread,
     }
     
     thread_group->io_event_count += cnt;  
+    thread_group->counters.listener_wakeups++;
     
     /* 
      We got some network events and need to make decisions : whether
@@ -709,7 +853,7 @@ static connection_t * listener(worker_thread_t *current_thread,
      more workers.
     */
     
-    bool listener_picks_event= thread_group->queue.is_empty();
+    bool listener_picks_event= queue_is_empty(thread_group);
     
     /* 
       If listener_picks_event is set, listener thread will handle first event, 
@@ -719,13 +863,14 @@ static connection_t * listener(worker_thread_t *current_thread,
     for(int i=(listener_picks_event)?1:0; i < cnt ; i++)
     {
       connection_t *c= (connection_t *)native_event_get_userdata(&ev[i]);
-      thread_group->queue.push_back(c);
+      queue_push(thread_group, c);
     }
     
     if (listener_picks_event)
     {
       /* Handle the first event. */
       retval= (connection_t *)native_event_get_userdata(&ev[0]);
+      thread_group->counters.dequeues_by_listener++;
       mysql_mutex_unlock(&thread_group->mutex);
       break;
     }
@@ -788,7 +933,7 @@ static void add_thread_count(thread_group_t *thread_group, int32 count)
   per group to prevent deadlocks (one listener + one worker)
 */
 
-static int create_worker(thread_group_t *thread_group)
+static int create_worker(thread_group_t *thread_group, bool due_to_stall)
 {
   pthread_t thread_id;
   bool max_threads_reached= false;
@@ -809,6 +954,9 @@ static int create_worker(thread_group_t *thread_group)
   if (!err)
   {
     thread_group->last_thread_creation_time=microsecond_interval_timer();
+    thread_group->counters.thread_creations++;
+    if (due_to_stall)
+      thread_group->counters.thread_creations_due_to_stall++;
     thread_created++;
     add_thread_count(thread_group, 1);
   }
@@ -862,14 +1010,15 @@ static ulonglong microsecond_throttling_interval(thread_group_t *thread_group)
   Worker creation is throttled, so we avoid too many threads
   to be created during the short time.
 */
-static int wake_or_create_thread(thread_group_t *thread_group)
+static int wake_or_create_thread(thread_group_t *thread_group,
+                                 bool due_to_stall)
 {
   DBUG_ENTER("wake_or_create_thread");
   
   if (thread_group->shutdown)
    DBUG_RETURN(0);
 
-  if (wake_thread(thread_group) == 0)
+  if (wake_thread(thread_group, due_to_stall) == 0)
     DBUG_RETURN(0);
 
   if (thread_group->thread_count > thread_group->connection_count)
@@ -884,7 +1033,7 @@ static int wake_or_create_thread(thread_group_t *thread_group)
      idle  thread to wakeup. Smells like a potential deadlock or very slowly 
      executing requests, e.g sleeps or user locks.
     */
-    DBUG_RETURN(create_worker(thread_group));
+    DBUG_RETURN(create_worker(thread_group, due_to_stall));
   }
 
   ulonglong now = microsecond_interval_timer();
@@ -895,7 +1044,7 @@ static int wake_or_create_thread(thread_group_t *thread_group)
   if (time_since_last_thread_created >
        microsecond_throttling_interval(thread_group))
   {
-    DBUG_RETURN(create_worker(thread_group));
+    DBUG_RETURN(create_worker(thread_group, due_to_stall));
   }
   
   DBUG_RETURN(-1);
@@ -912,6 +1061,7 @@ int thread_group_init(thread_group_t *thread_group, pthread_attr_t* thread_attr)
   thread_group->shutdown_pipe[0]= -1;
   thread_group->shutdown_pipe[1]= -1;
   thread_group->queue.empty();
+  thread_group->high_prio_queue.empty();
   DBUG_RETURN(0);
 }
 
@@ -940,12 +1090,15 @@ void thread_group_destroy(thread_group_t *thread_group)
   Wake sleeping thread from waiting list
 */
 
-static int wake_thread(thread_group_t *thread_group)
+static int wake_thread(thread_group_t *thread_group, bool due_to_stall)
 {
   DBUG_ENTER("wake_thread");
   worker_thread_t *thread = thread_group->waiting_threads.front();
   if(thread)
   {
+    thread_group->counters.wakes++;
+    if (due_to_stall)
+      thread_group->counters.wakes_due_to_stall++;
     thread->woken= true;
     thread_group->waiting_threads.remove(thread);
     mysql_cond_signal(&thread->cond);
@@ -970,6 +1123,8 @@ static void thread_group_close(thread_group_t *thread_group)
   mysql_mutex_lock(&thread_group->mutex);
   if (thread_group->thread_count == 0) 
   {
+    /* Keep workers of other groups from stealing here, see steal_event() */
+    thread_group->shutdown= true;
     mysql_mutex_unlock(&thread_group->mutex);
     thread_group_destroy(thread_group);
     DBUG_VOID_RETURN;
@@ -1017,7 +1172,7 @@ static void queue_put(thread_group_t *thread_group, connection_t *connection)
   DBUG_ENTER("queue_put");
 
   mysql_mutex_lock(&thread_group->mutex);
-  thread_group->queue.push_back(connection);
+  queue_push(thread_group, connection);
 
   if (thread_group->active_thread_count == 0)
     wake_or_create_thread(thread_group);
@@ -1040,6 +1195,110 @@ static bool too_many_threads(thread_group_t *thread_group)
 }
 
 
+/**
+  Try to steal an event from another, overloaded thread group.
+
+  Connections are bound to groups by thread_id, so a burst of requests on
+  one group's connections can leave its queue growing while workers in
+  other groups are idle. Before an idle worker goes to sleep, it looks
+  for a group with queued events that none of that group's own workers
+  can pick up right now (no idle threads to wake, or too many active
+  ones), and handles one of those events itself.
+
+  While handling the stolen event, the worker is lent to the victim group:
+  it is counted as an active thread there, so that wait_begin()/wait_end()
+  on the connection's group stay balanced, and it is not counted as active
+  in its own group. It stays in its own group's thread_count, so that
+  neither group can be destroyed while the worker is away; see
+  return_from_lend().
+
+  The connection itself does not migrate, it remains bound to its group's
+  poll descriptor.
+
+  Victim groups are only probed with trylock, own group mutex is held.
+  A worker only steals if its own group still has a listener, so that its
+  own network events are not delayed.
+
+  @param current_thread - current worker thread
+  @param thread_group - current thread group, mutex is locked
+
+  @return connection with pending event from a different group, or NULL.
+*/
+
+static connection_t *steal_event(worker_thread_t *current_thread,
+                                 thread_group_t *thread_group)
+{
+  DBUG_ENTER("steal_event");
+  uint n_groups= group_count;
+  uint own= (uint)(thread_group - all_groups);
+
+  if (n_groups < 2 || own >= n_groups || !thread_group->listener)
+    DBUG_RETURN(NULL);
+
+  for (uint i= 1; i < n_groups; i++)
+  {
+    thread_group_t *victim= &all_groups[(own + i) % n_groups];
+
+    /* Cheap check without the lock first, it is fine to be wrong here. */
+    if (queue_is_empty(victim) || victim->shutdown)
+      continue;
+
+    if (mysql_mutex_trylock(&victim->mutex) != 0)
+      continue;
+
+    connection_t *connection= NULL;
+    if (!victim->shutdown && !queue_is_empty(victim) &&
+        (victim->waiting_threads.is_empty() || too_many_threads(victim)))
+    {
+      connection= queue_get(victim);
+      victim->counters.events_stolen++;
+      victim->stalled= false;
+      victim->thread_count++;
+      victim->active_thread_count++;
+    }
+    mysql_mutex_unlock(&victim->mutex);
+
+    if (connection)
+    {
+      thread_group->active_thread_count--;
+      current_thread->lent_to= victim;
+      DBUG_RETURN(connection);
+    }
+  }
+  DBUG_RETURN(NULL);
+}
+
+
+/**
+  Return a worker, that handled a stolen event, back to its own group.
+  Reverses the counter changes done in steal_event().
+*/
+
+static void return_from_lend(worker_thread_t *current_thread)
+{
+  DBUG_ENTER("return_from_lend");
+  thread_group_t *victim= current_thread->lent_to;
+  thread_group_t *thread_group= current_thread->thread_group;
+  bool last_thread;
+
+  current_thread->lent_to= NULL;
+
+  mysql_mutex_lock(&victim->mutex);
+  victim->thread_count--;
+  victim->active_thread_count--;
+  last_thread= ((victim->thread_count == 0) && victim->shutdown);
+  mysql_mutex_unlock(&victim->mutex);
+
+  if (last_thread)
+    thread_group_destroy(victim);
+
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->active_thread_count++;
+  mysql_mutex_unlock(&thread_group->mutex);
+  DBUG_VOID_RETURN;
+}
+
+
 /**
   Retrieve a connection with pending event.
   
@@ -1079,7 +1338,10 @@ connection_t *get_event(worker_thread_t *current_thread,
     {
       connection = queue_get(thread_group);
       if(connection)
+      {
+        thread_group->counters.dequeues_by_worker++;
         break;
+      }
     }
 
     /* If there is  currently no listener in the group, become one. */
@@ -1108,9 +1370,15 @@ connection_t *get_event(worker_thread_t *current_thread,
       if (io_poll_wait(thread_group->pollfd,&nev,1, 0) == 1)
       {
         thread_group->io_event_count++;
+        thread_group->counters.polls_by_worker++;
         connection = (connection_t *)native_event_get_userdata(&nev);
         break;
       }
+
+      /* Nothing to do in this group, try to help an overloaded one. */
+      connection= steal_event(current_thread, thread_group);
+      if (connection)
+        break;
     }
 
     /* And now, finally sleep */ 
@@ -1172,7 +1440,7 @@ void wait_begin(thread_group_t *thread_group)
   DBUG_ASSERT(thread_group->connection_count > 0);
  
   if ((thread_group->active_thread_count == 0) && 
-     (thread_group->queue.is_empty() || !thread_group->listener))
+     (queue_is_empty(thread_group) || !thread_group->listener))
   {
     /* 
       Group might stall while this thread waits, thus wake 
@@ -1215,6 +1483,7 @@ connection_t *alloc_connection(THD *thd)
     connection->logged_in= false;
     connection->bound_to_poll_descriptor= false;
     connection->abs_wait_timeout= ULONGLONG_MAX;
+    connection->tickets= threadpool_high_prio_tickets;
   }
   DBUG_RETURN(connection);
 }
@@ -1234,8 +1503,6 @@ void tp_add_connection(THD *thd)
   connection_t *connection= alloc_connection(thd);
   if (connection)
   {
-    thd->event_scheduler.data= connection;
-      
     /* Assign connection to a group. */
     thread_group_t *group= 
       &all_groups[thd->thread_id%group_count];
@@ -1246,11 +1513,26 @@ void tp_add_connection(THD *thd)
     group->connection_count++;
     mysql_mutex_unlock(&group->mutex);
     
-    /*
-       Add connection to the work queue.Actual logon 
-       will be done by a worker thread.
-    */
-    queue_put(group, connection);
+    if (login_pool.thread_count)
+    {
+      /*
+        Actual logon will be done by a login thread, which sets
+        event_scheduler.data when it is done.
+      */
+      mysql_mutex_lock(&login_pool.mutex);
+      login_pool.queue.push_back(connection);
+      mysql_cond_signal(&login_pool.cond);
+      mysql_mutex_unlock(&login_pool.mutex);
+    }
+    else
+    {
+      thd->event_scheduler.data= connection;
+      /*
+         Add connection to the work queue.Actual logon 
+         will be done by a worker thread.
+      */
+      queue_put(group, connection);
+    }
   }
   else
   {
@@ -1451,6 +1733,10 @@ static void handle_event(connection_t *connection)
   if(err)
     goto end;
 
+  /* Transaction has ended, give the connection a fresh set of tickets. */
+  if (!connection->thd->in_active_multi_stmt_transaction())
+    connection->tickets= threadpool_high_prio_tickets;
+
   set_wait_timeout(connection);
   err= start_io(connection);
 
@@ -1481,6 +1767,7 @@ static void *worker_main(void *param)
   /* Init per-thread structure */
   mysql_cond_init(key_worker_cond, &this_thread.cond, NULL);
   this_thread.thread_group= thread_group;
+  this_thread.lent_to= NULL;
   this_thread.event_count=0;
 
   /* Run event loop */
@@ -1494,6 +1781,8 @@ static void *worker_main(void *param)
       break;
     this_thread.event_count++;
     handle_event(connection);
+    if (this_thread.lent_to)
+      return_from_lend(&this_thread);
   }
 
   /* Thread shutdown: cleanup per-worker-thread structure. */
@@ -1514,6 +1803,151 @@ static void *worker_main(void *param)
 }
 
 
+/**
+  Log in a new connection in a login thread, then hand it to its group.
+*/
+
+static void handle_login(connection_t *connection)
+{
+  DBUG_ENTER("handle_login");
+  THD *thd= connection->thd;
+  int err;
+
+  /*
+    event_scheduler.data is not set yet, so that the waits during the
+    login are not accounted to the active threads of the group.
+  */
+  err= threadpool_add_connection(thd);
+  thd->event_scheduler.data= connection;
+  connection->logged_in= true;
+
+  if (!err)
+  {
+    set_wait_timeout(connection);
+    err= start_io(connection);
+  }
+  if (err)
+    connection_abort(connection);
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Login thread's main
+*/
+
+static void *login_main(void *param)
+{
+  pthread_detach_this_thread();
+  my_thread_init();
+
+  DBUG_ENTER("login_main");
+
+  mysql_mutex_lock(&login_pool.mutex);
+  for (;;)
+  {
+    connection_t *connection= login_pool.queue.front();
+    if (connection)
+    {
+      login_pool.queue.remove(connection);
+      login_pool.dequeues++;
+      mysql_mutex_unlock(&login_pool.mutex);
+      handle_login(connection);
+      mysql_mutex_lock(&login_pool.mutex);
+      continue;
+    }
+    /* Pending connections are still logged in (and fail) on shutdown */
+    if (login_pool.shutdown)
+      break;
+    /* A thread added by check_login_stall() is not needed any more */
+    if (login_pool.thread_count > threadpool_login_threads)
+      break;
+    login_pool.waiting_count++;
+    mysql_cond_wait(&login_pool.cond, &login_pool.mutex);
+    login_pool.waiting_count--;
+  }
+  login_pool.thread_count--;
+  mysql_cond_broadcast(&login_pool.cond);
+  mysql_mutex_unlock(&login_pool.mutex);
+
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Create a login thread, login_pool.mutex must be held.
+*/
+
+static int create_login_thread()
+{
+  pthread_t thread_id;
+  int err;
+  if (!(err= mysql_thread_create(key_login_thread, &thread_id,
+                                 get_connection_attrib(), login_main, NULL)))
+    login_pool.thread_count++;
+  return err;
+}
+
+
+/**
+  Add a login thread if the login threads are all stuck, for example
+  with clients that stall in the handshake. Called by the timer.
+*/
+
+static void check_login_stall()
+{
+  mysql_mutex_lock(&login_pool.mutex);
+  if (!login_pool.shutdown && !login_pool.waiting_count &&
+      !login_pool.queue.is_empty() &&
+      login_pool.dequeues == login_pool.last_dequeues &&
+      login_pool.thread_count < threadpool_max_threads)
+    (void) create_login_thread();
+  login_pool.last_dequeues= login_pool.dequeues;
+  mysql_mutex_unlock(&login_pool.mutex);
+}
+
+
+static void start_login_threads()
+{
+  DBUG_ENTER("start_login_threads");
+  mysql_mutex_init(key_login_mutex, &login_pool.mutex, NULL);
+  mysql_cond_init(key_login_cond, &login_pool.cond, NULL);
+  login_pool.shutdown= false;
+  login_pool.thread_count= 0;
+  login_pool.waiting_count= 0;
+  login_pool.dequeues= login_pool.last_dequeues= 0;
+
+  mysql_mutex_lock(&login_pool.mutex);
+  for (uint i= 0; i < threadpool_login_threads; i++)
+  {
+    if (create_login_thread())
+    {
+      sql_print_warning("Could only create %u of %u threadpool login threads",
+                        i, threadpool_login_threads);
+      break;
+    }
+  }
+  mysql_mutex_unlock(&login_pool.mutex);
+  DBUG_VOID_RETURN;
+}
+
+
+static void stop_login_threads()
+{
+  DBUG_ENTER("stop_login_threads");
+  mysql_mutex_lock(&login_pool.mutex);
+  login_pool.shutdown= true;
+  mysql_cond_broadcast(&login_pool.cond);
+  while (login_pool.thread_count)
+    mysql_cond_wait(&login_pool.cond, &login_pool.mutex);
+  mysql_mutex_unlock(&login_pool.mutex);
+  mysql_cond_destroy(&login_pool.cond);
+  mysql_mutex_destroy(&login_pool.mutex);
+  DBUG_VOID_RETURN;
+}
+
+
 bool tp_init()
 {
   DBUG_ENTER("tp_init");
@@ -1544,6 +1978,8 @@ bool tp_init()
   PSI_register(thread);
   
   pool_timer.tick_interval= threadpool_stall_limit;
+  /* The timer checks the login threads */
+  start_login_threads();
   start_timer(&pool_timer);
   DBUG_RETURN(0);
 }
@@ -1557,6 +1993,7 @@ void tp_end()
     DBUG_VOID_RETURN;
 
   stop_timer(&pool_timer);
+  stop_login_threads();
   shutdown_group_count= threadpool_max_size;
   for (uint i= 0; i < threadpool_max_size; i++)
   {
@@ -1628,6 +2065,64 @@ int tp_get_idle_thread_count()
 }
 
 
+/**
+  Number of thread groups currently in use, 0 if the pool is not running.
+*/
+
+uint tp_get_group_count()
+{
+  return threadpool_started ? group_count : 0;
+}
+
+
+/**
+  Take a snapshot of the state and the statistics of a thread group.
+
+  @param group_id - group number, less than tp_get_group_count()
+  @param stats - output
+
+  @return
+  0 on success, 1 if there is no such group
+*/
+
+int tp_get_group_stats(uint group_id, TP_GROUP_STATS *stats)
+{
+  if (!threadpool_started || group_id >= group_count)
+    return 1;
+
+  thread_group_t *thread_group= &all_groups[group_id];
+  thread_group_counters_t *counters= &thread_group->counters;
+
+  mysql_mutex_lock(&thread_group->mutex);
+  stats->connections= thread_group->connection_count;
+  stats->threads= thread_group->thread_count;
+  stats->active_threads= thread_group->active_thread_count;
+  stats->standby_threads= 0;
+  worker_list_t::Iterator it(thread_group->waiting_threads);
+  while (it++)
+    stats->standby_threads++;
+  stats->queue_length= thread_group->queue.elements();
+  stats->high_prio_queue_length= thread_group->high_prio_queue.elements();
+  stats->has_listener= (thread_group->listener != NULL);
+  stats->is_stalled= thread_group->stalled;
+
+  stats->thread_creations= counters->thread_creations;
+  stats->thread_creations_due_to_stall= counters->thread_creations_due_to_stall;
+  stats->wakes= counters->wakes;
+  stats->wakes_due_to_stall= counters->wakes_due_to_stall;
+  stats->stalls= counters->stalls;
+  stats->listener_wakeups= counters->listener_wakeups;
+  stats->polls_by_worker= counters->polls_by_worker;
+  stats->dequeues_by_listener= counters->dequeues_by_listener;
+  stats->dequeues_by_worker= counters->dequeues_by_worker;
+  stats->events_stolen= counters->events_stolen;
+  stats->high_prio_dequeues= counters->high_prio_dequeues;
+  memcpy(stats->queue_wait, counters->queue_wait, sizeof(stats->queue_wait));
+  mysql_mutex_unlock(&thread_group->mutex);
+  return 0;
+}
+
+
 /* Report threadpool problems */
 
 /** 
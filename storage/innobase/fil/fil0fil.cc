@@ -1001,9 +1001,10 @@ fil_try_to_close_file_in_LRU(
 /*******************************************************************//**
 Reserves the fil_system mutex and tries to make sure we can open at least one
 file while holding it. This should be called before calling
-fil_node_prepare_for_io(), because that function may need to open a file. */
+fil_node_prepare_for_io(), because that function may need to open a file.
+@return the space looked up under the mutex, or NULL if it does not exist */
 static
-void
+fil_space_t*
 fil_mutex_enter_and_prepare_for_io(
 /*===============================*/
 	ulint	space_id)	/*!< in: space id */
@@ -1017,6 +1018,8 @@ fil_mutex_enter_and_prepare_for_io(
 retry:
 	mutex_enter(&fil_system->mutex);
 
+	space = fil_space_get_by_id(space_id);
+
 	if (space_id == 0 || space_id >= SRV_LOG_SPACE_FIRST_ID) {
 		/* We keep log files and system tablespace files always open;
 		this is important in preventing deadlocks in this module, as
@@ -1024,11 +1027,9 @@ retry:
 		insert buffer. The insert buffer is in tablespace 0, and we
 		cannot end up waiting in this function. */
 
-		return;
+		return(space);
 	}
 
-	space = fil_space_get_by_id(space_id);
-
 	if (space != NULL && space->stop_ios) {
 		/* We are going to do a rename file and want to stop new i/o's
 		for a while */
@@ -1071,7 +1072,7 @@ retry:
 
 	if (fil_system->n_open < fil_system->max_n_open) {
 
-		return;
+		return(space);
 	}
 
 	/* If the file is already open, no need to do anything; if the space
@@ -1080,7 +1081,7 @@ retry:
 
 	if (!space || UT_LIST_GET_FIRST(space->chain)->open) {
 
-		return;
+		return(space);
 	}
 
 	if (count > 1) {
@@ -1099,7 +1100,7 @@ close_more:
 	if (fil_system->n_open < fil_system->max_n_open) {
 		/* Ok */
 
-		return;
+		return(space);
 	}
 
 	if (count >= 2) {
@@ -1114,7 +1115,7 @@ close_more:
 			(ulong) fil_system->n_open,
 			(ulong) fil_system->max_n_open);
 
-		return;
+		return(space);
 	}
 
 	mutex_exit(&fil_system->mutex);
@@ -1497,11 +1498,10 @@ fil_space_get_space(
 		before the fil_mutex_enter_and_prepare_for_io() acquires
 		the fil_system->mutex. Check for this after completing the
 		call to fil_mutex_enter_and_prepare_for_io(). */
-		fil_mutex_enter_and_prepare_for_io(id);
+		space = fil_mutex_enter_and_prepare_for_io(id);
 
 		/* We are still holding the fil_system->mutex. Check if
 		the space is still in memory cache. */
-		space = fil_space_get_by_id(id);
 		if (space == NULL) {
 			return(NULL);
 		}
@@ -4871,9 +4871,7 @@ retry:
 	pages_added = 0;
 	success = TRUE;
 
-	fil_mutex_enter_and_prepare_for_io(space_id);
-
-	space = fil_space_get_by_id(space_id);
+	space = fil_mutex_enter_and_prepare_for_io(space_id);
 	ut_a(space);
 
 	if (space->size >= size_after_extend) {
@@ -5423,9 +5421,7 @@ fil_io(
 	/* Reserve the fil_system mutex and make sure that we can open at
 	least one file while holding it, if the file is not already open */
 
-	fil_mutex_enter_and_prepare_for_io(space_id);
-
-	space = fil_space_get_by_id(space_id);
+	space = fil_mutex_enter_and_prepare_for_io(space_id);
 
 	/* If we are deleting a tablespace we don't allow any read
 	operations on that. However, we do allow write operations. */
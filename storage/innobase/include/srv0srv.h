@@ -342,6 +342,7 @@ extern ibool	srv_innodb_status;
 extern unsigned long long	srv_stats_transient_sample_pages;
 extern my_bool			srv_stats_persistent;
 extern unsigned long long	srv_stats_persistent_sample_pages;
+extern my_bool			srv_stats_leaf_sampling;
 extern my_bool			srv_stats_auto_recalc;
 
 extern ibool	srv_use_doublewrite_buf;
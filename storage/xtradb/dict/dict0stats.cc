@@ -111,6 +111,26 @@ See REF01 for the implementation.
 The above describes how to calculate the cardinality of an index.
 This algorithm is executed for each n-prefix of a multi-column index
 where n=1..n_uniq.
+
+Leaf run sampling (innodb_stats_leaf_sampling=ON) @{
+
+The above needs full scans of some non-leaf levels and separate leaf page
+dives for each n-prefix, all while holding the index tree S-latch. Instead,
+the same budget of A*n_uniq leaf pages can be read as runs of
+DICT_STATS_LEAF_RUN_PAGES consecutive leaf pages, each run starting on a
+random leaf page. The runs are read sequentially, which lets the linear
+read-ahead fetch them in batches, and the tree latch is released between runs.
+
+Leaf records are in key order, so the number of distinct n-prefixes in the
+whole index is one more than the number of adjacent record pairs that differ
+in the first n columns. One record comparison tells the number of matching
+leading columns m, which makes the pair a boundary for all n-prefixes with
+n > m: all the n-prefixes are analyzed in one pass. Let the number of sampled
+adjacent pairs be P, the number of those that are boundaries for the n-prefix
+be B(n), the number of sampled records be R and the number of sampled pages be
+S. With N leaf pages the number of records is estimated as N * R / S and the
+number of distinct n-prefixes as 1 + (N * R / S - 1) * B(n) / P.
+See REF02 for the implementation.
 @} */
 
 /* names of the tables from the persistent statistics storage */
@@ -131,6 +151,9 @@ where n=1..n_uniq.
 	 (index)->table->stats_sample_pages :		\
 	 srv_stats_persistent_sample_pages)
 
+/* number of consecutive leaf pages read in one run by leaf run sampling */
+#define DICT_STATS_LEAF_RUN_PAGES	8
+
 /* number of distinct records on a given level that are required to stop
 descending to lower levels and fetch N_SAMPLE_PAGES(index) records
 from that level */
@@ -1729,6 +1752,169 @@ dict_stats_analyze_index_for_n_prefix(
 	btr_pcur_close(&pcur);
 }
 
+/*********************************************************************//**
+Estimates the number of distinct n-prefixes of an index for n=1..n_uniq by
+reading runs of consecutive leaf pages that start at random leaf pages, see
+"Leaf run sampling" above. Saves the results to the index members
+stat_n_diff_key_vals[] and stat_n_sample_sizes[]. The caller must have set
+index->stat_n_leaf_pages. */
+static
+void
+dict_stats_analyze_index_leaf_runs(
+/*===============================*/
+	dict_index_t*	index)	/*!< in/out: index to analyze */
+{
+	ulint		n_uniq;
+	ulint		n_runs;
+	ulint		space;
+	ulint		zip_size;
+	mem_heap_t*	heap;
+	ulint*		offsets1;
+	ulint*		offsets2;
+	ulint		size;
+	ib_uint64_t*	n_boundaries;
+	ib_uint64_t	n_pairs		= 0;
+	ib_uint64_t	n_recs		= 0;
+	ib_uint64_t	n_pages		= 0;
+	ib_uint64_t	n_rows;
+
+	n_uniq = dict_index_get_n_unique(index);
+
+	n_runs = static_cast<ulint>(
+		(N_SAMPLE_PAGES(index) * n_uniq
+		 + DICT_STATS_LEAF_RUN_PAGES - 1)
+		/ DICT_STATS_LEAF_RUN_PAGES);
+
+	space = dict_index_get_space(index);
+	zip_size = dict_table_zip_size(index->table);
+
+	/* See dict_stats_analyze_index_below_cur() for the size of the
+	offsets arrays */
+	size = (1 + REC_OFFS_HEADER_SIZE) + 1 + dict_index_get_n_fields(index);
+
+	heap = mem_heap_create(size * (sizeof *offsets1 + sizeof *offsets2)
+			       + n_uniq * sizeof *n_boundaries);
+
+	offsets1 = static_cast<ulint*>(mem_heap_alloc(
+			heap, size * sizeof *offsets1));
+
+	offsets2 = static_cast<ulint*>(mem_heap_alloc(
+			heap, size * sizeof *offsets2));
+
+	rec_offs_set_n_alloc(offsets1, size);
+	rec_offs_set_n_alloc(offsets2, size);
+
+	n_boundaries = static_cast<ib_uint64_t*>(mem_heap_zalloc(
+			heap, n_uniq * sizeof *n_boundaries));
+
+	for (ulint run = 0; run < n_runs; run++) {
+		btr_cur_t	cursor;
+		buf_block_t*	block;
+		const rec_t*	prev_rec	= NULL;
+		ulint*		offsets_prev	= offsets1;
+		ulint*		offsets_rec	= offsets2;
+		mtr_t		mtr;
+
+		/* Each run is read in its own mini-transaction, so that the
+		index tree S-latch is not held for the whole analysis. The
+		leaf pages of the run stay S-latched until the run ends, which
+		keeps prev_rec valid across page boundaries. */
+		mtr_start(&mtr);
+
+		btr_cur_open_at_rnd_pos(index, BTR_SEARCH_LEAF, &cursor, &mtr);
+
+		block = btr_cur_get_block(&cursor);
+
+		for (ulint i = 0; block != NULL; i++) {
+			const page_t*	page = buf_block_get_frame(block);
+			const rec_t*	rec;
+			ulint		next_page_no;
+
+			for (rec = page_rec_get_next_non_del_marked(
+				     page_get_infimum_rec(page));
+			     !page_rec_is_supremum(rec);
+			     rec = page_rec_get_next_non_del_marked(rec)) {
+
+				offsets_rec = rec_get_offsets(
+					rec, index, offsets_rec,
+					ULINT_UNDEFINED, &heap);
+
+				n_recs++;
+
+				if (prev_rec != NULL) {
+					ulint	matched_fields = 0;
+					ulint	matched_bytes = 0;
+
+					cmp_rec_rec_with_match(
+						prev_rec, rec,
+						offsets_prev, offsets_rec,
+						index, FALSE, &matched_fields,
+						&matched_bytes);
+
+					/* the pair is a boundary for all
+					n-prefixes longer than the number of
+					matching fields */
+					for (ulint j = matched_fields;
+					     j < n_uniq; j++) {
+						n_boundaries[j]++;
+					}
+
+					n_pairs++;
+				}
+
+				prev_rec = rec;
+
+				ulint*	offsets_tmp = offsets_prev;
+				offsets_prev = offsets_rec;
+				offsets_rec = offsets_tmp;
+			}
+
+			n_pages++;
+
+			next_page_no = btr_page_get_next(page, &mtr);
+
+			if (i + 1 == DICT_STATS_LEAF_RUN_PAGES
+			    || next_page_no == FIL_NULL) {
+				break;
+			}
+
+			block = btr_block_get(space, zip_size, next_page_no,
+					      RW_S_LATCH, index, &mtr);
+		}
+
+		mtr_commit(&mtr);
+	}
+
+	/* REF02: see "Leaf run sampling" above */
+	n_rows = n_pages > 0
+		? index->stat_n_leaf_pages * n_recs / n_pages
+		: 0;
+
+	for (ulint i = 0; i < n_uniq; i++) {
+
+		if (n_rows == 0) {
+			/* only empty pages or delete-marked records were
+			sampled */
+			index->stat_n_diff_key_vals[i] = 0;
+		} else if (n_pairs == 0) {
+			index->stat_n_diff_key_vals[i] = 1;
+		} else {
+			index->stat_n_diff_key_vals[i] = 1
+				+ (n_rows - 1) * n_boundaries[i] / n_pairs;
+		}
+
+		index->stat_n_sample_sizes[i] = n_pages;
+
+		DEBUG_PRINTF("    %s(): n_diff=" UINT64PF " for n_prefix=%lu"
+			     " (" UINT64PF " boundaries in " UINT64PF
+			     " pairs, " UINT64PF " pages)\n",
+			     __func__, index->stat_n_diff_key_vals[i], i + 1,
+			     n_boundaries[i], n_pairs, n_pages);
+	}
+
+	mem_heap_free(heap);
+}
+
 /*********************************************************************//**
 Calculates new statistics for a given index and saves them to the index
 members stat_n_diff_key_vals[], stat_n_sample_sizes[], stat_index_size and
@@ -1833,6 +2019,16 @@ dict_stats_analyze_index(
 		DBUG_VOID_RETURN;
 	}
 
+	if (srv_stats_leaf_sampling) {
+
+		mtr_commit(&mtr);
+
+		dict_stats_analyze_index_leaf_runs(index);
+
+		dict_stats_assert_initialized_index(index);
+		DBUG_VOID_RETURN;
+	}
+
 	/* set to zero */
 	n_diff_on_level = reinterpret_cast<ib_uint64_t*>
 		(mem_zalloc(n_uniq * sizeof(ib_uint64_t)));
@@ -248,6 +248,12 @@ struct fil_space_t {
 				/*!< true if this space is currently in
 				unflushed_spaces */
 	ibool		is_corrupt;
+	ib_uint64_t	n_reads;/*!< number of read requests posted to
+				the files of the space, protected by
+				fil_system->mutex */
+	ib_uint64_t	n_writes;/*!< number of write requests posted to
+				the files of the space, protected by
+				fil_system->mutex */
 	UT_LIST_NODE_T(fil_space_t) space_list;
 				/*!< list of all spaces */
 	ulint		magic_n;/*!< FIL_SPACE_MAGIC_N */
@@ -1004,9 +1010,10 @@ fil_try_to_close_file_in_LRU(
 /*******************************************************************//**
 Reserves the fil_system mutex and tries to make sure we can open at least one
 file while holding it. This should be called before calling
-fil_node_prepare_for_io(), because that function may need to open a file. */
+fil_node_prepare_for_io(), because that function may need to open a file.
+@return the space looked up under the mutex, or NULL if it does not exist */
 static
-void
+fil_space_t*
 fil_mutex_enter_and_prepare_for_io(
 /*===============================*/
 	ulint	space_id)	/*!< in: space id */
@@ -1020,6 +1027,8 @@ fil_mutex_enter_and_prepare_for_io(
 retry:
 	mutex_enter(&fil_system->mutex);
 
+	space = fil_space_get_by_id(space_id);
+
 	if (space_id == 0 || space_id >= SRV_LOG_SPACE_FIRST_ID) {
 		/* We keep log files and system tablespace files always open;
 		this is important in preventing deadlocks in this module, as
@@ -1027,11 +1036,9 @@ retry:
 		insert buffer. The insert buffer is in tablespace 0, and we
 		cannot end up waiting in this function. */
 
-		return;
+		return(space);
 	}
 
-	space = fil_space_get_by_id(space_id);
-
 	if (space != NULL && space->stop_ios) {
 		/* We are going to do a rename file and want to stop new i/o's
 		for a while */
@@ -1074,7 +1081,7 @@ retry:
 
 	if (fil_system->n_open < fil_system->max_n_open) {
 
-		return;
+		return(space);
 	}
 
 	/* If the file is already open, no need to do anything; if the space
@@ -1083,7 +1090,7 @@ retry:
 
 	if (!space || UT_LIST_GET_FIRST(space->chain)->open) {
 
-		return;
+		return(space);
 	}
 
 	if (count > 1) {
@@ -1102,7 +1109,7 @@ close_more:
 	if (fil_system->n_open < fil_system->max_n_open) {
 		/* Ok */
 
-		return;
+		return(space);
 	}
 
 	if (count >= 2) {
@@ -1117,7 +1124,7 @@ close_more:
 			(ulong) fil_system->n_open,
 			(ulong) fil_system->max_n_open);
 
-		return;
+		return(space);
 	}
 
 	mutex_exit(&fil_system->mutex);
@@ -1535,11 +1542,10 @@ fil_space_get_space(
 		before the fil_mutex_enter_and_prepare_for_io() acquires
 		the fil_system->mutex. Check for this after completing the
 		call to fil_mutex_enter_and_prepare_for_io(). */
-		fil_mutex_enter_and_prepare_for_io(id);
+		space = fil_mutex_enter_and_prepare_for_io(id);
 
 		/* We are still holding the fil_system->mutex. Check if
 		the space is still in memory cache. */
-		space = fil_space_get_by_id(id);
 		if (space == NULL) {
 			return(NULL);
 		}
@@ -4882,9 +4888,7 @@ retry:
 	pages_added = 0;
 	success = TRUE;
 
-	fil_mutex_enter_and_prepare_for_io(space_id);
-
-	space = fil_space_get_by_id(space_id);
+	space = fil_mutex_enter_and_prepare_for_io(space_id);
 	ut_a(space);
 
 	if (space->size >= size_after_extend) {
@@ -5433,11 +5437,16 @@ _fil_io(
 	}
 
 	/* Reserve the fil_system mutex and make sure that we can open at
-	least one file while holding it, if the file is not already open */
+	least one file while holding it, if the file is not already open.
 
-	fil_mutex_enter_and_prepare_for_io(space_id);
+	The space lookup and the LRU of open files both stay under
+	fil_system->mutex. A space can be freed by DROP or DISCARD while
+	another thread still uses the pointer it looked up, and the LRU
+	position, n_pending, n_open and the unflushed_spaces list change
+	together. A lookup without the mutex or a sharded LRU would first
+	need reference counting of fil_space_t and fil_node_t. */
 
-	space = fil_space_get_by_id(space_id);
+	space = fil_mutex_enter_and_prepare_for_io(space_id);
 
 	/* If we are deleting a tablespace we don't allow any read
 	operations on that. However, we do allow write operations. */
@@ -5522,6 +5531,12 @@ _fil_io(
 		ut_error;
 	}
 
+	if (type == OS_FILE_READ) {
+		space->n_reads++;
+	} else if (type == OS_FILE_WRITE) {
+		space->n_writes++;
+	}
+
 	/* Now we have made the changes in the data structures of fil_system */
 	mutex_exit(&fil_system->mutex);
 
@@ -6392,6 +6407,63 @@ fil_system_hash_nodes(void)
        }
 }
 
+/**
+Iterate over all the spaces in the space list and fetch their i/o
+statistics. The space names in the list must be freed by the caller using
+delete[].
+@return DB_SUCCESS if all OK. */
+UNIV_INTERN
+dberr_t
+fil_get_space_io_stats(
+/*===================*/
+	space_io_stats_list_t&	space_io_stats_list)
+				/*!< in/out: List to append to */
+{
+	fil_space_t*	space;
+	dberr_t		err = DB_SUCCESS;
+
+	mutex_enter(&fil_system->mutex);
+
+	for (space = UT_LIST_GET_FIRST(fil_system->space_list);
+	     space != NULL;
+	     space = UT_LIST_GET_NEXT(space_list, space)) {
+
+		fil_space_io_stats_t	stats;
+		const fil_node_t*	node;
+		ulint			len;
+
+		len = strlen(space->name);
+		stats.name = new(std::nothrow) char[len + 1];
+
+		if (stats.name == 0) {
+			/* Caller to free elements allocated so far. */
+			err = DB_OUT_OF_MEMORY;
+			break;
+		}
+
+		memcpy(stats.name, space->name, len);
+		stats.name[len] = 0;
+
+		stats.id = space->id;
+		stats.n_reads = space->n_reads;
+		stats.n_writes = space->n_writes;
+		stats.n_pending = 0;
+
+		for (node = UT_LIST_GET_FIRST(space->chain);
+		     node != NULL;
+		     node = UT_LIST_GET_NEXT(chain, node)) {
+
+			stats.n_pending += node->n_pending;
+		}
+
+		space_io_stats_list.push_back(stats);
+	}
+
+	mutex_exit(&fil_system->mutex);
+
+	return(err);
+}
+
 /**
 Iterate over all the spaces in the space list and fetch the
 tablespace names. It will return a copy of the name that must be
@@ -42,6 +42,15 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 /** The FTS optimize thread's work queue. */
 static ib_wqueue_t* fts_optimize_wq;
 
+/** The work queue of the FTS optimize worker threads, or NULL if
+the optimize thread optimizes the tables itself. */
+static ib_wqueue_t* fts_optimize_worker_wq;
+
+/** Number of threads that optimize FTS tables in the background.
+If this is more than 1, the optimize thread only schedules the tables
+and this many worker threads optimize different tables in parallel. */
+UNIV_INTERN ulong	fts_optimize_threads;
+
 /** The number of document ids to delete in one statement. */
 static const ulint FTS_MAX_DELETE_DOC_IDS = 1000;
 
@@ -90,6 +99,9 @@ enum fts_msg_type_t {
 
 	FTS_MSG_DEL_TABLE,		/*!< Remove a table from the optimize
 					threads work queue */
+
+	FTS_MSG_TABLE_DONE,		/*!< A worker thread finished
+					optimizing a table */
 };
 
 /** Compressed list of words that have been read from FTS INDEX
@@ -204,6 +216,14 @@ struct fts_slot_t {
 
 	ib_time_t	interval_time;	/*!< Minimum time to wait before
 					optimizing the table again. */
+
+	bool		busy;		/*!< true while a worker thread is
+					optimizing the table */
+
+	os_event_t	remove_event;	/*!< If not NULL, the table was
+					removed while busy; the slot is
+					emptied and this event is set when
+					the worker thread is done */
 };
 
 /** A table remove message for the FTS optimize thread. */
@@ -220,6 +240,13 @@ struct fts_msg_optimize_t {
 	dict_table_t*	table;		/*!< Table to optimize */
 };
 
+/** A worker thread's report of an optimized table. */
+struct fts_msg_done_t {
+	dict_table_t*	table;		/*!< The table that was optimized */
+
+	dberr_t		error;		/*!< Result of fts_optimize_table() */
+};
+
 /** The FTS optimize message work queue message type. */
 struct fts_msg_t {
 	fts_msg_type_t	type;		/*!< Message type */
@@ -234,6 +261,13 @@ struct fts_msg_t {
 /** The number of words to read and optimize in a single pass. */
 UNIV_INTERN ulong	fts_num_word_optimize;
 
+static
+fts_msg_t*
+fts_optimize_create_msg(
+/*====================*/
+	fts_msg_type_t	type,		/*!< in: type of message */
+	void*		ptr);		/*!< in: message payload */
+
 // FIXME
 UNIV_INTERN char	fts_enable_diag_print;
 
@@ -2404,6 +2438,46 @@ fts_optimize_reset_start_time(
 	return(error);
 }
 
+/*********************************************************************//**
+Check whether the background thread should optimize a table now.
+@return true if the table should be optimized */
+static __attribute__((nonnull, warn_unused_result))
+bool
+fts_optimize_slot_is_due(
+/*=====================*/
+	const fts_slot_t*	slot)	/*!< in: table to check */
+{
+	const fts_t*	fts = slot->table->fts;
+
+	/* Avoid optimizing tables that were optimized recently. */
+	if (slot->last_run > 0
+	    && (ut_time() - slot->last_run) < slot->interval_time) {
+
+		return(false);
+	}
+
+	return(fts && fts->cache
+	       && fts->cache->deleted >= FTS_OPTIMIZE_THRESHOLD);
+}
+
+/*********************************************************************//**
+Note that a background optimize of a table has completed. */
+static __attribute__((nonnull))
+void
+fts_optimize_slot_done(
+/*===================*/
+	fts_slot_t*	slot,	/*!< in/out: table that was optimized */
+	dberr_t		error)	/*!< in: result of fts_optimize_table() */
+{
+	if (error == DB_SUCCESS) {
+		slot->state = FTS_STATE_DONE;
+		slot->completed = ut_time();
+	}
+
+	/* Note time this run completed. */
+	slot->last_run = ut_time();
+}
+
 /*********************************************************************//**
 Run OPTIMIZE on the given table by a background thread.
 @return DB_SUCCESS if all OK */
@@ -2413,34 +2487,48 @@ fts_optimize_table_bk(
 /*==================*/
 	fts_slot_t*	slot)	/*!< in: table to optimiza */
 {
-	dberr_t		error;
-	dict_table_t*	table = slot->table;
-	fts_t*		fts = table->fts;
+	dberr_t		error = DB_SUCCESS;
 
-	/* Avoid optimizing tables that were optimized recently. */
-	if (slot->last_run > 0
-	    && (ut_time() - slot->last_run) < slot->interval_time) {
+	if (fts_optimize_slot_is_due(slot)) {
+		error = fts_optimize_table(slot->table);
+
+		fts_optimize_slot_done(slot, error);
+	} else {
+		/* Note time this run completed. */
+		slot->last_run = ut_time();
+	}
 
-		return(DB_SUCCESS);
+	return(error);
+}
+
+/*********************************************************************//**
+Hand the given table over to an optimize worker thread, if it is due.
+@return true if a worker thread will optimize the table */
+static __attribute__((nonnull))
+bool
+fts_optimize_table_dispatch(
+/*========================*/
+	fts_slot_t*	slot)	/*!< in/out: table to optimize */
+{
+	fts_msg_t*	msg;
 
-	} else if (fts && fts->cache
-		   && fts->cache->deleted >= FTS_OPTIMIZE_THRESHOLD) {
+	ut_ad(fts_optimize_worker_wq);
+	ut_ad(!slot->busy);
 
-		error = fts_optimize_table(table);
+	if (!fts_optimize_slot_is_due(slot)) {
+		/* Note time this run completed. */
+		slot->last_run = ut_time();
 
-		if (error == DB_SUCCESS) {
-			slot->state = FTS_STATE_DONE;
-			slot->last_run = 0;
-			slot->completed = ut_time();
-		}
-	} else {
-		error = DB_SUCCESS;
+		return(false);
 	}
 
-	/* Note time this run completed. */
-	slot->last_run = ut_time();
+	msg = fts_optimize_create_msg(FTS_MSG_OPTIMIZE_TABLE, slot->table);
 
-	return(error);
+	slot->busy = true;
+
+	ib_wqueue_add(fts_optimize_worker_wq, msg, msg->heap);
+
+	return(true);
 }
 /*********************************************************************//**
 Run OPTIMIZE on the given table.
@@ -2665,7 +2753,8 @@ fts_optimize_find_slot(
 
 		slot = static_cast<fts_slot_t*>(ib_vector_get(tables, i));
 
-		if (slot->table->id == table->id) {
+		if (slot->state != FTS_STATE_EMPTY
+		    && slot->table->id == table->id) {
 			return(slot);
 		}
 	}
@@ -2746,7 +2835,10 @@ fts_optimize_new_table(
 }
 
 /**********************************************************************//**
-Remove the table from the vector if it exists. */
+Remove the table from the vector if it exists. If a worker thread is
+optimizing the table, the removal is completed in
+fts_optimize_table_done() and the producer is signalled from there.
+@return TRUE if the slot was emptied */
 static
 ibool
 fts_optimize_del_table(
@@ -2766,6 +2858,13 @@ fts_optimize_del_table(
 		if (slot->state != FTS_STATE_EMPTY
 		    && slot->table->id == table->id) {
 
+			if (slot->busy) {
+				ut_a(slot->remove_event == NULL);
+				slot->remove_event = msg->event;
+
+				return(FALSE);
+			}
+
 			ut_print_timestamp(stderr);
 			fprintf(stderr, " InnoDB: FTS Optimize Removing "
 				"table %s\n", table->name);
@@ -2773,13 +2872,56 @@ fts_optimize_del_table(
 			slot->table = NULL;
 			slot->state = FTS_STATE_EMPTY;
 
+			os_event_set(msg->event);
+
 			return(TRUE);
 		}
 	}
 
+	os_event_set(msg->event);
+
 	return(FALSE);
 }
 
+/**********************************************************************//**
+Process the report of a worker thread that finished optimizing a table.
+@return TRUE if the table was removed while it was being optimized and
+its slot was emptied */
+static
+ibool
+fts_optimize_table_done(
+/*====================*/
+	ib_vector_t*		tables,		/*!< in/out: vector of tables */
+	const fts_msg_done_t*	done)		/*!< in: optimized table */
+{
+	fts_slot_t*	slot;
+
+	slot = fts_optimize_find_slot(tables, done->table);
+
+	ut_a(slot != NULL);
+	ut_a(slot->busy);
+
+	slot->busy = false;
+
+	fts_optimize_slot_done(slot, done->error);
+
+	if (slot->remove_event == NULL) {
+		return(FALSE);
+	}
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr, " InnoDB: FTS Optimize Removing table %s\n",
+		slot->table->name);
+
+	os_event_set(slot->remove_event);
+
+	slot->remove_event = NULL;
+	slot->table = NULL;
+	slot->state = FTS_STATE_EMPTY;
+
+	return(TRUE);
+}
+
 /**********************************************************************//**
 Calculate how many of the registered tables need to be optimized.
 @return no. of tables to optimize */
@@ -2803,6 +2945,11 @@ fts_optimize_how_many(
 		slot = static_cast<const fts_slot_t*>(
 			ib_vector_get_const(tables, i));
 
+		/* A worker thread is already optimizing the table. */
+		if (slot->busy) {
+			continue;
+		}
+
 		switch (slot->state) {
 		case FTS_STATE_DONE:
 		case FTS_STATE_LOADED:
@@ -2926,6 +3073,121 @@ fts_optimize_need_sync(
 }
 #endif
 
+/**********************************************************************//**
+Optimize the tables handed over by the FTS optimize thread. Several
+of these threads can optimize different tables in parallel.
+@return Dummy return */
+static
+os_thread_ret_t
+fts_optimize_worker_thread(
+/*=======================*/
+	void*		arg)			/*!< in: work queue */
+{
+	ib_wqueue_t*	wq = static_cast<ib_wqueue_t*>(arg);
+	os_event_t	exit_event = NULL;
+
+	ut_ad(!srv_read_only_mode);
+
+	while (exit_event == NULL) {
+		fts_msg_t*	msg;
+		fts_msg_done_t*	done;
+
+		msg = static_cast<fts_msg_t*>(ib_wqueue_wait(wq));
+
+		switch (msg->type) {
+		case FTS_MSG_STOP:
+			exit_event = static_cast<os_event_t>(msg->ptr);
+			break;
+
+		case FTS_MSG_OPTIMIZE_TABLE:
+			/* The message heap is freed by the consumer,
+			the FTS optimize thread. */
+			msg->type = FTS_MSG_TABLE_DONE;
+
+			done = static_cast<fts_msg_done_t*>(
+				mem_heap_alloc(msg->heap, sizeof(*done)));
+
+			done->table = static_cast<dict_table_t*>(msg->ptr);
+			done->error = fts_optimize_table(done->table);
+
+			msg->ptr = done;
+
+			ib_wqueue_add(fts_optimize_wq, msg, msg->heap);
+			continue;
+
+		default:
+			ut_error;
+		}
+
+		mem_heap_free(msg->heap);
+	}
+
+	os_event_set(exit_event);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/**********************************************************************//**
+Wait for the FTS optimize worker threads to finish the tables that they
+are optimizing, and make them exit. Called by the FTS optimize thread
+at shutdown. */
+static
+void
+fts_optimize_stop_workers(
+/*======================*/
+	ib_wqueue_t*	wq,		/*!< in: FTS optimize thread's
+					work queue */
+	ib_vector_t*	tables,		/*!< in/out: vector of tables */
+	ulint		n_busy)		/*!< in: number of tables being
+					optimized by the worker threads */
+{
+	while (n_busy > 0) {
+		fts_msg_t*	msg;
+
+		msg = static_cast<fts_msg_t*>(ib_wqueue_wait(wq));
+
+		switch (msg->type) {
+		case FTS_MSG_TABLE_DONE:
+			--n_busy;
+
+			fts_optimize_table_done(
+				tables,
+				static_cast<fts_msg_done_t*>(msg->ptr));
+			break;
+
+		case FTS_MSG_DEL_TABLE:
+			fts_optimize_del_table(
+				tables, static_cast<fts_msg_del_t*>(msg->ptr));
+			break;
+
+		default:
+			/* Other requests are moot at shutdown. */
+			break;
+		}
+
+		mem_heap_free(msg->heap);
+	}
+
+	for (ulint i = 0; i < fts_optimize_threads; ++i) {
+		os_event_t	event = os_event_create();
+		fts_msg_t*	msg;
+
+		msg = fts_optimize_create_msg(FTS_MSG_STOP, event);
+
+		ib_wqueue_add(fts_optimize_worker_wq, msg, msg->heap);
+
+		os_event_wait(event);
+		os_event_free(event);
+	}
+
+	ib_wqueue_free(fts_optimize_worker_wq);
+	fts_optimize_worker_wq = NULL;
+}
+
 /**********************************************************************//**
 Optimize all FTS tables.
 @return Dummy return */
@@ -2943,7 +3205,11 @@ fts_optimize_thread(
 	ulint		n_tables = 0;
 	os_event_t	exit_event = 0;
 	ulint		n_optimize = 0;
+	ulint		n_busy = 0;
 	ib_wqueue_t*	wq = (ib_wqueue_t*) arg;
+	/* Number of tables that may be optimized concurrently */
+	const ulint	max_busy = fts_optimize_worker_wq
+		? fts_optimize_threads : 1;
 
 	ut_ad(!srv_read_only_mode);
 
@@ -2960,7 +3226,8 @@ fts_optimize_thread(
 		if (!done
 		    && ib_wqueue_is_empty(wq)
 		    && n_tables > 0
-		    && n_optimize > 0) {
+		    && n_optimize > 0
+		    && n_busy < max_busy) {
 
 			fts_slot_t*	slot;
 
@@ -2970,7 +3237,16 @@ fts_optimize_thread(
 				ib_vector_get(tables, current));
 
 			/* Handle the case of empty slots. */
-			if (slot->state != FTS_STATE_EMPTY) {
+			if (slot->state == FTS_STATE_EMPTY || slot->busy) {
+				/* Skip the slot. */
+			} else if (fts_optimize_worker_wq) {
+
+				slot->state = FTS_STATE_RUNNING;
+
+				if (fts_optimize_table_dispatch(slot)) {
+					++n_busy;
+				}
+			} else {
 
 				slot->state = FTS_STATE_RUNNING;
 
@@ -2986,7 +3262,7 @@ fts_optimize_thread(
 				current = 0;
 			}
 
-		} else if (n_optimize == 0 || !ib_wqueue_is_empty(wq)) {
+		} else {
 			fts_msg_t*	msg;
 
 			msg = static_cast<fts_msg_t*>(
@@ -3034,16 +3310,24 @@ fts_optimize_thread(
 				break;
 
 			case FTS_MSG_DEL_TABLE:
+				/* This signals the producer once the
+				table has been removed. */
 				if (fts_optimize_del_table(
 					tables, static_cast<fts_msg_del_t*>(
 						msg->ptr))) {
 					--n_tables;
 				}
+				break;
+
+			case FTS_MSG_TABLE_DONE:
+				ut_a(n_busy > 0);
+				--n_busy;
 
-				/* Signal the producer that we have
-				removed the table. */
-				os_event_set(
-					((fts_msg_del_t*) msg->ptr)->event);
+				if (fts_optimize_table_done(
+					tables, static_cast<fts_msg_done_t*>(
+						msg->ptr))) {
+					--n_tables;
+				}
 				break;
 
 			default:
@@ -3060,6 +3344,12 @@ fts_optimize_thread(
 		}
 	}
 
+	/* Wait for the worker threads to finish the tables that they
+	are optimizing, and then stop them. */
+	if (fts_optimize_worker_wq) {
+		fts_optimize_stop_workers(wq, tables, n_busy);
+	}
+
 	/* Server is being shutdown, sync the data from FTS cache to disk
 	if needed */
 	if (n_tables > 0) {
@@ -3123,6 +3413,16 @@ fts_optimize_init(void)
 	ut_a(fts_optimize_wq != NULL);
 	last_check_sync_time = ut_time();
 
+	if (fts_optimize_threads > 1) {
+		fts_optimize_worker_wq = ib_wqueue_create();
+		ut_a(fts_optimize_worker_wq != NULL);
+
+		for (ulint i = 0; i < fts_optimize_threads; ++i) {
+			os_thread_create(fts_optimize_worker_thread,
+					 fts_optimize_worker_wq, NULL);
+		}
+	}
+
 	os_thread_create(fts_optimize_thread, fts_optimize_wq, NULL);
 }
 
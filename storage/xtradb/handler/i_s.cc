@@ -8233,7 +8233,7 @@ i_s_innodb_changed_pages_fill(
 		DBUG_RETURN(1);
 	}
 
-	while(log_online_bitmap_iterator_next(&i) &&
+	while(log_online_bitmap_iterator_next_changed(&i) &&
 	      (!srv_max_changed_pages ||
 	       output_rows_num < srv_max_changed_pages) &&
 	      /*
@@ -8259,9 +8259,6 @@ i_s_innodb_changed_pages_fill(
 	      */
 	      LOG_BITMAP_ITERATOR_START_LSN(i) <= max_lsn)
 	{
-		if (!LOG_BITMAP_ITERATOR_PAGE_CHANGED(i))
-			continue;
-
 		/* SPACE_ID */
 		table->field[0]->store(
 				       LOG_BITMAP_ITERATOR_SPACE_ID(i));
@@ -48,6 +48,21 @@ struct fil_space_t;
 
 typedef std::list<const char*> space_name_list_t;
 
+/** I/O statistics of a tablespace, see fil_get_space_io_stats() */
+struct fil_space_io_stats_t {
+	ulint		id;		/*!< space id */
+	char*		name;		/*!< space name, must be freed by the
+					caller using delete[] */
+	ib_uint64_t	n_reads;	/*!< number of read requests posted
+					since the space was loaded */
+	ib_uint64_t	n_writes;	/*!< number of write requests posted
+					since the space was loaded */
+	ulint		n_pending;	/*!< number of i/o requests pending
+					on the files of the space */
+};
+
+typedef std::list<fil_space_io_stats_t> space_io_stats_list_t;
+
 /** When mysqld is run, the default directory "." is the mysqld datadir,
 but in the MySQL Embedded Server Library and ibbackup it is not the default
 directory, and we must set the base file path explicitly */
@@ -962,6 +977,19 @@ fil_get_space_id_for_table(
 	const char*	name);	/*!< in: table name in the standard
 				'databasename/tablename' format */
 
+/**
+Iterate over all the spaces in the space list and fetch their i/o
+statistics. The space names in the list must be freed by the caller using
+delete[].
+@return DB_SUCCESS if all OK. */
+UNIV_INTERN
+dberr_t
+fil_get_space_io_stats(
+/*===================*/
+	space_io_stats_list_t&	space_io_stats_list)
+				/*!< in/out: List to append to */
+	__attribute__((warn_unused_result));
+
 /**
 Iterate over all the spaces in the space list and fetch the
 tablespace names. It will return a copy of the name that must be
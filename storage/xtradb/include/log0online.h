@@ -134,6 +134,17 @@ log_online_bitmap_iterator_next(
 /*============================*/
 	log_bitmap_iterator_t *i); /*!<in/out: iterator */
 
+/*********************************************************************//**
+Iterates through the set bits of saved bitmap blocks, skipping the bitmap
+bytes that have no pages changed.  Otherwise the same as
+log_online_bitmap_iterator_next().
+@return TRUE if iteration is successful, FALSE if all bits are iterated. */
+UNIV_INTERN
+ibool
+log_online_bitmap_iterator_next_changed(
+/*====================================*/
+	log_bitmap_iterator_t *i); /*!<in/out: iterator */
+
 /** Struct for single bitmap file information */
 struct log_online_bitmap_file_struct {
 	char		name[FN_REFLEN];	/*!< Name with full path */
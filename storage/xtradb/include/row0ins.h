@@ -32,6 +32,7 @@ Created 4/20/1996 Heikki Tuuri
 #include "dict0types.h"
 #include "trx0types.h"
 #include "row0types.h"
+#include "buf0types.h"
 
 /***************************************************************//**
 Checks if foreign key constraint fails for an index entry. Sets shared locks
@@ -97,8 +98,11 @@ row_ins_clust_index_entry_low(
 	ulint		n_uniq,	/*!< in: 0 or index->n_uniq */
 	dtuple_t*	entry,	/*!< in/out: index entry to insert */
 	ulint		n_ext,	/*!< in: number of externally stored columns */
-	que_thr_t*	thr)	/*!< in: query thread or NULL */
-	__attribute__((nonnull, warn_unused_result));
+	que_thr_t*	thr,	/*!< in: query thread or NULL */
+	ins_append_hint_t*
+			hint)	/*!< in/out: position of the previous
+				append to index by the insert node, or NULL */
+	__attribute__((nonnull(3,5), warn_unused_result));
 /***************************************************************//**
 Tries to insert an entry into a secondary index. If a record with exactly the
 same fields is found, the other record is necessarily marked deleted.
@@ -163,8 +167,11 @@ row_ins_clust_index_entry(
 	dict_index_t*	index,	/*!< in: clustered index */
 	dtuple_t*	entry,	/*!< in/out: index entry to insert */
 	que_thr_t*	thr,	/*!< in: query thread */
-	ulint		n_ext)	/*!< in: number of externally stored columns */
-	__attribute__((nonnull, warn_unused_result));
+	ulint		n_ext,	/*!< in: number of externally stored columns */
+	ins_append_hint_t*
+			hint)	/*!< in/out: position of the previous
+				append to index by the insert node, or NULL */
+	__attribute__((nonnull(1,2,3), warn_unused_result));
 /***************************************************************//**
 Inserts an entry into a secondary index. Tries first optimistic,
 then pessimistic descent down the tree. If the entry matches enough
@@ -189,6 +196,19 @@ row_ins_step(
 /*=========*/
 	que_thr_t*	thr);	/*!< in: query thread */
 
+/** Position of the record that an insert node most recently appended
+to the right edge of the clustered index. When rows arrive in ascending
+order of the clustered index key (LOAD DATA or INSERT...SELECT into an
+empty table), the next row can be appended to the same leaf page
+without a B-tree descent. */
+struct ins_append_hint_t{
+	buf_block_t*	block;	/*!< rightmost leaf page, or NULL */
+	ulint		space;	/*!< tablespace id of block */
+	ulint		page_no;/*!< page number of block */
+	ib_uint64_t	modify_clock;
+				/*!< block->modify_clock at the append */
+};
+
 /* Insert node structure */
 
 struct ins_node_t{
@@ -216,6 +236,10 @@ struct ins_node_t{
 				entry_list and sys fields are stored here;
 				if this is NULL, entry list should be created
 				and buffers for sys fields in row allocated */
+	ins_append_hint_t
+			append_hint;
+				/*!< where the previous row was appended
+				to the clustered index */
 	ulint		magic_n;
 };
 
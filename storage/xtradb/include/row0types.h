@@ -33,6 +33,7 @@ struct upd_field_t;
 struct upd_node_t;
 struct del_node_t;
 struct ins_node_t;
+struct ins_append_hint_t;
 struct sel_node_t;
 struct open_node_t;
 struct fetch_node_t;
@@ -76,6 +76,16 @@ struct log_bitmap_struct {
 					both the correct type and the tree does
 					not mind its overwrite during
 					rbt_next() tree traversal. */
+	byte*		last_page;	/*!< the modified_pages tree value
+					that was looked up last, or NULL.
+					Consecutive redo records tend to touch
+					the same 4KB block, which lets
+					log_online_set_page_bit() skip the
+					tree search. */
+	byte*		write_buf_ptr;	/*!< Unaligned bitmap write buffer */
+	byte*		write_buf;	/*!< bitmap write buffer, used to write
+					up to MODIFIED_PAGE_WRITE_BATCH blocks
+					of a run in a single I/O request */
 	ib_mutex_t	mutex;		/*!< mutex protecting all the fields.*/
 };
 
@@ -134,6 +144,9 @@ enum { MODIFIED_PAGE_BLOCK_BITMAP_LEN
 /** Length of the bitmap data in a block in page ids */
 enum { MODIFIED_PAGE_BLOCK_ID_COUNT = MODIFIED_PAGE_BLOCK_BITMAP_LEN * 8 };
 
+/** The maximum number of bitmap blocks written in a single I/O request */
+enum { MODIFIED_PAGE_WRITE_BATCH = 64 };
+
 /****************************************************************//**
 Provide a comparisson function for the RB-tree tree (space,
 block_start_page) pairs.  Actual implementation does not matter as
@@ -191,6 +204,17 @@ log_online_set_page_bit(
 		: (page_no / 8);
 	bit_pos = page_no % 8;
 
+	page_ptr = log_bmp_sys->last_page;
+	if (page_ptr
+	    && mach_read_from_4(page_ptr + MODIFIED_PAGE_SPACE_ID) == space
+	    && mach_read_from_4(page_ptr + MODIFIED_PAGE_1ST_PAGE_ID)
+	    == block_start_page) {
+
+		page_ptr[MODIFIED_PAGE_BLOCK_BITMAP + block_pos]
+			|= (1U << bit_pos);
+		return;
+	}
+
 	mach_write_to_4(search_page + MODIFIED_PAGE_SPACE_ID, space);
 	mach_write_to_4(search_page + MODIFIED_PAGE_1ST_PAGE_ID,
 			block_start_page);
@@ -221,6 +245,7 @@ log_online_set_page_bit(
 		rbt_add_preallocated_node(log_bmp_sys->modified_pages,
 					  &tree_search_pos, new_node);
 	}
+	log_bmp_sys->last_page = page_ptr;
 	page_ptr[MODIFIED_PAGE_BLOCK_BITMAP + block_pos] |= (1U << bit_pos);
 }
 
@@ -629,6 +654,12 @@ log_online_read_init(void)
 		(ut_malloc(FOLLOW_SCAN_SIZE + OS_FILE_LOG_BLOCK_SIZE));
 	log_bmp_sys->read_buf = static_cast<byte *>
 		(ut_align(log_bmp_sys->read_buf_ptr, OS_FILE_LOG_BLOCK_SIZE));
+	log_bmp_sys->write_buf_ptr = static_cast<byte *>
+		(ut_malloc((MODIFIED_PAGE_WRITE_BATCH + 1)
+			   * MODIFIED_PAGE_BLOCK_SIZE));
+	log_bmp_sys->write_buf = static_cast<byte *>
+		(ut_align(log_bmp_sys->write_buf_ptr,
+			  MODIFIED_PAGE_BLOCK_SIZE));
 
 	mutex_create(log_bmp_sys_mutex_key, &log_bmp_sys->mutex,
 		     SYNC_LOG_ONLINE);
@@ -695,6 +726,7 @@ log_online_read_init(void)
 	log_bmp_sys->modified_pages = rbt_create(MODIFIED_PAGE_BLOCK_SIZE,
 						 log_online_compare_bmp_keys);
 	log_bmp_sys->page_free_list = NULL;
+	log_bmp_sys->last_page = NULL;
 
 	log_bmp_sys->out.file
 		= os_file_create_simple_no_error_handling
@@ -797,6 +829,7 @@ log_online_read_shutdown(void)
 	mutex_free(&log_bmp_sys->mutex);
 
 	ut_free(log_bmp_sys->read_buf_ptr);
+	ut_free(log_bmp_sys->write_buf_ptr);
 	ut_free(log_bmp_sys);
 }
 
@@ -1085,26 +1118,31 @@ log_online_follow_log_group(
 }
 
 /*********************************************************************//**
-Write, flush one bitmap block to disk and advance the output position if
-successful.
+Write consecutive bitmap blocks to disk, optionally flush them, and advance the
+output position if successful.
 
-@return TRUE if page written OK, FALSE if I/O error */
+@return TRUE if blocks written OK, FALSE if I/O error */
 static
 ibool
-log_online_write_bitmap_page(
-/*=========================*/
-	const byte *block)	/*!< in: block to write */
+log_online_write_bitmap_pages(
+/*==========================*/
+	const byte*	blocks,		/*!< in: blocks to write */
+	ulint		n_blocks,	/*!< in: number of blocks */
+	ibool		flush)		/*!< in: whether to flush the file
+					after the write */
 {
 	ibool	success;
+	ulint	len	= n_blocks * MODIFIED_PAGE_BLOCK_SIZE;
 
 	ut_ad(mutex_own(&log_bmp_sys->mutex));
+	ut_ad(n_blocks > 0);
+	ut_ad(n_blocks <= MODIFIED_PAGE_WRITE_BATCH);
 
 	/* Simulate a write error */
 	DBUG_EXECUTE_IF("bitmap_page_write_error", return FALSE;);
 
 	success = os_file_write(log_bmp_sys->out.name, log_bmp_sys->out.file,
-				block, log_bmp_sys->out.offset,
-				MODIFIED_PAGE_BLOCK_SIZE);
+				blocks, log_bmp_sys->out.offset, len);
 	if (UNIV_UNLIKELY(!success)) {
 
 		/* The following call prints an error message */
@@ -1114,6 +1152,13 @@ log_online_write_bitmap_page(
 		return FALSE;
 	}
 
+	log_bmp_sys->out.offset += len;
+
+	if (!flush) {
+
+		return TRUE;
+	}
+
 	success = os_file_flush(log_bmp_sys->out.file);
 	if (UNIV_UNLIKELY(!success)) {
 
@@ -1124,12 +1169,6 @@ log_online_write_bitmap_page(
 		return FALSE;
 	}
 
-#ifdef UNIV_LINUX
-	posix_fadvise(log_bmp_sys->out.file, log_bmp_sys->out.offset,
-		      MODIFIED_PAGE_BLOCK_SIZE, POSIX_FADV_DONTNEED);
-#endif
-
-	log_bmp_sys->out.offset += MODIFIED_PAGE_BLOCK_SIZE;
 	return TRUE;
 }
 
@@ -1137,6 +1176,12 @@ log_online_write_bitmap_page(
 Append the current changed page bitmap to the bitmap file.  Clears the
 bitmap tree and recycles its nodes to the free list.
 
+The blocks of a run are written in batches of up to MODIFIED_PAGE_WRITE_BATCH
+blocks without flushing.  The whole run except its last block is then flushed
+before the last block, which carries the last-in-run flag, is written and
+flushed, so that a run is only ever considered complete on restart if all of
+its blocks reached the disk.
+
 @return TRUE if bitmap written OK, FALSE if I/O error*/
 static
 ibool
@@ -1146,6 +1191,8 @@ log_online_write_bitmap(void)
 	ib_rbt_node_t		*bmp_tree_node;
 	const ib_rbt_node_t	*last_bmp_tree_node;
 	ibool			success = TRUE;
+	os_offset_t		run_start_offset;
+	ulint			n_buffered = 0;
 
 	ut_ad(mutex_own(&log_bmp_sys->mutex));
 
@@ -1155,6 +1202,8 @@ log_online_write_bitmap(void)
 		}
 	}
 
+	run_start_offset = log_bmp_sys->out.offset;
+
 	bmp_tree_node = (ib_rbt_node_t *)
 		rbt_first(log_bmp_sys->modified_pages);
 	last_bmp_tree_node = rbt_last(log_bmp_sys->modified_pages);
@@ -1180,7 +1229,29 @@ log_online_write_bitmap(void)
 			mach_write_to_4(page + MODIFIED_PAGE_BLOCK_CHECKSUM,
 					log_online_calc_checksum(page));
 
-			success = log_online_write_bitmap_page(page);
+			if (bmp_tree_node == last_bmp_tree_node) {
+
+				success = (n_buffered == 0
+					   || log_online_write_bitmap_pages(
+						   log_bmp_sys->write_buf,
+						   n_buffered, TRUE))
+					&& log_online_write_bitmap_pages(
+						page, 1, TRUE);
+				n_buffered = 0;
+			} else {
+
+				memcpy(log_bmp_sys->write_buf
+				       + n_buffered * MODIFIED_PAGE_BLOCK_SIZE,
+				       page, MODIFIED_PAGE_BLOCK_SIZE);
+
+				if (++n_buffered == MODIFIED_PAGE_WRITE_BATCH) {
+
+					success = log_online_write_bitmap_pages(
+						log_bmp_sys->write_buf,
+						n_buffered, FALSE);
+					n_buffered = 0;
+				}
+			}
 		}
 
 		bmp_tree_node->left = log_bmp_sys->page_free_list;
@@ -1191,6 +1262,16 @@ log_online_write_bitmap(void)
 	}
 
 	rbt_reset(log_bmp_sys->modified_pages);
+	log_bmp_sys->last_page = NULL;
+
+#ifdef UNIV_LINUX
+	if (success && log_bmp_sys->out.offset > run_start_offset) {
+		posix_fadvise(log_bmp_sys->out.file, run_start_offset,
+			      log_bmp_sys->out.offset - run_start_offset,
+			      POSIX_FADV_DONTNEED);
+	}
+#endif
+
 	return success;
 }
 
@@ -1554,6 +1635,53 @@ log_online_diagnose_bitmap_eof(
 	return TRUE;
 }
 
+/*********************************************************************//**
+Position a bitmap file opened for reading at the first block of the run that
+may contain changes at or after the given LSN.  The runs are appended to the
+file in LSN order and all the blocks of a run share its end LSN, thus the
+blocks are sorted by their end LSN and can be binary searched.  On any read
+error or checksum mismatch the file is left positioned at its start so that
+the sequential read handles it as before. */
+static
+void
+log_online_seek_bitmap_file(
+/*========================*/
+	log_online_bitmap_file_t*	bitmap_file,	/*!<in/out: bitmap
+							file */
+	byte*				page,		/*!<in: buffer of
+							MODIFIED_PAGE_BLOCK_SIZE
+							bytes */
+	lsn_t				min_lsn)	/*!<in: start LSN */
+{
+	ulint	low	= 0;
+	ulint	high	= (ulint) (bitmap_file->size / MODIFIED_PAGE_BLOCK_SIZE);
+
+	while (low < high) {
+
+		ulint	mid = low + (high - low) / 2;
+		ibool	checksum_ok;
+
+		bitmap_file->offset = (os_offset_t) mid
+			* MODIFIED_PAGE_BLOCK_SIZE;
+
+		if (!log_online_read_bitmap_page(bitmap_file, page,
+						 &checksum_ok)
+		    || !checksum_ok) {
+
+			bitmap_file->offset = 0;
+			return;
+		}
+
+		if (mach_read_from_8(page + MODIFIED_PAGE_END_LSN) < min_lsn) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	bitmap_file->offset = (os_offset_t) low * MODIFIED_PAGE_BLOCK_SIZE;
+}
+
 /*********************************************************************//**
 Initialize the log bitmap iterator for a given range.  The records are
 processed at a bitmap block granularity, i.e. all the records in the same block
@@ -1563,7 +1691,7 @@ the LSN interval contained in the block).  Thus min_lsn and max_lsn should be
 set at block boundaries or bigger, otherwise the records at the 1st and the
 last blocks will not be returned.  Also note that there might be returned
 records with LSN < min_lsn, as min_lsn is used to select the correct starting
-file but not block.
+file and the first run in it that ends at or after min_lsn, but not block.
 
 @return TRUE if the iterator is initialized OK, FALSE otherwise. */
 UNIV_INTERN
@@ -1606,7 +1734,13 @@ log_online_bitmap_iterator_init(
 	}
 
 	i->page = static_cast<byte *>(ut_malloc(MODIFIED_PAGE_BLOCK_SIZE));
-	i->bit_offset = MODIFIED_PAGE_BLOCK_BITMAP_LEN;
+
+	if (min_lsn > 0) {
+
+		log_online_seek_bitmap_file(&i->in, i->page, min_lsn);
+	}
+
+	i->bit_offset = MODIFIED_PAGE_BLOCK_ID_COUNT;
 	i->start_lsn = i->end_lsn = 0;
 	i->space_id = 0;
 	i->first_page_id = 0;
@@ -1664,7 +1798,7 @@ log_online_bitmap_iterator_next(
 		return FALSE;
 	}
 
-	if (UNIV_LIKELY(i->bit_offset < MODIFIED_PAGE_BLOCK_BITMAP_LEN))
+	if (UNIV_LIKELY(i->bit_offset + 1 < MODIFIED_PAGE_BLOCK_ID_COUNT))
 	{
 		++i->bit_offset;
 		i->changed =
@@ -1748,6 +1882,41 @@ log_online_bitmap_iterator_next(
 	return TRUE;
 }
 
+/*********************************************************************//**
+Iterates through the set bits of saved bitmap blocks, skipping the bitmap
+bytes that have no pages changed.  Otherwise the same as
+log_online_bitmap_iterator_next().
+@return TRUE if iteration is successful, FALSE if all bits are iterated. */
+UNIV_INTERN
+ibool
+log_online_bitmap_iterator_next_changed(
+/*====================================*/
+	log_bitmap_iterator_t *i) /*!<in/out: iterator */
+{
+	while (log_online_bitmap_iterator_next(i)) {
+
+		const byte*	bitmap;
+
+		if (i->changed) {
+
+			return TRUE;
+		}
+
+		bitmap = i->page + MODIFIED_PAGE_BLOCK_BITMAP;
+
+		/* Advance to the last bit of each following zero byte, so that
+		the next call continues from the first bit after it. */
+		while ((i->bit_offset + 1) % 8 == 0
+		       && i->bit_offset + 1 < MODIFIED_PAGE_BLOCK_ID_COUNT
+		       && bitmap[(i->bit_offset + 1) >> 3] == 0) {
+
+			i->bit_offset += 8;
+		}
+	}
+
+	return FALSE;
+}
+
 /************************************************************//**
 Delete all the bitmap files for data less than the specified LSN.
 If called with lsn == 0 (i.e. set by RESET request) or LSN_MAX,
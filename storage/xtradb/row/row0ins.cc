@@ -94,6 +94,8 @@ ins_node_create(
 
 	node->entry_sys_heap = mem_heap_create(128);
 
+	node->append_hint.block = NULL;
+
 	node->magic_n = INS_NODE_MAGIC_N;
 
 	return(node);
@@ -2304,6 +2306,132 @@ row_ins_must_modify_rec(
 	       && !page_rec_is_infimum(btr_cur_get_rec(cursor)));
 }
 
+/***************************************************************//**
+Positions a cursor for appending an entry to the right edge of a
+clustered index, on the leaf page where the insert node appended the
+previous row. This saves the B-tree descent when rows are inserted in
+ascending order of the clustered index key. If the page is no longer
+the rightmost leaf, or the entry does not sort after its last record,
+the mini-transaction is restarted and the caller must search the tree.
+@return true if the cursor was positioned, with the page x-latched */
+static __attribute__((nonnull, warn_unused_result))
+bool
+row_ins_clust_index_append_position(
+/*================================*/
+	ins_append_hint_t*	hint,	/*!< in/out: previous append */
+	dict_index_t*		index,	/*!< in: clustered index */
+	const dtuple_t*		entry,	/*!< in: index entry to insert */
+	btr_cur_t*		cursor,	/*!< out: cursor on the last user
+					record of the rightmost leaf page */
+	mtr_t*			mtr)	/*!< in/out: mini-transaction */
+{
+	buf_block_t*	block		= hint->block;
+	const page_t*	page;
+	const rec_t*	rec;
+	ulint		matched_fields	= 0;
+	ulint		matched_bytes	= 0;
+	int		cmp;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+	rec_offs_init(offsets_);
+
+	ut_ad(dict_index_is_clust(index));
+
+	if (block == NULL) {
+		return(false);
+	}
+
+	if (!buf_page_optimistic_get(RW_X_LATCH, block, hint->modify_clock,
+				     __FILE__, __LINE__, mtr)) {
+		hint->block = NULL;
+		return(false);
+	}
+
+	buf_block_dbg_add_level(block, SYNC_TREE_NODE);
+
+	page = buf_block_get_frame(block);
+
+	if (buf_block_get_space(block) != hint->space
+	    || buf_block_get_page_no(block) != hint->page_no
+	    || btr_page_get_index_id(page) != index->id
+	    || !page_is_leaf(page)
+	    || btr_page_get_next(page, mtr) != FIL_NULL) {
+		goto not_found;
+	}
+
+	rec = page_rec_get_prev_const(page_get_supremum_rec(page));
+
+	if (page_rec_is_infimum(rec)) {
+		goto not_found;
+	}
+
+	offsets = rec_get_offsets(rec, index, offsets, ULINT_UNDEFINED, &heap);
+
+	cmp = cmp_dtuple_rec_with_match(entry, rec, offsets,
+					&matched_fields, &matched_bytes);
+
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
+
+	if (cmp <= 0) {
+		goto not_found;
+	}
+
+	btr_cur_position(index, const_cast<rec_t*>(rec), block, cursor);
+
+	/* Mimic a PAGE_CUR_LE search that ended between the last user
+	record and the page supremum. */
+	cursor->flag = BTR_CUR_BINARY;
+	cursor->low_match = matched_fields;
+	cursor->low_bytes = matched_bytes;
+	cursor->up_match = 0;
+	cursor->up_bytes = 0;
+
+	return(true);
+
+not_found:
+	/* Release the page latch before the caller latches index->lock
+	for the tree search. */
+	hint->block = NULL;
+	mtr_commit(mtr);
+	mtr_start(mtr);
+
+	return(false);
+}
+
+/***************************************************************//**
+Remembers the page of a clustered index record if the record was
+appended to the right edge of the index, so that the next insert by the
+same insert node can use row_ins_clust_index_append_position(). */
+static __attribute__((nonnull))
+void
+row_ins_clust_index_append_remember(
+/*================================*/
+	ins_append_hint_t*	hint,	/*!< out: position of the append */
+	const btr_cur_t*	cursor,	/*!< in: cursor on the record */
+	const rec_t*		rec,	/*!< in: inserted record */
+	mtr_t*			mtr)	/*!< in: mini-transaction */
+{
+	buf_block_t*	block	= btr_cur_get_block(cursor);
+	const page_t*	page	= buf_block_get_frame(block);
+
+	ut_ad(mtr_memo_contains(mtr, block, MTR_MEMO_PAGE_X_FIX));
+
+	if (page_align(rec) != page
+	    || !page_rec_is_supremum(page_rec_get_next_const(rec))
+	    || btr_page_get_next(page, mtr) != FIL_NULL) {
+		hint->block = NULL;
+		return;
+	}
+
+	hint->block = block;
+	hint->space = buf_block_get_space(block);
+	hint->page_no = buf_block_get_page_no(block);
+	hint->modify_clock = buf_block_get_modify_clock(block);
+}
+
 /***************************************************************//**
 Tries to insert an entry into a clustered index, ignoring foreign key
 constraints. If a record with the same unique key is found, the other
@@ -2327,7 +2455,10 @@ row_ins_clust_index_entry_low(
 	ulint		n_uniq,	/*!< in: 0 or index->n_uniq */
 	dtuple_t*	entry,	/*!< in/out: index entry to insert */
 	ulint		n_ext,	/*!< in: number of externally stored columns */
-	que_thr_t*	thr)	/*!< in: query thread */
+	que_thr_t*	thr,	/*!< in: query thread */
+	ins_append_hint_t*
+			hint)	/*!< in/out: position of the previous
+				append to index by the insert node, or NULL */
 {
 	btr_cur_t	cursor;
 	ulint*		offsets		= NULL;
@@ -2357,12 +2488,20 @@ row_ins_clust_index_entry_low(
 
 	cursor.thr = thr;
 
-	/* Note that we use PAGE_CUR_LE as the search mode, because then
-	the function will return in both low_match and up_match of the
-	cursor sensible values */
+	if (hint && mode == BTR_MODIFY_LEAF
+	    && row_ins_clust_index_append_position(
+		    hint, index, entry, &cursor, &mtr)) {
+		/* The entry will be appended after the last
+		record of the rightmost leaf page. */
+	} else {
+		/* Note that we use PAGE_CUR_LE as the search mode,
+		because then the function will return in both
+		low_match and up_match of the cursor sensible values */
 
-	btr_cur_search_to_nth_level(index, 0, entry, PAGE_CUR_LE, mode,
-				    &cursor, 0, __FILE__, __LINE__, &mtr);
+		btr_cur_search_to_nth_level(index, 0, entry, PAGE_CUR_LE,
+					    mode, &cursor, 0,
+					    __FILE__, __LINE__, &mtr);
+	}
 
 #ifdef UNIV_DEBUG
 	{
@@ -2552,6 +2691,12 @@ err_exit:
 					insert_rec, index, offsets);
 			}
 
+			if (hint && err == DB_SUCCESS
+			    && !thr_get_trx(thr)->fake_changes) {
+				row_ins_clust_index_append_remember(
+					hint, &cursor, insert_rec, &mtr);
+			}
+
 			mtr_commit(&mtr);
 		}
 	}
@@ -2881,7 +3026,10 @@ row_ins_clust_index_entry(
 	dict_index_t*	index,	/*!< in: clustered index */
 	dtuple_t*	entry,	/*!< in/out: index entry to insert */
 	que_thr_t*	thr,	/*!< in: query thread */
-	ulint		n_ext)	/*!< in: number of externally stored columns */
+	ulint		n_ext,	/*!< in: number of externally stored columns */
+	ins_append_hint_t*
+			hint)	/*!< in/out: position of the previous
+				append to index by the insert node, or NULL */
 {
 	dberr_t	err;
 	ulint	n_uniq;
@@ -2902,7 +3050,7 @@ row_ins_clust_index_entry(
 	log_free_check();
 
 	err = row_ins_clust_index_entry_low(
-		0, BTR_MODIFY_LEAF, index, n_uniq, entry, n_ext, thr);
+		0, BTR_MODIFY_LEAF, index, n_uniq, entry, n_ext, thr, hint);
 
 #ifdef UNIV_DEBUG
 	/* Work around Bug#14626800 ASSERTION FAILURE IN DEBUG_SYNC().
@@ -2923,7 +3071,8 @@ row_ins_clust_index_entry(
 	log_free_check();
 
 	return(row_ins_clust_index_entry_low(
-		       0, BTR_MODIFY_TREE, index, n_uniq, entry, n_ext, thr));
+		       0, BTR_MODIFY_TREE, index, n_uniq, entry, n_ext, thr,
+		       hint));
 }
 
 /***************************************************************//**
@@ -2993,10 +3142,13 @@ row_ins_index_entry(
 /*================*/
 	dict_index_t*	index,	/*!< in: index */
 	dtuple_t*	entry,	/*!< in/out: index entry to insert */
-	que_thr_t*	thr)	/*!< in: query thread */
+	que_thr_t*	thr,	/*!< in: query thread */
+	ins_append_hint_t*
+			hint)	/*!< in/out: position of the previous
+				append to the clustered index */
 {
 	if (dict_index_is_clust(index)) {
-		return(row_ins_clust_index_entry(index, entry, thr, 0));
+		return(row_ins_clust_index_entry(index, entry, thr, 0, hint));
 	} else {
 		return(row_ins_sec_index_entry(index, entry, thr));
 	}
@@ -3073,7 +3225,8 @@ row_ins_index_entry_step(
 
 	ut_ad(dtuple_check_typed(node->entry));
 
-	err = row_ins_index_entry(node->index, node->entry, thr);
+	err = row_ins_index_entry(node->index, node->entry, thr,
+				  &node->append_hint);
 
 #ifdef UNIV_DEBUG
 	/* Work around Bug#14626800 ASSERTION FAILURE IN DEBUG_SYNC().
@@ -3301,6 +3454,15 @@ row_ins_step(
 			goto same_trx;
 		}
 
+		/* Within a transaction, keep appending to where the
+		previous execution of this node left off, so that
+		e.g. fts_sync_write_words() can write its sorted words
+		without a tree descent per word. The position must not
+		survive the transaction: DDL, which commits it, may free
+		the page without bumping its modify_clock. */
+
+		node->append_hint.block = NULL;
+
 		err = lock_table(0, node->table, LOCK_IX, thr);
 
 		DBUG_EXECUTE_IF("ib_row_ins_ix_lock_wait",
@@ -19143,6 +19143,284 @@ static void test_mdev4326()
   myquery(rc);
 }
 
+/*
+  Pipelined queries: several queries sent before their results are read
+*/
+
+static void test_pipeline()
+{
+  MYSQL *my;
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  char query[100];
+  int i, rc;
+  MYSQL_STMT *stmt;
+  my_bool pipeline= 1;
+  uint read_timeout= 30;
+
+  myheader("test_pipeline");
+
+  if (!(my= mysql_client_init(NULL)))
+    DIE("mysql_client_init() failed");
+  mysql_options(my, MYSQL_OPT_PIPELINE, &pipeline);
+  /* Fail rather than hang if the server keeps a result */
+  mysql_options(my, MYSQL_OPT_READ_TIMEOUT, &read_timeout);
+  if (!mysql_real_connect(my, opt_host, opt_user, opt_password, current_db,
+                          opt_port, opt_unix_socket,
+                          CLIENT_MULTI_STATEMENTS))
+    DIE("mysql_real_connect failed");
+
+  rc= mysql_query(my, "DROP TABLE IF EXISTS t_pipeline");
+  myquery(rc);
+  rc= mysql_query(my, "CREATE TABLE t_pipeline (a INT PRIMARY KEY, b CHAR(10))");
+  myquery(rc);
+
+  /* Inserts, with a failing one in the middle that doesn't stop the rest */
+  for (i= 1; i <= 100; i++)
+  {
+    if (i == 50)
+      strmov(query, "INSERT INTO t_pipeline_missing VALUES (50, 'x')");
+    else
+      sprintf(query, "INSERT INTO t_pipeline VALUES (%d, 'row%d')", i, i);
+    rc= mysql_pipeline_send_query(my, query, strlen(query));
+    myquery(rc);
+  }
+  strmov(query, "SELECT COUNT(*), SUM(a) FROM t_pipeline");
+  rc= mysql_pipeline_send_query(my, query, strlen(query));
+  myquery(rc);
+  /* A query with several results */
+  strmov(query, "SELECT 1; SELECT 2; SELECT a FROM t_pipeline WHERE a = 3");
+  rc= mysql_pipeline_send_query(my, query, strlen(query));
+  myquery(rc);
+
+  for (i= 1; i <= 100; i++)
+  {
+    rc= mysql_pipeline_read_result(my);
+    if (i == 50)
+    {
+      DIE_UNLESS(rc && mysql_errno(my) == 1146);
+      continue;
+    }
+    myquery(rc);
+    DIE_UNLESS(mysql_affected_rows(my) == 1);
+  }
+
+  rc= mysql_pipeline_read_result(my);
+  myquery(rc);
+  res= mysql_store_result(my);
+  mytest(res);
+  row= mysql_fetch_row(res);
+  DIE_UNLESS(strcmp(row[0], "99") == 0 && strcmp(row[1], "5000") == 0);
+  mysql_free_result(res);
+
+  rc= mysql_pipeline_read_result(my);
+  myquery(rc);
+  for (i= 0; ; i++)
+  {
+    res= mysql_store_result(my);
+    mytest(res);
+    row= mysql_fetch_row(res);
+    DIE_UNLESS(strcmp(row[0], i == 0 ? "1" : i == 1 ? "2" : "3") == 0);
+    mysql_free_result(res);
+    if ((rc= mysql_next_result(my)))
+      break;
+  }
+  DIE_UNLESS(i == 2 && rc == -1);
+
+  /* A result set must be read before the next result */
+  strmov(query, "SELECT a FROM t_pipeline WHERE a < 3");
+  rc= mysql_pipeline_send_query(my, query, strlen(query));
+  myquery(rc);
+  rc= mysql_pipeline_send_query(my, query, strlen(query));
+  myquery(rc);
+  rc= mysql_pipeline_read_result(my);
+  myquery(rc);
+  rc= mysql_pipeline_read_result(my);
+  DIE_UNLESS(rc && mysql_errno(my) == CR_COMMANDS_OUT_OF_SYNC);
+  res= mysql_use_result(my);
+  mytest(res);
+  DIE_UNLESS(my_process_result_set(res) == 2);
+  mysql_free_result(res);
+  rc= mysql_pipeline_read_result(my);
+  myquery(rc);
+  res= mysql_store_result(my);
+  mytest(res);
+  DIE_UNLESS(mysql_num_rows(res) == 2);
+  mysql_free_result(res);
+
+  /*
+    COM_STMT_CLOSE has no result: the server must not keep the result of
+    the query before it while it waits for the next command
+  */
+  stmt= mysql_simple_prepare(my, "SELECT 1");
+  check_stmt(stmt);
+  strmov(query, "SELECT SLEEP(0.5)");
+  rc= mysql_pipeline_send_query(my, query, strlen(query));
+  myquery(rc);
+  rc= mysql_stmt_close(stmt);
+  DIE_UNLESS(rc == 0);
+  rc= mysql_pipeline_read_result(my);
+  myquery(rc);
+  res= mysql_store_result(my);
+  mytest(res);
+  DIE_UNLESS(mysql_num_rows(res) == 1);
+  mysql_free_result(res);
+
+  /* The connection can be used as usual afterwards */
+  rc= mysql_query(my, "DROP TABLE t_pipeline");
+  myquery(rc);
+  mysql_close(my);
+}
+
+/*
+  Several parameter sets sent with one mysql_stmt_execute(),
+  see STMT_ATTR_ARRAY_SIZE.
+*/
+
+static void test_bulk_insert()
+{
+  MYSQL_STMT *stmt;
+  MYSQL_BIND my_bind[3];
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  int a[100];
+  char b[100][20];
+  ulong b_length[100];
+  MYSQL_TIME c[100];
+  my_bool c_is_null[100];
+  ulong array_size;
+  int i, rc;
+
+  myheader("test_bulk_insert");
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t_bulk");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t_bulk (a INT PRIMARY KEY, "
+                         "b VARCHAR(20), c DATETIME)");
+  myquery(rc);
+
+  stmt= mysql_simple_prepare(mysql, "INSERT INTO t_bulk VALUES (?, ?, ?)");
+  check_stmt(stmt);
+
+  for (i= 0; i < 100; i++)
+  {
+    /* The set 50 fails with a duplicate key, the others are inserted */
+    a[i]= i == 50 ? 1 : i;
+    b_length[i]= sprintf(b[i], "row%d", i);
+    bzero((char*) &c[i], sizeof(c[i]));
+    c[i].year= 2000 + i;
+    c[i].month= 1;
+    c[i].day= 1;
+    c[i].time_type= MYSQL_TIMESTAMP_DATETIME;
+    c_is_null[i]= i % 2;
+  }
+
+  bzero((char*) my_bind, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void *) a;
+  my_bind[1].buffer_type= MYSQL_TYPE_STRING;
+  my_bind[1].buffer= (void *) b;
+  my_bind[1].buffer_length= sizeof(b[0]);
+  my_bind[1].length= b_length;
+  my_bind[2].buffer_type= MYSQL_TYPE_DATETIME;
+  my_bind[2].buffer= (void *) c;
+  my_bind[2].is_null= c_is_null;
+
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+
+  array_size= 0;
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  DIE_UNLESS(rc);
+  array_size= 100;
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+  array_size= 0;
+  rc= mysql_stmt_attr_get(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  DIE_UNLESS(rc == 0 && array_size == 100);
+
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 99);
+  DIE_UNLESS(mysql_warning_count(mysql) == 2);
+  mysql_stmt_close(stmt);
+
+  /* The error of the failed set and the note with its number */
+  rc= mysql_query(mysql, "SHOW WARNINGS");
+  myquery(rc);
+  res= mysql_store_result(mysql);
+  mytest(res);
+  row= mysql_fetch_row(res);
+  DIE_UNLESS(strcmp(row[0], "Error") == 0 && atoi(row[1]) == ER_DUP_ENTRY);
+  row= mysql_fetch_row(res);
+  DIE_UNLESS(strcmp(row[0], "Note") == 0 &&
+             atoi(row[1]) == ER_STMT_BULK_ROW_FAILED &&
+             strstr(row[2], " 50 "));
+  mysql_free_result(res);
+
+  rc= mysql_query(mysql, "SELECT COUNT(*), SUM(a), COUNT(c), MAX(b), "
+                         "MAX(c) FROM t_bulk");
+  myquery(rc);
+  res= mysql_store_result(mysql);
+  mytest(res);
+  row= mysql_fetch_row(res);
+  DIE_UNLESS(strcmp(row[0], "99") == 0 && strcmp(row[1], "4900") == 0 &&
+             strcmp(row[2], "49") == 0 && strcmp(row[3], "row99") == 0 &&
+             strcmp(row[4], "2098-01-01 00:00:00") == 0);
+  mysql_free_result(res);
+
+  /* An update with fewer sets than bound rows */
+  stmt= mysql_simple_prepare(mysql, "UPDATE t_bulk SET b= ? WHERE a = ?");
+  check_stmt(stmt);
+  bzero((char*) my_bind, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_STRING;
+  my_bind[0].buffer= (void *) b;
+  my_bind[0].buffer_length= sizeof(b[0]);
+  my_bind[0].length= b_length;
+  my_bind[1].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[1].buffer= (void *) a;
+  for (i= 0; i < 3; i++)
+  {
+    a[i]= i * 10;
+    b_length[i]= sprintf(b[i], "updated%d", i);
+  }
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+  array_size= 3;
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_affected_rows(stmt) == 3);
+  DIE_UNLESS(mysql_warning_count(mysql) == 0);
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "SELECT COUNT(*) FROM t_bulk WHERE b LIKE 'updated%'");
+  myquery(rc);
+  res= mysql_store_result(mysql);
+  mytest(res);
+  row= mysql_fetch_row(res);
+  DIE_UNLESS(strcmp(row[0], "3") == 0);
+  mysql_free_result(res);
+
+  /* A statement with a result set can't be executed in bulk */
+  stmt= mysql_simple_prepare(mysql, "SELECT b FROM t_bulk WHERE a = ?");
+  check_stmt(stmt);
+  bzero((char*) my_bind, sizeof(my_bind));
+  my_bind[0].buffer_type= MYSQL_TYPE_LONG;
+  my_bind[0].buffer= (void *) a;
+  rc= mysql_stmt_bind_param(stmt, my_bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*) &array_size);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_execute(stmt);
+  DIE_UNLESS(rc && mysql_stmt_errno(stmt) == ER_UNSUPPORTED_PS);
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "DROP TABLE t_bulk");
+  myquery(rc);
+}
+
 static struct my_tests_st my_tests[]= {
   { "disable_query_logs", disable_query_logs },
   { "test_view_sp_list_fields", test_view_sp_list_fields },
@@ -19410,6 +19688,8 @@ static struct my_tests_st my_tests[]= {
   { "test_bug13001491", test_bug13001491 },
   { "test_mdev4326", test_mdev4326 },
   { "test_ps_sp_out_params", test_ps_sp_out_params },
+  { "test_pipeline", test_pipeline },
+  { "test_bulk_insert", test_bulk_insert },
   { 0, 0 }
 };
 